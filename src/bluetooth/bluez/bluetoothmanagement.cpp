@@ -164,36 +164,39 @@ BluetoothManagement *BluetoothManagement::instance()
 
 void BluetoothManagement::_q_readNotifier()
 {
-    char *dst = buffer.reserve(QPRIVATELINEARBUFFER_BUFFERSIZE);
-    const auto readCount = ::read(fd, dst, QPRIVATELINEARBUFFER_BUFFERSIZE);
-    buffer.chop(QPRIVATELINEARBUFFER_BUFFERSIZE - (readCount < 0 ? 0 : readCount));
+    // every read returns one complete mgmt packet and lands in contiguous buffer space
+    constexpr qint64 readSize = 16384;
+    char *dst = buffer.reserve(readSize);
+    const auto readCount = ::read(fd, dst, readSize);
+    buffer.chop(readSize - (readCount < 0 ? 0 : readCount));
     if (readCount < 0) {
         qCWarning(QT_BT_BLUEZ, "Management Control read error %s", qPrintable(qt_error_string(errno)));
         return;
     }
 
     // do we have at least one complete mgmt header?
-    if (size_t(buffer.size()) < sizeof(MgmtHdr))
-        return;
-
-    QByteArray data = buffer.readAll();
-
-    while (true) {
-        if (size_t(data.size()) < sizeof(MgmtHdr))
-            break;
-
-        const MgmtHdr *hdr = reinterpret_cast<const MgmtHdr*>(data.constData());
-        const auto nextPackageSize = qsizetype(qFromLittleEndian(hdr->length) + sizeof(MgmtHdr));
-        const qsizetype remainingPackageSize = data.size() - nextPackageSize;
+    while (size_t(buffer.size()) >= sizeof(MgmtHdr)) {
+        MgmtHdr header;
+        buffer.peek(reinterpret_cast<char *>(&header), sizeof(MgmtHdr));
+        const auto nextPackageSize = qint64(qFromLittleEndian(header.length) + sizeof(MgmtHdr));
 
-        if (data.size() < nextPackageSize)
+        if (buffer.size() < nextPackageSize)
             break; // not a complete event header -> wait for next notifier
 
-        switch (static_cast<EventCode>(qFromLittleEndian(hdr->cmdCode))) {
+        // packets are parsed in place, only one spanning buffer chunks is copied
+        QByteArray copy;
+        const char *data = buffer.readPointer();
+        if (buffer.nextDataBlockSize() < nextPackageSize) {
+            copy.resize(nextPackageSize);
+            buffer.peek(copy.data(), nextPackageSize);
+            data = copy.constData();
+        }
+
+        switch (static_cast<EventCode>(qFromLittleEndian(header.cmdCode))) {
         case EventCode::DeviceFoundEvent:
         {
             const MgmtEventDeviceFound *event = reinterpret_cast<const MgmtEventDeviceFound*>
-                                                   (data.constData() + sizeof(MgmtHdr));
+                                                   (data + sizeof(MgmtHdr));
 
             if (event->type == BDADDR_LE_RANDOM) {
                 const bdaddr_t address = event->bdaddr;
@@ -210,21 +213,12 @@ void BluetoothManagement::_q_readNotifier()
         }
         default:
             qCDebug(QT_BT_BLUEZ) << "BluetoothManagement: Ignored event:"
-                                 << Qt::hex << (EventCode)qFromLittleEndian(hdr->cmdCode);
+                                 << Qt::hex << (EventCode)qFromLittleEndian(header.cmdCode);
             break;
         }
 
-        if (data.size() > nextPackageSize)
-            data = data.right(remainingPackageSize);
-        else
-            data.clear();
-
-        if (data.isEmpty())
-            break;
+        buffer.skip(nextPackageSize);
     }
-
-    if (!data.isEmpty())
-        buffer.ungetBlock(data.constData(), data.size());
 }
 
 void BluetoothManagement::processRandomAddressFlagInformation(const QBluetoothAddress &address)
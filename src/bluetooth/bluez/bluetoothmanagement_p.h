@@ -21,10 +21,7 @@
 
 #include <QtBluetooth/qbluetoothaddress.h>
 
-#ifndef QPRIVATELINEARBUFFER_BUFFERSIZE
-#define QPRIVATELINEARBUFFER_BUFFERSIZE qsizetype(16384)
-#endif
-#include "../qprivatelinearbuffer_p.h"
+#include <QtCore/private/qringbuffer_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -102,7 +99,7 @@ private:
 
     int fd = -1;
     QSocketNotifier* notifier;
-    QPrivateLinearBuffer buffer;
+    QRingBuffer buffer;
     QHash<QBluetoothAddress, QDateTime> privateFlagAddresses;
     mutable QMutex accessLock;
 };
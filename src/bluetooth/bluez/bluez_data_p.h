@@ -61,6 +61,11 @@ struct bt_security {
 #define BT_SECURITY_MEDIUM  2
 #define BT_SECURITY_HIGH    3
 
+#define BT_SNDMTU           12
+#define BT_RCVMTU           13
+#define BT_MODE             15
+#define BT_MODE_LE_FLOWCTL  0x03
+
 #define BDADDR_LE_PUBLIC    0x01
 #define BDADDR_LE_RANDOM    0x02
 
@@ -318,6 +323,14 @@ namespace QBluezConst {
         OcfLeClearWhiteList = 0x10,
         OcfLeAddToWhiteList = 0x11,
         OcfLeConnectionUpdate = 0x13,
+        OcfLeSetDataLength = 0x22,
+        OcfLeSetPhy = 0x32,
+        OcfLeSetExtAdvParams = 0x36,
+        OcfLeSetExtAdvData = 0x37,
+        OcfLeSetExtScanResponseData = 0x38,
+        OcfLeSetExtAdvEnable = 0x39,
+        OcfLeReadNumberOfSupportedAdvSets = 0x3b,
+        OcfLeRemoveAdvSet = 0x3c,
     };
     Q_ENUM_NS(OpCodeCommandField)
 
@@ -9,6 +9,8 @@
 
 #include <QtCore/qloggingcategory.h>
 
+#include <qtbluetooth_tracepoints_p.h>
+
 #include <cstring>
 #include <errno.h>
 #include <sys/types.h>
@@ -386,6 +388,44 @@ bool HciManager::sendConnectionParameterUpdateRequest(quint16 handle,
     return true;
 }
 
+bool HciManager::sendSetDataLengthCommand(quint16 handle, quint16 txOctets, quint16 txTime)
+{
+    // Spec v5.3, Vol 4, Part E, 7.8.33
+    struct CommandParams {
+        quint16 handle;
+        quint16 txOctets;
+        quint16 txTime;
+    } commandParams;
+    static_assert(sizeof commandParams == 6, "unexpected struct size");
+    commandParams.handle = qToLittleEndian(handle);
+    commandParams.txOctets = qToLittleEndian(txOctets);
+    commandParams.txTime = qToLittleEndian(txTime);
+    const QByteArray data = QByteArray::fromRawData(reinterpret_cast<char *>(&commandParams),
+                                                    sizeof commandParams);
+    return sendCommand(QBluezConst::OgfLinkControl, QBluezConst::OcfLeSetDataLength, data);
+}
+
+bool HciManager::sendSetPhyCommand(quint16 handle, quint8 txPhys, quint8 rxPhys)
+{
+    // Spec v5.3, Vol 4, Part E, 7.8.49
+    struct CommandParams {
+        quint16 handle;
+        quint8 allPhys;
+        quint8 txPhys;
+        quint8 rxPhys;
+        quint16 phyOptions;
+    } __attribute__ ((packed)) commandParams;
+    static_assert(sizeof commandParams == 7, "unexpected struct size");
+    commandParams.handle = qToLittleEndian(handle);
+    commandParams.allPhys = 0; // Preferences are given for both directions
+    commandParams.txPhys = txPhys;
+    commandParams.rxPhys = rxPhys;
+    commandParams.phyOptions = 0;
+    const QByteArray data = QByteArray::fromRawData(reinterpret_cast<char *>(&commandParams),
+                                                    sizeof commandParams);
+    return sendCommand(QBluezConst::OgfLinkControl, QBluezConst::OcfLeSetPhy, data);
+}
+
 /*!
  * Process all incoming HCI events. Function cannot process anything else but events.
  */
@@ -430,6 +470,7 @@ void HciManager::handleHciEventPacket(const quint8 *data, int size)
         return;
     }
 
+    Q_TRACE(HciManager_eventReceived, header->evt, size);
     qCDebug(QT_BT_BLUEZ) << "HCI event triggered, type:" << (HciManager::HciEvent)header->evt
                          << "type code:" << Qt::hex << header->evt;
 
@@ -489,6 +530,7 @@ void HciManager::handleHciAclPacket(const quint8 *data, int size)
         return;
     }
 
+    Q_TRACE(HciManager_aclPacketReceived, aclData->handle, aclData->dataLen);
 //    qCDebug(QT_BT_BLUEZ) << "handle:" << aclData->handle << "PB:" << aclData->pbFlag
 //                         << "BC:" << aclData->bcFlag << "data len:" << aclData->dataLen;
 
@@ -554,6 +596,22 @@ void HciManager::handleLeMetaEvent(const quint8 *data)
         }
         break;
     }
+    case 0x7: { // HCI_LE_Data_Length_Change
+        const quint16 handle = bt_get_le16(data + 1);
+        const quint16 maxTxOctets = bt_get_le16(data + 3);
+        const quint16 maxRxOctets = bt_get_le16(data + 7);
+        emit dataLengthChanged(handle, maxTxOctets, maxRxOctets);
+        break;
+    }
+    case 0xC: { // HCI_LE_PHY_Update_Complete
+        const quint8 status = data[1];
+        const quint16 handle = bt_get_le16(data + 2);
+        if (status == 0)
+            emit phyUpdated(handle, data[4], data[5]);
+        else
+            qCDebug(QT_BT_BLUEZ) << "PHY update failed with status" << (HciManager::HciError)status;
+        break;
+    }
     default:
         break;
     }
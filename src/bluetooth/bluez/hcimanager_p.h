@@ -26,7 +26,7 @@ QT_BEGIN_NAMESPACE
 
 class QLowEnergyConnectionParameters;
 
-class HciManager : public QObject
+class Q_AUTOTEST_EXPORT HciManager : public QObject
 {
     Q_OBJECT
 public:
@@ -160,6 +160,7 @@ public:
     ~HciManager();
 
     bool isValid() const;
+    int hciDeviceId() const { return hciDev; }
     bool monitorEvent(HciManager::HciEvent event);
     bool monitorAclPackets();
     bool sendCommand(QBluezConst::OpCodeGroupField ogf, QBluezConst::OpCodeCommandField ocf, const QByteArray &parameters);
@@ -173,12 +174,16 @@ public:
     bool sendConnectionUpdateCommand(quint16 handle, const QLowEnergyConnectionParameters &params);
     bool sendConnectionParameterUpdateRequest(quint16 handle,
                                               const QLowEnergyConnectionParameters &params);
+    bool sendSetDataLengthCommand(quint16 handle, quint16 txOctets, quint16 txTime);
+    bool sendSetPhyCommand(quint16 handle, quint8 txPhys, quint8 rxPhys);
 
 signals:
     void encryptionChangedEvent(const QBluetoothAddress &address, bool wasSuccess);
     void commandCompleted(quint16 opCode, quint8 status, const QByteArray &data);
     void connectionComplete(quint16 handle);
     void connectionUpdate(quint16 handle, const QLowEnergyConnectionParameters &parameters);
+    void dataLengthChanged(quint16 handle, quint16 maxTxOctets, quint16 maxRxOctets);
+    void phyUpdated(quint16 handle, quint8 txPhy, quint8 rxPhy);
     void signatureResolvingKeyReceived(quint16 connHandle, bool remoteKey, BluezUint128 csrk);
 
 private slots:
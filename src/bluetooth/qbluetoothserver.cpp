@@ -30,6 +30,11 @@ QT_BEGIN_NAMESPACE
     If the \l QBluetoothServiceInfo::Protocol is not supported by a platform, \l listen() will return \c false.
     Android and WinRT only support RFCOMM for example.
 
+    On Linux, a server of type \l {QBluetoothServiceInfo::L2capLeProtocol}{L2capLeProtocol}
+    accepts L2CAP connection-oriented channels over Bluetooth Low Energy. Such channels are not
+    announced via SDP; the peer learns about the PSM returned by serverPort() through other
+    means, usually a GATT characteristic.
+
     On iOS, this class cannot be used because the platform does not expose
     an API which may permit access to QBluetoothServer related features.
 
@@ -89,6 +94,9 @@ QT_BEGIN_NAMESPACE
     to avoid setting a port number to enable the system to automatically choose
     a port.
 
+    For \l {QBluetoothServiceInfo::L2capLeProtocol}{L2capLeProtocol} servers a zero \a port
+    lets the kernel pick a free dynamic LE PSM, which can be read back using serverPort().
+
     Returns \c true if the operation succeeded and the server is listening for
     incoming connections, otherwise returns \c false.
 
@@ -160,6 +168,9 @@ QBluetoothServer::~QBluetoothServer()
     invalid QBluetoothServiceInfo. This function always assumes that the default Bluetooth adapter
     should be used.
 
+    Servers of type \l {QBluetoothServiceInfo::L2capLeProtocol}{L2capLeProtocol} cannot be
+    registered via SDP, this function always returns an invalid QBluetoothServiceInfo for them.
+
     If the server object is already listening for incoming connections this function
     returns an invalid \l QBluetoothServiceInfo.
 
@@ -174,7 +185,7 @@ QBluetoothServer::~QBluetoothServer()
 QBluetoothServiceInfo QBluetoothServer::listen(const QBluetoothUuid &uuid, const QString &serviceName)
 {
     Q_D(const QBluetoothServer);
-    if (!listen())
+    if (d->serverType == QBluetoothServiceInfo::L2capLeProtocol || !listen())
         return QBluetoothServiceInfo();
 //! [listen]
     QBluetoothServiceInfo serviceInfo;
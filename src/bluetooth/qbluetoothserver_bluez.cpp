@@ -36,8 +36,9 @@ QBluetoothServerPrivate::QBluetoothServerPrivate(QBluetoothServiceInfo::Protocol
       serverType(sType),
       q_ptr(parent)
 {
-    if (sType == QBluetoothServiceInfo::RfcommProtocol)
-        socket = createSocketForServer(QBluetoothServiceInfo::RfcommProtocol);
+    if (sType == QBluetoothServiceInfo::RfcommProtocol
+            || sType == QBluetoothServiceInfo::L2capLeProtocol)
+        socket = createSocketForServer(sType);
     else
         socket = createSocketForServer(QBluetoothServiceInfo::L2capProtocol);
 }
@@ -154,8 +155,9 @@ bool QBluetoothServer::listen(const QBluetoothAddress &address, quint16 port)
          */
 
         delete d->socket;
-        if (serverType() == QBluetoothServiceInfo::RfcommProtocol)
-            d->socket = QBluetoothServerPrivate::createSocketForServer(QBluetoothServiceInfo::RfcommProtocol);
+        if (serverType() == QBluetoothServiceInfo::RfcommProtocol
+                || serverType() == QBluetoothServiceInfo::L2capLeProtocol)
+            d->socket = QBluetoothServerPrivate::createSocketForServer(serverType());
         else
             d->socket = QBluetoothServerPrivate::createSocketForServer(QBluetoothServiceInfo::L2capProtocol);
 
@@ -198,7 +200,23 @@ bool QBluetoothServer::listen(const QBluetoothAddress &address, quint16 port)
         else
             convertAddress(Q_UINT64_C(0), addr.l2_bdaddr.b);
 
+#if !defined(QT_BLUEZ_NO_BTLE)
+        // A zero PSM makes the kernel allocate a free dynamic LE PSM (0x80 - 0xff)
+        if (d->serverType == QBluetoothServiceInfo::L2capLeProtocol)
+            addr.l2_bdaddr_type = BDADDR_LE_PUBLIC;
+#endif
+
         if (::bind(sock, reinterpret_cast<sockaddr *>(&addr), sizeof(sockaddr_l2)) < 0) {
+            if (errno == EADDRINUSE && d->serverType == QBluetoothServiceInfo::L2capLeProtocol)
+                d->m_lastError = ServiceAlreadyRegisteredError;
+            else
+                d->m_lastError = InputOutputError;
+            emit errorOccurred(d->m_lastError);
+            return false;
+        }
+
+        if (d->serverType == QBluetoothServiceInfo::L2capLeProtocol
+                && !QBluetoothSocketPrivateBluez::configureLeChannel(sock, device.address())) {
             d->m_lastError = InputOutputError;
             emit errorOccurred(d->m_lastError);
             return false;
@@ -270,6 +288,8 @@ QBluetoothSocket *QBluetoothServer::nextPendingConnection()
         QBluetoothSocket *newSocket = QBluetoothServerPrivate::createSocketForServer();
         if (d->serverType == QBluetoothServiceInfo::RfcommProtocol)
             newSocket->setSocketDescriptor(pending, QBluetoothServiceInfo::RfcommProtocol);
+        else if (d->serverType == QBluetoothServiceInfo::L2capLeProtocol)
+            newSocket->setSocketDescriptor(pending, QBluetoothServiceInfo::L2capLeProtocol);
         else
             newSocket->setSocketDescriptor(pending, QBluetoothServiceInfo::L2capProtocol);
 
@@ -273,7 +273,7 @@ bool QBluetoothServer::listen(const QBluetoothAddress &address, quint16 port)
 
     const ServiceInfo::Protocol type = d_ptr->serverType;
 
-    if (type == ServiceInfo::UnknownProtocol) {
+    if (type == ServiceInfo::UnknownProtocol || type == ServiceInfo::L2capLeProtocol) {
         qCWarning(QT_BT_DARWIN) << "invalid protocol";
         d_ptr->m_lastError = UnsupportedProtocolError;
         emit errorOccurred(d_ptr->m_lastError);
@@ -118,6 +118,11 @@ QT_IMPL_METATYPE_EXTERN_TAGGED(QBluetoothServiceInfo::Alternative,
     \value L2capProtocol    The service uses the L2CAP socket protocol. This protocol is not supported
                             for direct socket connections on Android.
     \value RfcommProtocol   The service uses the RFCOMM socket protocol.
+    \value [since 6.9] L2capLeProtocol
+                            The service uses an L2CAP connection-oriented channel over
+                            Bluetooth Low Energy with LE credit-based flow control. The port
+                            of such a service is its LE PSM. This protocol is only supported
+                            on Linux (BlueZ) and is never advertised through SDP.
 */
 
 /*!
@@ -48,7 +48,8 @@ public:
     enum Protocol {
         UnknownProtocol,
         L2capProtocol,
-        RfcommProtocol
+        RfcommProtocol,
+        L2capLeProtocol
     };
 
     class Sequence : public QList<QVariant>
@@ -35,7 +35,9 @@ Q_DECLARE_LOGGING_CATEGORY(QT_BT)
     \since 5.2
 
     QBluetoothSocket supports two socket types, \l {QBluetoothServiceInfo::L2capProtocol}{L2CAP} and
-    \l {QBluetoothServiceInfo::RfcommProtocol}{RFCOMM}.
+    \l {QBluetoothServiceInfo::RfcommProtocol}{RFCOMM}. On Linux, L2CAP connection-oriented
+    channels over Bluetooth Low Energy are supported as well, see
+    \l {QBluetoothServiceInfo::L2capLeProtocol}{L2capLeProtocol}.
 
     \l {QBluetoothServiceInfo::L2capProtocol}{L2CAP} is a low level datagram-oriented Bluetooth socket.
     Android does not support \l {QBluetoothServiceInfo::L2capProtocol}{L2CAP} for socket
@@ -227,10 +229,16 @@ Q_DECLARE_LOGGING_CATEGORY(QT_BT)
     \reimp
 */
 
-static QBluetoothSocketBasePrivate *createSocketPrivate()
+static QBluetoothSocketBasePrivate *createSocketPrivate(
+        [[maybe_unused]] QBluetoothServiceInfo::Protocol socketType = QBluetoothServiceInfo::UnknownProtocol)
 {
 #if QT_CONFIG(bluez)
-    if (bluetoothdVersion() >= QVersionNumber(5, 46)) {
+    // LE credit based channels are not offered by bluetoothd's profile API,
+    // they always require the raw socket implementation.
+    if (socketType == QBluetoothServiceInfo::L2capLeProtocol) {
+        qCDebug(QT_BT) << "Using Bluetooth raw socket implementation for LE L2CAP channel";
+        return new QBluetoothSocketPrivateBluez();
+    } else if (bluetoothdVersion() >= QVersionNumber(5, 46)) {
         qCDebug(QT_BT) << "Using Bluetooth dbus socket implementation";
         return new QBluetoothSocketPrivateBluezDBus();
     } else {
@@ -254,7 +262,7 @@ static QBluetoothSocketBasePrivate *createSocketPrivate()
 QBluetoothSocket::QBluetoothSocket(QBluetoothServiceInfo::Protocol socketType, QObject *parent)
 : QIODevice(parent)
 {
-    d_ptr = createSocketPrivate();
+    d_ptr = createSocketPrivate(socketType);
     d_ptr->q_ptr = this;
 
     Q_D(QBluetoothSocketBase);
@@ -408,6 +416,8 @@ void QBluetoothSocket::connectToService(const QBluetoothAddress &address, const
 
     On Android and BlueZ (version 5.46 or above), a connection to a service can not be established using a port.
     Calling this function will emit a \l {QBluetoothSocket::SocketError::ServiceNotFoundError}{ServiceNotFoundError}.
+    Sockets of type \l {QBluetoothServiceInfo::L2capLeProtocol}{L2capLeProtocol} are the exception;
+    they always connect using a port, which is the LE PSM of the remote channel.
 
     Note that most platforms require a pairing prior to connecting to the remote device. Otherwise
     the connection process may fail.
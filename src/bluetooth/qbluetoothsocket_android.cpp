@@ -346,6 +346,7 @@ void QBluetoothSocketPrivateAndroid::connectToService(
         protocol = QBluetoothServiceInfo::RfcommProtocol;
         break;
     case QBluetoothServiceInfo::RfcommProtocol:
+    case QBluetoothServiceInfo::L2capLeProtocol:
         break;
     }
 
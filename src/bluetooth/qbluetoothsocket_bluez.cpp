@@ -17,13 +17,19 @@
 #include <errno.h>
 #include <unistd.h>
 #include <string.h>
+#include <sys/uio.h>
 
 #include <QtCore/QSocketNotifier>
 
+#include <qtbluetooth_tracepoints_p.h>
+
 QT_BEGIN_NAMESPACE
 
 Q_DECLARE_LOGGING_CATEGORY(QT_BT_BLUEZ)
 
+// number of txBuffer chunks handed to a single writev() call
+static constexpr int MaxWriteVectors = 16;
+
 QBluetoothSocketPrivateBluez::QBluetoothSocketPrivateBluez()
     : QBluetoothSocketBasePrivate()
 {
@@ -61,6 +67,11 @@ bool QBluetoothSocketPrivateBluez::ensureNativeSocket(QBluetoothServiceInfo::Pro
     case QBluetoothServiceInfo::L2capProtocol:
         socket = ::socket(AF_BLUETOOTH, SOCK_SEQPACKET, BTPROTO_L2CAP);
         break;
+#if !defined(QT_BLUEZ_NO_BTLE)
+    case QBluetoothServiceInfo::L2capLeProtocol:
+        socket = ::socket(AF_BLUETOOTH, SOCK_SEQPACKET, BTPROTO_L2CAP);
+        break;
+#endif
     case QBluetoothServiceInfo::RfcommProtocol:
         socket = ::socket(AF_BLUETOOTH, SOCK_STREAM, BTPROTO_RFCOMM);
         break;
@@ -87,6 +98,110 @@ bool QBluetoothSocketPrivateBluez::ensureNativeSocket(QBluetoothServiceInfo::Pro
     return true;
 }
 
+/*
+    Prepares the unconnected L2CAP socket \a socketDescriptor for an LE credit based
+    connection. The socket is bound to the LE address type of \a localAdapter
+    because the kernel only accepts the LE channel options once the source address
+    type is known.
+*/
+bool QBluetoothSocketPrivateBluez::configureLeChannel(int socketDescriptor,
+                                                      const QBluetoothAddress &localAdapter)
+{
+#if !defined(QT_BLUEZ_NO_BTLE)
+    sockaddr_l2 addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.l2_family = AF_BLUETOOTH;
+    addr.l2_bdaddr_type = BDADDR_LE_PUBLIC;
+    convertAddress(localAdapter.toUInt64(), addr.l2_bdaddr.b);
+    if (::bind(socketDescriptor, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0
+            && errno != EINVAL) { // EINVAL -> already bound, e.g. by QBluetoothServer::listen()
+        qCWarning(QT_BT_BLUEZ) << "Cannot bind LE L2CAP socket:" << qt_error_string(errno);
+        return false;
+    }
+
+    // Spec v5.3, Vol 3, Part A, 3.4 LE credit based flow control mode.
+    // Kernels without the BT_MODE option pick this mode for every LE PSM anyway.
+    const quint8 mode = BT_MODE_LE_FLOWCTL;
+    if (setsockopt(socketDescriptor, SOL_BLUETOOTH, BT_MODE, &mode, sizeof(mode)) != 0
+            && errno != ENOPROTOOPT) {
+        qCWarning(QT_BT_BLUEZ) << "Cannot select LE flow control mode:" << qt_error_string(errno);
+        return false;
+    }
+
+    // Allow SDUs as large as our read buffer, the kernel default is only 672 bytes
+    const quint16 receiveMtu = QBLUETOOTHSOCKET_BUFFERSIZE;
+    if (setsockopt(socketDescriptor, SOL_BLUETOOTH, BT_RCVMTU,
+                   &receiveMtu, sizeof(receiveMtu)) != 0) {
+        qCDebug(QT_BT_BLUEZ) << "Keeping default LE L2CAP receive MTU:" << qt_error_string(errno);
+    }
+
+    return true;
+#else
+    Q_UNUSED(socketDescriptor);
+    Q_UNUSED(localAdapter);
+    return false;
+#endif
+}
+
+void QBluetoothSocketPrivateBluez::updateChannelMtu()
+{
+    maxPacketSize = 1024;
+    readChunkSize = QBLUETOOTHSOCKET_BUFFERSIZE;
+
+    if (socketType != QBluetoothServiceInfo::L2capLeProtocol)
+        return;
+
+    // Every write on an LE channel becomes one SDU which must not exceed the remote MTU
+    quint16 mtu = 0;
+    socklen_t length = sizeof(mtu);
+    if (getsockopt(socket, SOL_BLUETOOTH, BT_SNDMTU, &mtu, &length) == 0 && mtu > 0)
+        maxPacketSize = mtu;
+
+    mtu = 0;
+    length = sizeof(mtu);
+    if (getsockopt(socket, SOL_BLUETOOTH, BT_RCVMTU, &mtu, &length) == 0)
+        readChunkSize = qMax<qint64>(readChunkSize, mtu);
+
+    qCDebug(QT_BT_BLUEZ) << "LE L2CAP channel MTU - send:" << maxPacketSize
+                         << "receive:" << readChunkSize;
+}
+
+/*
+    Hands as much of txBuffer to the kernel as it accepts in a single call. RFCOMM
+    takes the data of several buffer chunks at once and writes as much as fits into
+    the socket's send buffer. On L2CAP sockets every call produces one packet which
+    must not exceed maxPacketSize.
+
+    Returns the number of written bytes or -1 with errno set.
+*/
+qint64 QBluetoothSocketPrivateBluez::writeToSocket()
+{
+    const qint64 limit = socketType == QBluetoothServiceInfo::RfcommProtocol
+            ? txBuffer.size()
+            : qMin(maxPacketSize, txBuffer.size());
+
+    iovec vectors[MaxWriteVectors];
+    int count = 0;
+    qint64 total = 0;
+    while (count < MaxWriteVectors && total < limit) {
+        qint64 blockSize = 0;
+        const char *block = txBuffer.readPointerAtPosition(total, blockSize);
+        blockSize = qMin(blockSize, limit - total);
+        vectors[count].iov_base = const_cast<char *>(block);
+        vectors[count].iov_len = size_t(blockSize);
+        total += blockSize;
+        ++count;
+    }
+
+    qint64 writtenBytes;
+    EINTR_LOOP(writtenBytes, ::writev(socket, vectors, count));
+    Q_TRACE(QBluetoothSocketPrivateBluez_write, socket, writtenBytes);
+    if (writtenBytes > 0)
+        txBuffer.free(writtenBytes);
+
+    return writtenBytes;
+}
+
 void QBluetoothSocketPrivateBluez::connectToServiceHelper(const QBluetoothAddress &address, quint16 port, QIODevice::OpenMode openMode)
 {
     Q_Q(QBluetoothSocket);
@@ -132,7 +247,8 @@ void QBluetoothSocketPrivateBluez::connectToServiceHelper(const QBluetoothAddres
         readNotifier->setEnabled(true);
 
         result = ::connect(socket, (sockaddr *)&addr, sizeof(addr));
-    } else if (socketType == QBluetoothServiceInfo::L2capProtocol) {
+    } else if (socketType == QBluetoothServiceInfo::L2capProtocol
+               || socketType == QBluetoothServiceInfo::L2capLeProtocol) {
         sockaddr_l2 addr;
 
         memset(&addr, 0, sizeof(addr));
@@ -144,7 +260,17 @@ void QBluetoothSocketPrivateBluez::connectToServiceHelper(const QBluetoothAddres
         // of socket.
 
 #if QT_CONFIG(bluez) && !defined(QT_BLUEZ_NO_BTLE)
-        if (lowEnergySocketType) {
+        if (socketType == QBluetoothServiceInfo::L2capLeProtocol) {
+            // Like the LE controller, connect from the default local adapter
+            const QBluetoothAddress localAdapter = QBluetoothLocalDevice().address();
+            if (!configureLeChannel(socket, localAdapter)) {
+                errorString = QBluetoothSocket::tr("Unknown socket error");
+                q->setSocketError(QBluetoothSocket::SocketError::UnknownSocketError);
+                return;
+            }
+            addr.l2_psm = htobs(port);
+            addr.l2_bdaddr_type = lowEnergySocketType ? lowEnergySocketType : BDADDR_LE_PUBLIC;
+        } else if (lowEnergySocketType) {
             addr.l2_cid = htobs(port);
             addr.l2_bdaddr_type = lowEnergySocketType;
         } else {
@@ -247,6 +373,15 @@ void QBluetoothSocketPrivateBluez::connectToService(
         return;
     }
 
+    // LE channels are not announced via SDP, they can only be reached through their PSM
+    if (q->socketType() == QBluetoothServiceInfo::L2capLeProtocol) {
+        qCWarning(QT_BT_BLUEZ) << "QBluetoothSocketPrivateBluez::connectToService requires "
+                                  "a PSM for 'L2capLeProtocol' sockets";
+        errorString = QBluetoothSocket::tr("Socket type not supported");
+        q->setSocketError(QBluetoothSocket::SocketError::UnsupportedProtocolError);
+        return;
+    }
+
     QBluetoothServiceInfo service;
     QBluetoothDeviceInfo device(address, QString(), QBluetoothDeviceInfo::MiscellaneousDevice);
     service.setDevice(device);
@@ -289,6 +424,7 @@ void QBluetoothSocketPrivateBluez::_q_writeNotify()
             return;
         }
 
+        updateChannelMtu();
         q->setSocketState(QBluetoothSocket::SocketState::ConnectedState);
 
         connectWriteNotifier->setEnabled(false);
@@ -300,14 +436,11 @@ void QBluetoothSocketPrivateBluez::_q_writeNotify()
             return;
         }
 
-        char buf[1024];
-
-        const auto size = txBuffer.read(buf, 1024);
-        const auto writtenBytes = qt_safe_write(socket, buf, size);
+        // unwritten data simply stays at the front of txBuffer
+        const auto writtenBytes = writeToSocket();
         if (writtenBytes < 0) {
             switch (errno) {
             case EAGAIN:
-                txBuffer.ungetBlock(buf, size);
                 break;
             default:
                 // every other case returns error
@@ -315,14 +448,8 @@ void QBluetoothSocketPrivateBluez::_q_writeNotify()
                 q->setSocketError(QBluetoothSocket::SocketError::NetworkError);
                 break;
             }
-        } else {
-            if (writtenBytes < size) {
-                // add remainder back to buffer
-                char* remainder = buf + writtenBytes;
-                txBuffer.ungetBlock(remainder, size - writtenBytes);
-            }
-            if (writtenBytes > 0)
-                emit q->bytesWritten(writtenBytes);
+        } else if (writtenBytes > 0) {
+            emit q->bytesWritten(writtenBytes);
         }
 
         if (txBuffer.size()) {
@@ -338,30 +465,46 @@ void QBluetoothSocketPrivateBluez::_q_writeNotify()
 void QBluetoothSocketPrivateBluez::_q_readNotify()
 {
     Q_Q(QBluetoothSocket);
-    char *writePointer = rxBuffer.reserve(QPRIVATELINEARBUFFER_BUFFERSIZE);
-//    qint64 readFromDevice = q->readData(writePointer, QPRIVATELINEARBUFFER_BUFFERSIZE);
-    const auto readFromDevice = ::read(socket, writePointer, QPRIVATELINEARBUFFER_BUFFERSIZE);
-    rxBuffer.chop(QPRIVATELINEARBUFFER_BUFFERSIZE - (readFromDevice < 0 ? 0 : readFromDevice));
+    char *writePointer = rxBuffer.reserve(readChunkSize);
+//    qint64 readFromDevice = q->readData(writePointer, readChunkSize);
+    const auto readFromDevice = ::read(socket, writePointer, readChunkSize);
+    Q_TRACE(QBluetoothSocketPrivateBluez_read, socket, readFromDevice);
+    rxBuffer.chop(readChunkSize - (readFromDevice < 0 ? 0 : readFromDevice));
     if(readFromDevice <= 0){
         int errsv = errno;
-        readNotifier->setEnabled(false);
-        connectWriteNotifier->setEnabled(false);
-        errorString = qt_error_string(errsv);
-        qCWarning(QT_BT_BLUEZ) << Q_FUNC_INFO << socket << "error:" << readFromDevice << errorString;
-        if (errsv == EHOSTDOWN)
-            q->setSocketError(QBluetoothSocket::SocketError::HostNotFoundError);
-        else if (errsv == ECONNRESET)
-            q->setSocketError(QBluetoothSocket::SocketError::RemoteHostClosedError);
-        else
-            q->setSocketError(QBluetoothSocket::SocketError::UnknownSocketError);
-
-        q->disconnectFromService();
+        qCWarning(QT_BT_BLUEZ) << Q_FUNC_INFO << socket << "error:" << readFromDevice
+                               << qt_error_string(errsv);
+        handleReadError(errsv);
     }
     else {
         emit q->readyRead();
     }
 }
 
+void QBluetoothSocketPrivateBluez::setReadNotificationEnabled(bool enable)
+{
+    if (readNotifier)
+        readNotifier->setEnabled(enable);
+}
+
+void QBluetoothSocketPrivateBluez::handleReadError(int errorCode)
+{
+    Q_Q(QBluetoothSocket);
+    if (readNotifier)
+        readNotifier->setEnabled(false);
+    if (connectWriteNotifier)
+        connectWriteNotifier->setEnabled(false);
+    errorString = qt_error_string(errorCode);
+    if (errorCode == EHOSTDOWN)
+        q->setSocketError(QBluetoothSocket::SocketError::HostNotFoundError);
+    else if (errorCode == ECONNRESET)
+        q->setSocketError(QBluetoothSocket::SocketError::RemoteHostClosedError);
+    else
+        q->setSocketError(QBluetoothSocket::SocketError::UnknownSocketError);
+
+    q->disconnectFromService();
+}
+
 void QBluetoothSocketPrivateBluez::abort()
 {
     delete readNotifier;
@@ -400,7 +543,8 @@ QBluetoothAddress QBluetoothSocketPrivateBluez::localAddress() const
 
         if (::getsockname(socket, reinterpret_cast<sockaddr *>(&addr), &addrLength) == 0)
             return QBluetoothAddress(convertAddress(addr.rc_bdaddr.b));
-    } else if (socketType == QBluetoothServiceInfo::L2capProtocol) {
+    } else if (socketType == QBluetoothServiceInfo::L2capProtocol
+               || socketType == QBluetoothServiceInfo::L2capLeProtocol) {
         sockaddr_l2 addr;
         socklen_t addrLength = sizeof(addr);
 
@@ -419,7 +563,8 @@ quint16 QBluetoothSocketPrivateBluez::localPort() const
 
         if (::getsockname(socket, reinterpret_cast<sockaddr *>(&addr), &addrLength) == 0)
             return addr.rc_channel;
-    } else if (socketType == QBluetoothServiceInfo::L2capProtocol) {
+    } else if (socketType == QBluetoothServiceInfo::L2capProtocol
+               || socketType == QBluetoothServiceInfo::L2capLeProtocol) {
         sockaddr_l2 addr;
         socklen_t addrLength = sizeof(addr);
 
@@ -442,7 +587,8 @@ QString QBluetoothSocketPrivateBluez::peerName() const
             return QString();
 
         convertAddress(addr.rc_bdaddr.b, &bdaddr);
-    } else if (socketType == QBluetoothServiceInfo::L2capProtocol) {
+    } else if (socketType == QBluetoothServiceInfo::L2capProtocol
+               || socketType == QBluetoothServiceInfo::L2capLeProtocol) {
         sockaddr_l2 addr;
         socklen_t addrLength = sizeof(addr);
 
@@ -492,7 +638,8 @@ QBluetoothAddress QBluetoothSocketPrivateBluez::peerAddress() const
 
         if (::getpeername(socket, reinterpret_cast<sockaddr *>(&addr), &addrLength) == 0)
             return QBluetoothAddress(convertAddress(addr.rc_bdaddr.b));
-    } else if (socketType == QBluetoothServiceInfo::L2capProtocol) {
+    } else if (socketType == QBluetoothServiceInfo::L2capProtocol
+               || socketType == QBluetoothServiceInfo::L2capLeProtocol) {
         sockaddr_l2 addr;
         socklen_t addrLength = sizeof(addr);
 
@@ -511,7 +658,8 @@ quint16 QBluetoothSocketPrivateBluez::peerPort() const
 
         if (::getpeername(socket, reinterpret_cast<sockaddr *>(&addr), &addrLength) == 0)
             return addr.rc_channel;
-    } else if (socketType == QBluetoothServiceInfo::L2capProtocol) {
+    } else if (socketType == QBluetoothServiceInfo::L2capProtocol
+               || socketType == QBluetoothServiceInfo::L2capLeProtocol) {
         sockaddr_l2 addr;
         socklen_t addrLength = sizeof(addr);
 
@@ -534,6 +682,7 @@ qint64 QBluetoothSocketPrivateBluez::writeData(const char *data, qint64 maxSize)
 
     if (q->openMode() & QIODevice::Unbuffered) {
         auto sz = ::qt_safe_write(socket, data, maxSize);
+        Q_TRACE(QBluetoothSocketPrivateBluez_write, socket, sz);
         if (sz < 0) {
             switch (errno) {
             case EAGAIN:
@@ -560,8 +709,7 @@ qint64 QBluetoothSocketPrivateBluez::writeData(const char *data, qint64 maxSize)
             QMetaObject::invokeMethod(this, "_q_writeNotify", Qt::QueuedConnection);
         }
 
-        char *txbuf = txBuffer.reserve(maxSize);
-        memcpy(txbuf, data, maxSize);
+        txBuffer.append(data, maxSize);
 
         return maxSize;
     }
@@ -618,6 +766,9 @@ bool QBluetoothSocketPrivateBluez::setSocketDescriptor(int socketDescriptor, QBl
     connectWriteNotifier = new QSocketNotifier(socket, QSocketNotifier::Write, q);
     QObject::connect(connectWriteNotifier, SIGNAL(activated(QSocketDescriptor)), this, SLOT(_q_writeNotify()));
 
+    if (socketState == QBluetoothSocket::SocketState::ConnectedState)
+        updateChannelMtu();
+
     q->setOpenMode(openMode);
     q->setSocketState(socketState);
 
@@ -62,9 +62,23 @@ public:
     bool canReadLine() const override;
     qint64 bytesToWrite() const override;
 
+    static bool configureLeChannel(int socketDescriptor, const QBluetoothAddress &localAdapter);
+
+    // lets another reader take over the socket, which then reports read errors
+    void setReadNotificationEnabled(bool enable);
+    void handleReadError(int errorCode);
+
 private slots:
     void _q_readNotify();
     void _q_writeNotify();
+
+private:
+    void updateChannelMtu();
+    qint64 writeToSocket();
+
+    // L2CAP packet sizes of the current connection
+    qint64 maxPacketSize = 1024;
+    qint64 readChunkSize = QBLUETOOTHSOCKET_BUFFERSIZE;
 };
 
 QT_END_NAMESPACE
@@ -42,6 +42,7 @@ bool QBluetoothSocketPrivateBluezDBus::ensureNativeSocket(QBluetoothServiceInfo:
 {
     switch (type) {
     case QBluetoothServiceInfo::UnknownProtocol:
+    case QBluetoothServiceInfo::L2capLeProtocol:
         break;
     case QBluetoothServiceInfo::RfcommProtocol:
     case QBluetoothServiceInfo::L2capProtocol:
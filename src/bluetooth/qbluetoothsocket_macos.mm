@@ -270,8 +270,10 @@ void QBluetoothSocketPrivateDarwin::connectToService(const QBluetoothAddress &ad
     DarwinBluetooth::qt_test_iobluetooth_runloop();
 
     // Report this problem early, avoid device discovery:
-    if (socketType == QBluetoothServiceInfo::UnknownProtocol) {
-        qCWarning(QT_BT_DARWIN) << Q_FUNC_INFO << "cannot connect with 'UnknownProtocol' type";
+    if (socketType == QBluetoothServiceInfo::UnknownProtocol
+            || socketType == QBluetoothServiceInfo::L2capLeProtocol) {
+        qCWarning(QT_BT_DARWIN) << Q_FUNC_INFO << "cannot connect with"
+                                << "'UnknownProtocol' or 'L2capLeProtocol' type";
         errorString = QCoreApplication::translate(SOCKET, SOC_NETWORK_ERROR);
         q_ptr->setSocketError(QBluetoothSocket::SocketError::UnsupportedProtocolError);
         return;
@@ -298,8 +300,10 @@ void QBluetoothSocketPrivateDarwin::connectToService(const QBluetoothAddress &ad
 
     DarwinBluetooth::qt_test_iobluetooth_runloop();
 
-    if (socketType == QBluetoothServiceInfo::UnknownProtocol) {
-        qCWarning(QT_BT_DARWIN) << Q_FUNC_INFO << "cannot connect with 'UnknownProtocol' type";
+    if (socketType == QBluetoothServiceInfo::UnknownProtocol
+            || socketType == QBluetoothServiceInfo::L2capLeProtocol) {
+        qCWarning(QT_BT_DARWIN) << Q_FUNC_INFO << "cannot connect with"
+                                << "'UnknownProtocol' or 'L2capLeProtocol' type";
         errorString = QCoreApplication::translate(SOCKET, SOC_NETWORK_ERROR);
         q_ptr->setSocketError(QBluetoothSocket::SocketError::UnsupportedProtocolError);
         return;
@@ -23,13 +23,7 @@
 #include "qbluetoothsocket.h"
 #include "darwin/btraii_p.h"
 
-#ifndef QPRIVATELINEARBUFFER_BUFFERSIZE
-#define QPRIVATELINEARBUFFER_BUFFERSIZE Q_INT64_C(16384)
-#endif
-// The order is important: bytearray before buffer:
 #include <QtCore/qbytearray.h>
-#include "qprivatelinearbuffer_p.h"
-
 #include <QtCore/qglobal.h>
 #include <QtCore/QIODevice>
 #include <QtCore/QList>
@@ -43,10 +43,10 @@ namespace ABI {
 }
 #endif // QT_WINRT_BLUETOOTH
 
-#ifndef QPRIVATELINEARBUFFER_BUFFERSIZE
-#define QPRIVATELINEARBUFFER_BUFFERSIZE Q_INT64_C(16384)
+#ifndef QBLUETOOTHSOCKET_BUFFERSIZE
+#define QBLUETOOTHSOCKET_BUFFERSIZE Q_INT64_C(16384)
 #endif
-#include "qprivatelinearbuffer_p.h"
+#include <QtCore/private/qringbuffer_p.h>
 
 QT_FORWARD_DECLARE_CLASS(QSocketNotifier)
 QT_FORWARD_DECLARE_CLASS(QBluetoothServiceDiscoveryAgent)
@@ -112,8 +112,9 @@ public:
 #endif
 
 public:
-    QPrivateLinearBuffer rxBuffer;
-    QPrivateLinearBuffer txBuffer;
+    // segmented, so that buffered data is never moved when either side is appended or consumed
+    QRingBuffer rxBuffer{QBLUETOOTHSOCKET_BUFFERSIZE};
+    QRingBuffer txBuffer{QBLUETOOTHSOCKET_BUFFERSIZE};
     int socket = -1;
     QBluetoothServiceInfo::Protocol socketType = QBluetoothServiceInfo::UnknownProtocol;
     QBluetoothSocket::SocketState state = QBluetoothSocket::SocketState::UnconnectedState;
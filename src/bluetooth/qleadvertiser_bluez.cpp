@@ -7,8 +7,13 @@
 #include "bluez/hcimanager_p.h"
 #include "qbluetoothsocketbase_p.h"
 
+#include <QtCore/qhash.h>
 #include <QtCore/qloggingcategory.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qtimer.h>
 
+#include <algorithm>
 #include <cstring>
 
 QT_BEGIN_NAMESPACE
@@ -50,83 +55,43 @@ QLeAdvertiserBluez::QLeAdvertiserBluez(const QLowEnergyAdvertisingParameters &pa
                                        const QLowEnergyAdvertisingData &advertisingData,
                                        const QLowEnergyAdvertisingData &scanResponseData,
                                        std::shared_ptr<HciManager> hciManager, QObject *parent)
-    : QLeAdvertiser(params, advertisingData, scanResponseData, parent), m_hciManager(hciManager)
+    : QLeAdvertiser(params, advertisingData, scanResponseData, parent),
+      m_manager(QLeAdvertisingSetManager::forHciManager(hciManager))
 {
-    Q_ASSERT(m_hciManager);
-    connect(m_hciManager.get(), &HciManager::commandCompleted, this,
-            &QLeAdvertiserBluez::handleCommandCompleted);
 }
 
 QLeAdvertiserBluez::~QLeAdvertiserBluez()
 {
-    disconnect(m_hciManager.get(), &HciManager::commandCompleted, this,
-               &QLeAdvertiserBluez::handleCommandCompleted);
-    doStopAdvertising();
+    m_manager->removeAdvertiser(this);
 }
 
 void QLeAdvertiserBluez::doStartAdvertising()
 {
-    if (!m_hciManager->monitorEvent(HciManager::HciEvent::EVT_CMD_COMPLETE)) {
-        handleError();
-        return;
-    }
-
-    m_sendPowerLevel = advertisingData().includePowerLevel()
-            || scanResponseData().includePowerLevel();
-    if (m_sendPowerLevel)
-        queueReadTxPowerLevelCommand();
-    else
-        queueAdvertisingCommands();
-    sendNextCommand();
+    m_manager->startAdvertising(this);
 }
 
 void QLeAdvertiserBluez::doStopAdvertising()
 {
-    toggleAdvertising(false);
-    sendNextCommand();
-}
-
-void QLeAdvertiserBluez::queueCommand(QBluezConst::OpCodeCommandField ocf, const QByteArray &data)
-{
-    m_pendingCommands << Command(ocf, data);
-}
-
-void QLeAdvertiserBluez::sendNextCommand()
-{
-    if (m_pendingCommands.isEmpty()) {
-        // TODO: Unmonitor event.
-        return;
-    }
-    const Command &c = m_pendingCommands.first();
-    if (!m_hciManager->sendCommand(QBluezConst::OgfLinkControl, c.ocf, c.data)) {
-        handleError();
-        return;
-    }
+    m_manager->stopAdvertising(this);
 }
 
-void QLeAdvertiserBluez::queueAdvertisingCommands()
+bool QLeAdvertiserBluez::includesPowerLevel() const
 {
-    toggleAdvertising(false); // Stop advertising first, in case it's currently active.
-    setWhiteList();
-    setAdvertisingParams();
-    setAdvertisingData();
-    setScanResponseData();
-    toggleAdvertising(true);
+    return advertisingData().includePowerLevel() || scanResponseData().includePowerLevel();
 }
 
-void QLeAdvertiserBluez::queueReadTxPowerLevelCommand()
+int QLeAdvertiserBluez::maximumInterval() const
 {
-    // Spec v4.2, Vol 2, Part E, 7.8.6
-    queueCommand(QBluezConst::OcfLeReadTxPowerLevel, QByteArray());
+    return parameters().maximumInterval();
 }
 
-void QLeAdvertiserBluez::toggleAdvertising(bool enable)
+bool QLeAdvertiserBluez::isScannable() const
 {
-    // Spec v4.2, Vol 2, Part E, 7.8.9
-    queueCommand(QBluezConst::OcfLeSetAdvEnable, QByteArray(1, enable));
+    return parameters().mode() == QLowEnergyAdvertisingParameters::AdvScanInd
+            || parameters().mode() == QLowEnergyAdvertisingParameters::AdvInd;
 }
 
-void QLeAdvertiserBluez::setAdvertisingParams()
+AdvParams QLeAdvertiserBluez::advertisingParams() const
 {
     // Spec v4.2, Vol 2, Part E, 7.8.5
     // or Spec v5.3, Vol 4, Part E, 7.8.5
@@ -150,10 +115,7 @@ void QLeAdvertiserBluez::setAdvertisingParams()
     // params.direct_bdaddr = xxx;
 
     params.channelMap = 0x7; // All channels.
-
-    const QByteArray paramsData = byteArrayFromStruct(params);
-    qCDebug(QT_BT_BLUEZ) << "advertising parameters:" << paramsData.toHex();
-    queueCommand(QBluezConst::OcfLeSetAdvParams, paramsData);
+    return params;
 }
 
 static quint16 forceIntoRange(quint16 val, quint16 min, quint16 max)
@@ -161,7 +123,7 @@ static quint16 forceIntoRange(quint16 val, quint16 min, quint16 max)
     return qMin(qMax(val, min), max);
 }
 
-void QLeAdvertiserBluez::setAdvertisingInterval(AdvParams &params)
+void QLeAdvertiserBluez::setAdvertisingInterval(AdvParams &params) const
 {
     const double multiplier = 0.625;
     const quint16 minVal = parameters().minimumInterval() / multiplier;
@@ -176,16 +138,16 @@ void QLeAdvertiserBluez::setAdvertisingInterval(AdvParams &params)
     Q_ASSERT(params.minInterval <= params.maxInterval);
 }
 
-void QLeAdvertiserBluez::setPowerLevel(AdvData &advData)
+void QLeAdvertiserBluez::setPowerLevel(AdvData &advData, std::optional<qint8> powerLevel) const
 {
-    if (m_sendPowerLevel) {
+    if (powerLevel) {
         advData.data[advData.length++] = 2;
         advData.data[advData.length++]= 0xa;
-        advData.data[advData.length++] = m_powerLevel;
+        advData.data[advData.length++] = quint8(*powerLevel);
     }
 }
 
-void QLeAdvertiserBluez::setFlags(AdvData &advData)
+void QLeAdvertiserBluez::setFlags(AdvData &advData) const
 {
     // TODO: Discoverability flags are incompatible with ADV_DIRECT_IND
     quint8 flags = 0;
@@ -241,7 +203,8 @@ static void addServicesData(AdvData &data, const QList<T> &services)
     }
 }
 
-void QLeAdvertiserBluez::setServicesData(const QLowEnergyAdvertisingData &src, AdvData &dest)
+void QLeAdvertiserBluez::setServicesData(const QLowEnergyAdvertisingData &src,
+                                         AdvData &dest) const
 {
     QList<quint16> services16;
     QList<quint32> services32;
@@ -268,7 +231,8 @@ void QLeAdvertiserBluez::setServicesData(const QLowEnergyAdvertisingData &src, A
     addServicesData(dest, services128);
 }
 
-void QLeAdvertiserBluez::setManufacturerData(const QLowEnergyAdvertisingData &src, AdvData &dest)
+void QLeAdvertiserBluez::setManufacturerData(const QLowEnergyAdvertisingData &src,
+                                             AdvData &dest) const
 {
     if (src.manufacturerId() == QLowEnergyAdvertisingData::invalidManufacturerId())
         return;
@@ -287,7 +251,8 @@ void QLeAdvertiserBluez::setManufacturerData(const QLowEnergyAdvertisingData &sr
     dest.length += manufacturerData.size();
 }
 
-void QLeAdvertiserBluez::setLocalNameData(const QLowEnergyAdvertisingData &src, AdvData &dest)
+void QLeAdvertiserBluez::setLocalNameData(const QLowEnergyAdvertisingData &src,
+                                          AdvData &dest) const
 {
     if (src.localName().isEmpty())
         return;
@@ -307,7 +272,8 @@ void QLeAdvertiserBluez::setLocalNameData(const QLowEnergyAdvertisingData &src,
     dest.length += size - 2;
 }
 
-void QLeAdvertiserBluez::setData(bool isScanResponseData)
+QByteArray QLeAdvertiserBluez::packetData(bool isScanResponseData,
+                                          std::optional<qint8> powerLevel) const
 {
     // Spec v4.2, Vol 3, Part C, 11 and Supplement, Part 1
     AdvData theData;
@@ -322,7 +288,7 @@ void QLeAdvertiserBluez::setData(bool isScanResponseData)
         std::memcpy(theData.data, rawData.data(), theData.length);
     } else {
         if (sourceData.includePowerLevel())
-            setPowerLevel(theData);
+            setPowerLevel(theData, powerLevel);
         if (!isScanResponseData)
             setFlags(theData);
 
@@ -333,103 +299,555 @@ void QLeAdvertiserBluez::setData(bool isScanResponseData)
         setManufacturerData(sourceData, theData);
     }
 
+    // Scan response data is only sent for scannable advertisements with actual content.
+    if (isScanResponseData && (!isScannable() || theData.length == 0))
+        return QByteArray();
+
     std::memset(theData.data + theData.length, 0, sizeof theData.data - theData.length);
     const QByteArray dataToSend = byteArrayFromStruct(theData);
+    qCDebug(QT_BT_BLUEZ) << (isScanResponseData ? "scan response data:" : "advertising data:")
+                         << dataToSend.toHex();
+    return dataToSend;
+}
 
-    if (!isScanResponseData) {
-        qCDebug(QT_BT_BLUEZ) << "advertising data:" << dataToSend.toHex();
-        queueCommand(QBluezConst::OcfLeSetAdvData, dataToSend);
-    } else if ((parameters().mode() == QLowEnergyAdvertisingParameters::AdvScanInd
-               || parameters().mode() == QLowEnergyAdvertisingParameters::AdvInd)
-               && theData.length > 0) {
-        qCDebug(QT_BT_BLUEZ) << "scan response data:" << dataToSend.toHex();
-        queueCommand(QBluezConst::OcfLeSetScanResponseData, dataToSend);
+QList<QByteArray> QLeAdvertiserBluez::whiteListData() const
+{
+    QList<QByteArray> whiteList;
+    if (parameters().filterPolicy() == QLowEnergyAdvertisingParameters::IgnoreWhiteList)
+        return whiteList;
+    const QList<QLowEnergyAdvertisingParameters::AddressInfo> whiteListInfos
+            = parameters().whiteList();
+    for (const auto &addressInfo : whiteListInfos) {
+        WhiteListParams commandParam;
+        static_assert(sizeof commandParam == 7, "unexpected struct size");
+        commandParam.addrType = addressInfo.type;
+        convertAddress(addressInfo.address.toUInt64(), commandParam.addr.b);
+        whiteList << byteArrayFromStruct(commandParam);
     }
+    return whiteList;
 }
 
-void QLeAdvertiserBluez::setAdvertisingData()
+void QLeAdvertiserBluez::handleError()
 {
-    // Spec v4.2, Vol 2, Part E, 7.8.7
-    setData(false);
+    emit errorOccurred();
 }
 
-void QLeAdvertiserBluez::setScanResponseData()
+// Spec v5.3, Vol 4, Part E, 7.8.53
+struct ExtAdvParams {
+    quint8 handle;
+    quint16 eventProperties;
+    quint8 minInterval[3];
+    quint8 maxInterval[3];
+    quint8 channelMap;
+    quint8 ownAddrType;
+    quint8 peerAddrType;
+    bdaddr_t peerAddr;
+    quint8 filterPolicy;
+    qint8 txPower;
+    quint8 primaryPhy;
+    quint8 secondaryMaxSkip;
+    quint8 secondaryPhy;
+    quint8 sid;
+    quint8 scanRequestNotification;
+} __attribute__ ((packed));
+
+static void putInterval24(quint16 interval, quint8 *dest)
 {
-    // Spec v4.2, Vol 2, Part E, 7.8.8
-    setData(true);
+    dest[0] = interval & 0xff;
+    dest[1] = (interval >> 8) & 0xff;
+    dest[2] = 0;
 }
 
-void QLeAdvertiserBluez::setWhiteList()
+static quint16 extendedEventProperties(quint8 legacyType)
 {
-    // Spec v4.2, Vol 2, Part E, 7.8.15-16
-    if (parameters().filterPolicy() == QLowEnergyAdvertisingParameters::IgnoreWhiteList)
+    // Legacy PDUs are used, so that existing scanners keep seeing the data.
+    switch (legacyType) {
+    case QLowEnergyAdvertisingParameters::AdvInd:
+        return 0x13; // legacy, connectable, scannable
+    case QLowEnergyAdvertisingParameters::AdvScanInd:
+        return 0x12; // legacy, scannable
+    case QLowEnergyAdvertisingParameters::AdvNonConnInd:
+    default:
+        return 0x10; // legacy
+    }
+}
+
+// Kernel-managed advertising instances are numbered upwards starting from 1,
+// so allocate our advertising handles downwards from the spec maximum.
+static constexpr quint8 maxAdvertisingHandle = 0xef;
+
+// The minimum time a legacy advertising set stays on air before the next one
+// takes over. It gives scanners a chance to see a few advertising events.
+static constexpr int minimumRotationInterval = 100;
+
+namespace {
+// All advertisers of one adapter must share the manager, otherwise their HCI
+// commands interleave and they overwrite each other's advertising state.
+// The manager is a QObject, hence it is only shared within a thread.
+struct AdvertisingSetManagers
+{
+    QMutex mutex;
+    QHash<std::pair<int, QThread *>, std::weak_ptr<QLeAdvertisingSetManager>> managers;
+};
+} // namespace
+
+Q_GLOBAL_STATIC(AdvertisingSetManagers, advertisingSetManagers)
+
+QLeAdvertisingSetManager::QLeAdvertisingSetManager(std::shared_ptr<HciManager> hciManager)
+    : m_hciManager(std::move(hciManager)),
+      m_rotationTimer(new QTimer(this))
+{
+    Q_ASSERT(m_hciManager);
+    connect(m_hciManager.get(), &HciManager::commandCompleted, this,
+            &QLeAdvertisingSetManager::handleCommandCompleted);
+    connect(m_rotationTimer, &QTimer::timeout, this, [this]() {
+        putNextLegacySetOnAir();
+        sendNextCommand();
+    });
+}
+
+QLeAdvertisingSetManager::~QLeAdvertisingSetManager()
+{
+    disconnect(m_hciManager.get(), &HciManager::commandCompleted, this,
+               &QLeAdvertisingSetManager::handleCommandCompleted);
+
+    // The advertisers are gone, the remaining commands disable and remove their
+    // sets. Nobody waits for their completion, the kernel queues them.
+    for (qsizetype i = m_commandInFlight ? 1 : 0; i < m_pendingCommands.size(); ++i) {
+        const Command &c = m_pendingCommands.at(i);
+        if (c.payload == Payload::Fixed)
+            m_hciManager->sendCommand(QBluezConst::OgfLinkControl, c.ocf, c.data);
+    }
+
+    if (!advertisingSetManagers.isDestroyed()) {
+        AdvertisingSetManagers *const registry = advertisingSetManagers();
+        QMutexLocker locker(&registry->mutex);
+        for (auto it = registry->managers.begin(); it != registry->managers.end();) {
+            if (it->expired())
+                it = registry->managers.erase(it);
+            else
+                ++it;
+        }
+    }
+}
+
+std::shared_ptr<QLeAdvertisingSetManager> QLeAdvertisingSetManager::forHciManager(
+        const std::shared_ptr<HciManager> &hciManager)
+{
+    AdvertisingSetManagers *const registry = advertisingSetManagers();
+    const auto key = std::make_pair(hciManager->hciDeviceId(), QThread::currentThread());
+    QMutexLocker locker(&registry->mutex);
+    if (auto manager = registry->managers.value(key).lock())
+        return manager;
+    auto manager = std::make_shared<QLeAdvertisingSetManager>(hciManager);
+    registry->managers.insert(key, manager);
+    return manager;
+}
+
+void QLeAdvertisingSetManager::startAdvertising(QLeAdvertiserBluez *advertiser)
+{
+    if (!m_hciManager->monitorEvent(HciManager::HciEvent::EVT_CMD_COMPLETE)) {
+        advertiser->handleError();
         return;
-    queueCommand(QBluezConst::OcfLeClearWhiteList, QByteArray());
-    const QList<QLowEnergyAdvertisingParameters::AddressInfo> whiteListInfos
-            = parameters().whiteList();
-    for (const auto &addressInfo : whiteListInfos) {
-        WhiteListParams commandParam;
-        static_assert(sizeof commandParam == 7, "unexpected struct size");
-        commandParam.addrType = addressInfo.type;
-        convertAddress(addressInfo.address.toUInt64(), commandParam.addr.b);
-        queueCommand(QBluezConst::OcfLeAddToWhiteList, byteArrayFromStruct(commandParam));
     }
+
+    AdvertisingSet *set = findSet(advertiser);
+    if (!set) {
+        AdvertisingSet newSet;
+        newSet.advertiser = advertiser;
+        newSet.handle = allocateHandle();
+        m_sets.append(newSet);
+        set = &m_sets.last();
+    }
+    set->enabled = true;
+
+    switch (m_mode) {
+    case Mode::Unknown:
+        // Spec v5.3, Vol 4, Part E, 7.8.58
+        // Controllers without extended advertising reject this command, which
+        // also tells us that only the legacy advertising instance is available.
+        m_mode = Mode::Detecting;
+        queueCommand(QBluezConst::OcfLeReadNumberOfSupportedAdvSets, QByteArray());
+        break;
+    case Mode::Detecting:
+        // The set is activated once the detection is done.
+        break;
+    case Mode::Legacy:
+    case Mode::Extended:
+        activateSet(*set);
+        break;
+    }
+    sendNextCommand();
+}
+
+void QLeAdvertisingSetManager::stopAdvertising(QLeAdvertiserBluez *advertiser)
+{
+    AdvertisingSet *set = findSet(advertiser);
+    if (!set || !set->enabled)
+        return;
+    set->enabled = false;
+
+    switch (m_mode) {
+    case Mode::Extended: {
+        // Spec v5.3, Vol 4, Part E, 7.8.56
+        const char command[] = { 0x00, 0x01, char(set->handle), 0x00, 0x00, 0x00 };
+        queueCommand(QBluezConst::OcfLeSetExtAdvEnable, QByteArray(command, sizeof command));
+        break;
+    }
+    case Mode::Legacy:
+        if (m_onAir == advertiser) {
+            // Spec v4.2, Vol 2, Part E, 7.8.9
+            queueCommand(QBluezConst::OcfLeSetAdvEnable, QByteArray(1, false));
+            m_onAir = nullptr;
+            putNextLegacySetOnAir();
+        }
+        updateRotation();
+        break;
+    case Mode::Unknown:
+    case Mode::Detecting:
+        break;
+    }
+    sendNextCommand();
+}
+
+void QLeAdvertisingSetManager::removeAdvertiser(QLeAdvertiserBluez *advertiser)
+{
+    AdvertisingSet *set = findSet(advertiser);
+    if (!set)
+        return;
+    stopAdvertising(advertiser);
+
+    set = findSet(advertiser);
+    if (m_mode == Mode::Extended) {
+        // Spec v5.3, Vol 4, Part E, 7.8.59
+        queueCommand(QBluezConst::OcfLeRemoveAdvSet, QByteArray(1, char(set->handle)));
+    }
+
+    // The command in flight stays queued so that its completion can be matched.
+    for (qsizetype i = m_pendingCommands.size() - 1; i >= 0; --i) {
+        if (m_pendingCommands.at(i).advertiser != advertiser)
+            continue;
+        if (i == 0 && m_commandInFlight)
+            m_pendingCommands[i].advertiser = nullptr;
+        else
+            m_pendingCommands.removeAt(i);
+    }
+    m_sets.removeIf([advertiser](const AdvertisingSet &s) { return s.advertiser == advertiser; });
+    sendNextCommand();
+}
+
+QLeAdvertisingSetManager::AdvertisingSet *QLeAdvertisingSetManager::findSet(
+        const QLeAdvertiserBluez *advertiser)
+{
+    for (AdvertisingSet &set : m_sets) {
+        if (set.advertiser == advertiser)
+            return &set;
+    }
+    return nullptr;
+}
+
+quint8 QLeAdvertisingSetManager::allocateHandle() const
+{
+    for (quint8 handle = maxAdvertisingHandle; handle > 0; --handle) {
+        const bool used = std::any_of(m_sets.cbegin(), m_sets.cend(),
+                                      [handle](const AdvertisingSet &s) {
+                                          return s.handle == handle;
+                                      });
+        if (!used)
+            return handle;
+    }
+    return 0;
+}
+
+void QLeAdvertisingSetManager::queueCommand(QBluezConst::OpCodeCommandField ocf,
+                                            const QByteArray &data,
+                                            QLeAdvertiserBluez *advertiser, Payload payload)
+{
+    m_pendingCommands << Command{ocf, data, advertiser, payload};
 }
 
-void QLeAdvertiserBluez::handleCommandCompleted(quint16 opCode, quint8 status,
-                                                const QByteArray &data)
+void QLeAdvertisingSetManager::sendNextCommand()
 {
-    if (m_pendingCommands.isEmpty())
+    while (!m_commandInFlight && !m_pendingCommands.isEmpty()) {
+        const Command &c = m_pendingCommands.first();
+        QByteArray data = c.data;
+        if (c.payload != Payload::Fixed) {
+            data = payloadData(c);
+            if (data.isEmpty()) {
+                m_pendingCommands.removeFirst();
+                continue;
+            }
+        }
+        if (!m_hciManager->sendCommand(QBluezConst::OgfLinkControl, c.ocf, data)) {
+            QLeAdvertiserBluez * const advertiser = c.advertiser;
+            m_pendingCommands.removeFirst();
+            if (advertiser)
+                failAdvertiser(advertiser);
+            continue;
+        }
+        m_commandInFlight = true;
+    }
+}
+
+QByteArray QLeAdvertisingSetManager::payloadData(const Command &command)
+{
+    // The payload is created just before sending, as it may contain the
+    // TX power level reported by an earlier command.
+    const AdvertisingSet *set = findSet(command.advertiser);
+    if (!set)
+        return QByteArray();
+
+    const bool isScanResponseData = command.payload == Payload::ScanResponseData;
+    if (m_mode != Mode::Extended)
+        return set->advertiser->packetData(isScanResponseData, m_legacyTxPower);
+
+    const QByteArray packet = set->advertiser->packetData(isScanResponseData, set->txPower);
+    if (packet.isEmpty())
+        return packet;
+
+    // Spec v5.3, Vol 4, Part E, 7.8.54-55
+    // Handle, operation "complete data", no fragmentation preference, then the
+    // length-prefixed data exactly as in the legacy command.
+    QByteArray data;
+    data.reserve(3 + 1 + quint8(packet.at(0)));
+    data.append(char(set->handle)).append(char(0x03)).append(char(0x01));
+    data.append(packet.constData(), 1 + quint8(packet.at(0)));
+    return data;
+}
+
+void QLeAdvertisingSetManager::handleCommandCompleted(quint16 opCode, quint8 status,
+                                                      const QByteArray &data)
+{
+    if (!m_commandInFlight || m_pendingCommands.isEmpty())
         return;
     const QBluezConst::OpCodeCommandField ocf = QBluezConst::OpCodeCommandField(ocfFromOpCode(opCode));
-    const Command currentCmd = m_pendingCommands.first();
-    if (currentCmd.ocf != ocf)
+    if (m_pendingCommands.first().ocf != ocf)
         return; // Not one of our commands.
-    m_pendingCommands.takeFirst();
+    const Command currentCmd = m_pendingCommands.takeFirst();
+    m_commandInFlight = false;
+
     if (status != 0) {
         qCDebug(QT_BT_BLUEZ) << "command" << ocf
                              << "failed with status" << (HciManager::HciError)status
                              << "status code" << status;
-        if (ocf == QBluezConst::OcfLeSetAdvEnable && status == 0xc && currentCmd.data == QByteArray(1, '\0')) {
-            // we ignore OcfLeSetAdvEnable if it tries to disable an active advertisement
-            // it seems the platform often automatically turns off advertisements
-            // subsequently the explicit stopAdvertisement call fails when re-issued
-            qCDebug(QT_BT_BLUEZ) << "Advertising disable failed, ignoring";
-            sendNextCommand();
-            return;
-        }
-        if (ocf == QBluezConst::OcfLeReadTxPowerLevel) {
-            qCDebug(QT_BT_BLUEZ) << "reading power level failed, leaving it out of the "
-                                    "advertising data";
-            m_sendPowerLevel = false;
-        } else {
-            handleError();
-            return;
-        }
     } else {
         qCDebug(QT_BT_BLUEZ) << "command" << ocf << "executed successfully";
     }
 
     switch (ocf) {
+    case QBluezConst::OcfLeReadNumberOfSupportedAdvSets:
+        if (status == 0 && !data.isEmpty() && data.at(0) != 0) {
+            qCDebug(QT_BT_BLUEZ) << "controller supports" << quint8(data.at(0))
+                                 << "extended advertising sets";
+            m_mode = Mode::Extended;
+        } else {
+            qCDebug(QT_BT_BLUEZ) << "extended advertising not available, "
+                                    "rotating sets on the legacy advertising instance";
+            m_mode = Mode::Legacy;
+        }
+        for (AdvertisingSet &set : m_sets) {
+            if (set.enabled)
+                activateSet(set);
+        }
+        break;
     case QBluezConst::OcfLeReadTxPowerLevel:
-        if (m_sendPowerLevel) {
-            m_powerLevel = data.at(0);
-            qCDebug(QT_BT_BLUEZ) << "TX power level is" << m_powerLevel;
+        m_legacyTxPowerRead = true;
+        if (status == 0 && !data.isEmpty()) {
+            m_legacyTxPower = qint8(data.at(0));
+            qCDebug(QT_BT_BLUEZ) << "TX power level is" << int(*m_legacyTxPower);
+        } else {
+            qCDebug(QT_BT_BLUEZ) << "reading power level failed, leaving it out of the "
+                                    "advertising data";
+        }
+        break;
+    case QBluezConst::OcfLeSetAdvEnable:
+        if (status == quint8(HciManager::HciError::HCI_COMMAND_DISALLOWED)
+                && currentCmd.data == QByteArray(1, '\0')) {
+            // we ignore OcfLeSetAdvEnable if it tries to disable an active advertisement
+            // it seems the platform often automatically turns off advertisements
+            // subsequently the explicit stopAdvertisement call fails when re-issued
+            qCDebug(QT_BT_BLUEZ) << "Advertising disable failed, ignoring";
+        } else if (status != 0 && currentCmd.advertiser) {
+            failAdvertiser(currentCmd.advertiser);
+        } else if (status != 0) {
+            qCWarning(QT_BT_BLUEZ) << "Cannot stop advertising";
+        }
+        break;
+    case QBluezConst::OcfLeSetExtAdvParams:
+        if (status == 0) {
+            // The selected TX power is the first return parameter after the status.
+            if (AdvertisingSet *set = findSet(currentCmd.advertiser); set && !data.isEmpty())
+                set->txPower = qint8(data.at(0));
+        } else if (currentCmd.advertiser) {
+            failAdvertiser(currentCmd.advertiser);
         }
-        queueAdvertisingCommands();
         break;
     default:
+        if (status != 0 && currentCmd.advertiser)
+            failAdvertiser(currentCmd.advertiser);
         break;
     }
 
     sendNextCommand();
 }
 
-void QLeAdvertiserBluez::handleError()
+void QLeAdvertisingSetManager::failAdvertiser(QLeAdvertiserBluez *advertiser)
 {
-    m_pendingCommands.clear();
-    // TODO: Unmonitor event
-    emit errorOccurred();
+    const qsizetype first = m_commandInFlight ? 1 : 0;
+    for (qsizetype i = m_pendingCommands.size() - 1; i >= first; --i) {
+        if (m_pendingCommands.at(i).advertiser == advertiser)
+            m_pendingCommands.removeAt(i);
+    }
+    if (AdvertisingSet *set = findSet(advertiser))
+        set->enabled = false;
+    if (m_onAir == advertiser) {
+        m_onAir = nullptr;
+        putNextLegacySetOnAir();
+        updateRotation();
+    }
+    advertiser->handleError();
+}
+
+void QLeAdvertisingSetManager::activateSet(AdvertisingSet &set)
+{
+    if (m_mode == Mode::Extended) {
+        queueExtendedSet(set);
+        return;
+    }
+
+    Q_ASSERT(m_mode == Mode::Legacy);
+    if (!m_onAir || m_onAir == set.advertiser) {
+        // Stop advertising first, in case it's currently active.
+        queueCommand(QBluezConst::OcfLeSetAdvEnable, QByteArray(1, false), set.advertiser);
+        queueLegacySet(set);
+    }
+    updateRotation();
+}
+
+void QLeAdvertisingSetManager::queueWhiteList(QLeAdvertiserBluez *advertiser)
+{
+    // Spec v4.2, Vol 2, Part E, 7.8.15-16
+    if (advertiser->parameters().filterPolicy() == QLowEnergyAdvertisingParameters::IgnoreWhiteList)
+        return;
+    queueCommand(QBluezConst::OcfLeClearWhiteList, QByteArray(), advertiser);
+    const QList<QByteArray> whiteList = advertiser->whiteListData();
+    for (const QByteArray &entry : whiteList)
+        queueCommand(QBluezConst::OcfLeAddToWhiteList, entry, advertiser);
+}
+
+void QLeAdvertisingSetManager::queueExtendedSet(const AdvertisingSet &set)
+{
+    QLeAdvertiserBluez * const advertiser = set.advertiser;
+
+    // Parameters cannot be changed while the set is enabled; a failure to disable
+    // a set which does not exist yet is harmless.
+    const char disable[] = { 0x00, 0x01, char(set.handle), 0x00, 0x00, 0x00 };
+    queueCommand(QBluezConst::OcfLeSetExtAdvEnable, QByteArray(disable, sizeof disable));
+    queueWhiteList(advertiser);
+
+    const AdvParams legacyParams = advertiser->advertisingParams();
+    ExtAdvParams params;
+    static_assert(sizeof params == 25, "unexpected struct size");
+    std::memset(&params, 0, sizeof params);
+    params.handle = set.handle;
+    params.eventProperties = qToLittleEndian(extendedEventProperties(legacyParams.type));
+    putInterval24(qFromLittleEndian(legacyParams.minInterval), params.minInterval);
+    putInterval24(qFromLittleEndian(legacyParams.maxInterval), params.maxInterval);
+    params.channelMap = legacyParams.channelMap;
+    params.ownAddrType = legacyParams.ownAddrType;
+    params.peerAddrType = legacyParams.directAddrType;
+    params.peerAddr = legacyParams.directAddr;
+    params.filterPolicy = legacyParams.filterPolicy;
+    params.txPower = 0x7f; // No preference
+    params.primaryPhy = 0x01; // LE 1M
+    params.secondaryPhy = 0x01; // LE 1M
+    params.sid = set.handle & 0x0f;
+    const QByteArray paramsData = byteArrayFromStruct(params);
+    qCDebug(QT_BT_BLUEZ) << "extended advertising parameters:" << paramsData.toHex();
+    queueCommand(QBluezConst::OcfLeSetExtAdvParams, paramsData, advertiser);
+
+    queueCommand(QBluezConst::OcfLeSetExtAdvData, QByteArray(), advertiser,
+                 Payload::AdvertisingData);
+    queueCommand(QBluezConst::OcfLeSetExtScanResponseData, QByteArray(), advertiser,
+                 Payload::ScanResponseData);
+
+    // Spec v5.3, Vol 4, Part E, 7.8.56
+    const char enable[] = { 0x01, 0x01, char(set.handle), 0x00, 0x00, 0x00 };
+    queueCommand(QBluezConst::OcfLeSetExtAdvEnable, QByteArray(enable, sizeof enable),
+                 advertiser);
+}
+
+void QLeAdvertisingSetManager::queueLegacySet(const AdvertisingSet &set)
+{
+    QLeAdvertiserBluez * const advertiser = set.advertiser;
+    m_onAir = advertiser;
+
+    if (advertiser->includesPowerLevel() && !m_legacyTxPowerRead) {
+        // Spec v4.2, Vol 2, Part E, 7.8.6
+        queueCommand(QBluezConst::OcfLeReadTxPowerLevel, QByteArray(), advertiser);
+    }
+    queueWhiteList(advertiser);
+
+    // Spec v4.2, Vol 2, Part E, 7.8.5
+    const QByteArray paramsData = byteArrayFromStruct(advertiser->advertisingParams());
+    qCDebug(QT_BT_BLUEZ) << "advertising parameters:" << paramsData.toHex();
+    queueCommand(QBluezConst::OcfLeSetAdvParams, paramsData, advertiser);
+
+    // Spec v4.2, Vol 2, Part E, 7.8.7-8
+    queueCommand(QBluezConst::OcfLeSetAdvData, QByteArray(), advertiser,
+                 Payload::AdvertisingData);
+    queueCommand(QBluezConst::OcfLeSetScanResponseData, QByteArray(), advertiser,
+                 Payload::ScanResponseData);
+
+    // Spec v4.2, Vol 2, Part E, 7.8.9
+    queueCommand(QBluezConst::OcfLeSetAdvEnable, QByteArray(1, true), advertiser);
+}
+
+void QLeAdvertisingSetManager::putNextLegacySetOnAir()
+{
+    if (m_mode != Mode::Legacy)
+        return;
+
+    // Pick the enabled set following the one currently on air, wrapping around.
+    qsizetype current = -1;
+    for (qsizetype i = 0; i < m_sets.size(); ++i) {
+        if (m_sets.at(i).advertiser == m_onAir)
+            current = i;
+    }
+    for (qsizetype n = 1; n <= m_sets.size(); ++n) {
+        const AdvertisingSet &candidate = m_sets.at((current + n + m_sets.size()) % m_sets.size());
+        if (!candidate.enabled)
+            continue;
+        if (candidate.advertiser == m_onAir)
+            return; // Only one set is enabled, it stays on air.
+        if (m_onAir) {
+            queueCommand(QBluezConst::OcfLeSetAdvEnable, QByteArray(1, false),
+                         candidate.advertiser);
+        }
+        queueLegacySet(candidate);
+        if (m_rotationTimer->isActive())
+            m_rotationTimer->setInterval(rotationInterval(candidate.advertiser));
+        return;
+    }
+    m_onAir = nullptr;
+}
+
+void QLeAdvertisingSetManager::updateRotation()
+{
+    const auto enabledSets = std::count_if(m_sets.cbegin(), m_sets.cend(),
+                                           [](const AdvertisingSet &s) { return s.enabled; });
+    if (m_mode != Mode::Legacy || enabledSets < 2 || !m_onAir) {
+        m_rotationTimer->stop();
+        return;
+    }
+    if (!m_rotationTimer->isActive())
+        m_rotationTimer->start(rotationInterval(m_onAir));
+}
+
+int QLeAdvertisingSetManager::rotationInterval(const QLeAdvertiserBluez *advertiser) const
+{
+    // Keep each set on air for a few of its own advertising events.
+    return (std::max)(minimumRotationInterval, 3 * advertiser->maximumInterval());
 }
 
 QT_END_NAMESPACE
@@ -25,6 +25,9 @@ QT_REQUIRE_CONFIG(bluez);
 #include <QtCore/qlist.h>
 #include <QtCore/qobject.h>
 
+#include <memory>
+#include <optional>
+
 QT_BEGIN_NAMESPACE
 
 class QLeAdvertiser : public QObject
@@ -61,6 +64,8 @@ private:
 struct AdvData;
 struct AdvParams;
 class HciManager;
+class QLeAdvertisingSetManager;
+class QTimer;
 
 class QLeAdvertiserBluez : public QLeAdvertiser
 {
@@ -74,42 +79,96 @@ public:
     ~QLeAdvertiserBluez() override;
 
 private:
+    friend class QLeAdvertisingSetManager;
+
     void doStartAdvertising() override;
     void doStopAdvertising() override;
 
-    void setPowerLevel(AdvData &advData);
-    void setFlags(AdvData &advData);
-    void setServicesData(const QLowEnergyAdvertisingData &src, AdvData &dest);
-    void setManufacturerData(const QLowEnergyAdvertisingData &src, AdvData &dest);
-    void setLocalNameData(const QLowEnergyAdvertisingData &src, AdvData &dest);
+    bool includesPowerLevel() const;
+    int maximumInterval() const;
+    bool isScannable() const;
+
+    void setPowerLevel(AdvData &advData, std::optional<qint8> powerLevel) const;
+    void setFlags(AdvData &advData) const;
+    void setServicesData(const QLowEnergyAdvertisingData &src, AdvData &dest) const;
+    void setManufacturerData(const QLowEnergyAdvertisingData &src, AdvData &dest) const;
+    void setLocalNameData(const QLowEnergyAdvertisingData &src, AdvData &dest) const;
+
+    AdvParams advertisingParams() const;
+    void setAdvertisingInterval(AdvParams &params) const;
+    QByteArray packetData(bool isScanResponseData, std::optional<qint8> powerLevel) const;
+    QList<QByteArray> whiteListData() const;
 
-    void queueCommand(QBluezConst::OpCodeCommandField ocf, const QByteArray &advertisingData);
-    void sendNextCommand();
-    void queueAdvertisingCommands();
-    void queueReadTxPowerLevelCommand();
-    void toggleAdvertising(bool enable);
-    void setAdvertisingParams();
-    void setAdvertisingInterval(AdvParams &params);
-    void setData(bool isScanResponseData);
-    void setAdvertisingData();
-    void setScanResponseData();
-    void setWhiteList();
-
-    void handleCommandCompleted(quint16 opCode, quint8 status, const QByteArray &advertisingData);
     void handleError();
 
-    std::shared_ptr<HciManager> m_hciManager;
+    std::shared_ptr<QLeAdvertisingSetManager> m_manager;
+};
+
+// Schedules the advertising sets of all QLeAdvertiserBluez instances that share
+// one adapter. On controllers supporting LE extended advertising every advertiser
+// gets its own advertising set, which the controller runs concurrently with its
+// own interval. Otherwise the single legacy advertising instance is time-sliced
+// between the active advertisers.
+class Q_AUTOTEST_EXPORT QLeAdvertisingSetManager : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QLeAdvertisingSetManager(std::shared_ptr<HciManager> hciManager);
+    ~QLeAdvertisingSetManager() override;
+
+    static std::shared_ptr<QLeAdvertisingSetManager> forHciManager(
+            const std::shared_ptr<HciManager> &hciManager);
+
+    void startAdvertising(QLeAdvertiserBluez *advertiser);
+    void stopAdvertising(QLeAdvertiserBluez *advertiser);
+    void removeAdvertiser(QLeAdvertiserBluez *advertiser);
+
+private:
+    enum class Mode { Unknown, Detecting, Legacy, Extended };
+    enum class Payload { Fixed, AdvertisingData, ScanResponseData };
+
+    struct AdvertisingSet {
+        QLeAdvertiserBluez *advertiser = nullptr;
+        quint8 handle = 0;
+        bool enabled = false;
+        std::optional<qint8> txPower;
+    };
 
     struct Command {
-        Command() {}
-        Command(QBluezConst::OpCodeCommandField ocf, const QByteArray &data) : ocf(ocf), data(data) { }
         QBluezConst::OpCodeCommandField ocf;
         QByteArray data;
+        QLeAdvertiserBluez *advertiser = nullptr;
+        Payload payload = Payload::Fixed;
     };
-    QList<Command> m_pendingCommands;
 
-    quint8 m_powerLevel;
-    bool m_sendPowerLevel;
+    AdvertisingSet *findSet(const QLeAdvertiserBluez *advertiser);
+    quint8 allocateHandle() const;
+
+    void queueCommand(QBluezConst::OpCodeCommandField ocf, const QByteArray &data,
+                      QLeAdvertiserBluez *advertiser = nullptr,
+                      Payload payload = Payload::Fixed);
+    void sendNextCommand();
+    QByteArray payloadData(const Command &command);
+    void handleCommandCompleted(quint16 opCode, quint8 status, const QByteArray &data);
+    void failAdvertiser(QLeAdvertiserBluez *advertiser);
+
+    void activateSet(AdvertisingSet &set);
+    void queueWhiteList(QLeAdvertiserBluez *advertiser);
+    void queueExtendedSet(const AdvertisingSet &set);
+    void queueLegacySet(const AdvertisingSet &set);
+    void putNextLegacySetOnAir();
+    void updateRotation();
+    int rotationInterval(const QLeAdvertiserBluez *advertiser) const;
+
+    std::shared_ptr<HciManager> m_hciManager;
+    QList<AdvertisingSet> m_sets;
+    QList<Command> m_pendingCommands;
+    QTimer *m_rotationTimer = nullptr;
+    QLeAdvertiserBluez *m_onAir = nullptr; // legacy mode only
+    std::optional<qint8> m_legacyTxPower;
+    Mode m_mode = Mode::Unknown;
+    bool m_commandInFlight = false;
+    bool m_legacyTxPowerRead = false;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,143 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qleattreceiver_bluez_p.h"
+
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/qthread.h>
+
+#include <utility>
+
+#include <errno.h>
+#include <sys/socket.h>
+
+QT_BEGIN_NAMESPACE
+
+Q_DECLARE_LOGGING_CATEGORY(QT_BT_BLUEZ)
+
+namespace {
+
+class AttIoThread : public QThread
+{
+public:
+    AttIoThread()
+    {
+        setObjectName(QStringLiteral("QtBluetoothAttIo"));
+        start();
+    }
+    ~AttIoThread() override
+    {
+        quit();
+        wait();
+    }
+};
+
+} // namespace
+
+Q_GLOBAL_STATIC(AttIoThread, attIoThread)
+
+// Larger than the maximum ATT MTU of 517 bytes
+constexpr qsizetype maxPacketSize = 1024;
+
+/*
+    Returns whether the controllers use the I/O thread, which is requested by
+    setting the QT_BLUETOOTH_ATT_IO_THREAD environment variable to a non-zero value.
+*/
+bool QLeAttReceiver::isEnabled()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_BLUETOOTH_ATT_IO_THREAD") != 0;
+    return enabled;
+}
+
+QLeAttReceiver::QLeAttReceiver(int socketDescriptor)
+    : socketDescriptor(socketDescriptor)
+{
+}
+
+QLeAttReceiver::~QLeAttReceiver()
+{
+    Q_ASSERT(!notifier);
+}
+
+void QLeAttReceiver::start()
+{
+    moveToThread(attIoThread());
+    QMetaObject::invokeMethod(this, [this]() {
+        notifier = new QSocketNotifier(socketDescriptor, QSocketNotifier::Read, this);
+        connect(notifier, &QSocketNotifier::activated, this, &QLeAttReceiver::readPackets);
+    }, Qt::QueuedConnection);
+}
+
+void QLeAttReceiver::stop()
+{
+    const auto deleteNotifier = [this]() {
+        delete notifier;
+        notifier = nullptr;
+    };
+
+    // Nothing would run the call once the thread has finished, e.g. when a
+    // controller is destroyed after the global statics
+    if (attIoThread.isDestroyed() || !attIoThread->isRunning()) {
+        deleteNotifier();
+        return;
+    }
+
+    // Runs after the queued start, and after a read in progress
+    QMetaObject::invokeMethod(this, deleteNotifier, Qt::BlockingQueuedConnection);
+}
+
+bool QLeAttReceiver::hasPackets() const
+{
+    QMutexLocker locker(&mutex);
+    return !packets.isEmpty();
+}
+
+QList<QLeAttReceiver::Packet> QLeAttReceiver::takePackets()
+{
+    QMutexLocker locker(&mutex);
+    return std::exchange(packets, {});
+}
+
+void QLeAttReceiver::readPackets()
+{
+    // Each read of the SOCK_SEQPACKET socket returns one packet
+    QList<Packet> received;
+    int errorCode = -1;
+    char buffer[maxPacketSize];
+    forever {
+        const auto size = ::recv(socketDescriptor, buffer, sizeof buffer, MSG_DONTWAIT);
+        if (size > 0) {
+            Packet packet{ QByteArray(buffer, size), QElapsedTimer() };
+            packet.receivedTimer.start();
+            received.append(std::move(packet));
+            continue;
+        }
+        if (size < 0 && errno == EINTR)
+            continue;
+        if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+
+        // Zero is returned when the remote device closed the connection
+        errorCode = size < 0 ? errno : 0;
+        qCWarning(QT_BT_BLUEZ) << "ATT socket" << socketDescriptor << "read error:"
+                               << qt_error_string(errorCode);
+        notifier->setEnabled(false);
+        break;
+    }
+
+    if (!received.isEmpty()) {
+        QMutexLocker locker(&mutex);
+        const bool wasEmpty = packets.isEmpty();
+        packets.append(std::move(received));
+        locker.unlock();
+        if (wasEmpty)
+            emit packetsReceived();
+    }
+    if (errorCode >= 0)
+        emit readFailed(errorCode);
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qleattreceiver_bluez_p.cpp"
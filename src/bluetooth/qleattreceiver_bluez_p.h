@@ -0,0 +1,73 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QLEATTRECEIVER_BLUEZ_P_H
+#define QLEATTRECEIVER_BLUEZ_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qobject.h>
+
+QT_BEGIN_NAMESPACE
+
+class QSocketNotifier;
+
+/*
+    Reads the ATT packets of a connected socket on a thread shared by all
+    controllers. The packets are taken from the kernel while the thread of the
+    controller is busy, but they are still processed by the controller.
+*/
+class QLeAttReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    struct Packet
+    {
+        QByteArray data;
+        QElapsedTimer receivedTimer; // started when the packet was read
+    };
+
+    static bool isEnabled();
+
+    explicit QLeAttReceiver(int socketDescriptor);
+    ~QLeAttReceiver() override;
+
+    // start() and stop() are called in the thread of the controller, the
+    // socket must not be closed before stop() returned
+    void start();
+    void stop();
+
+    bool hasPackets() const;
+    QList<Packet> takePackets();
+
+signals:
+    // emitted when packets were added to the empty queue
+    void packetsReceived();
+    // emitted when the socket was closed or failed, errorCode is an errno value
+    void readFailed(int errorCode);
+
+private:
+    void readPackets();
+
+    const int socketDescriptor;
+    QSocketNotifier *notifier = nullptr;
+    mutable QMutex mutex;
+    QList<Packet> packets;
+};
+
+QT_END_NAMESPACE
+
+#endif // QLEATTRECEIVER_BLUEZ_P_H
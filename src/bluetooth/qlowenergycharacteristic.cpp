@@ -137,11 +137,14 @@ QString QLowEnergyCharacteristic::name() const
 */
 QBluetoothUuid QLowEnergyCharacteristic::uuid() const
 {
-    if (d_ptr.isNull() || !data
-        || !d_ptr->characteristicList.contains(data->handle))
+    if (d_ptr.isNull() || !data)
+        return QBluetoothUuid();
+
+    const auto charIt = d_ptr->characteristicList.constFind(data->handle);
+    if (charIt == d_ptr->characteristicList.constEnd())
         return QBluetoothUuid();
 
-    return d_ptr->characteristicList[data->handle].uuid;
+    return charIt->uuid;
 }
 
 /*!
@@ -151,11 +154,14 @@ QBluetoothUuid QLowEnergyCharacteristic::uuid() const
 */
 QLowEnergyCharacteristic::PropertyTypes QLowEnergyCharacteristic::properties() const
 {
-    if (d_ptr.isNull() || !data
-        || !d_ptr->characteristicList.contains(data->handle))
+    if (d_ptr.isNull() || !data)
         return QLowEnergyCharacteristic::Unknown;
 
-    return d_ptr->characteristicList[data->handle].properties;
+    const auto charIt = d_ptr->characteristicList.constFind(data->handle);
+    if (charIt == d_ptr->characteristicList.constEnd())
+        return QLowEnergyCharacteristic::Unknown;
+
+    return charIt->properties;
 }
 
 /*!
@@ -177,11 +183,14 @@ QLowEnergyCharacteristic::PropertyTypes QLowEnergyCharacteristic::properties() c
 */
 QByteArray QLowEnergyCharacteristic::value() const
 {
-    if (d_ptr.isNull() || !data
-        || !d_ptr->characteristicList.contains(data->handle))
+    if (d_ptr.isNull() || !data)
+        return QByteArray();
+
+    const auto charIt = d_ptr->characteristicList.constFind(data->handle);
+    if (charIt == d_ptr->characteristicList.constEnd())
         return QByteArray();
 
-    return d_ptr->characteristicList[data->handle].value;
+    return charIt->value;
 }
 
 /*!
@@ -196,11 +205,14 @@ QByteArray QLowEnergyCharacteristic::value() const
 */
 QLowEnergyHandle QLowEnergyCharacteristic::handle() const
 {
-    if (d_ptr.isNull() || !data
-        || !d_ptr->characteristicList.contains(data->handle))
+    if (d_ptr.isNull() || !data)
+        return 0;
+
+    const auto charIt = d_ptr->characteristicList.constFind(data->handle);
+    if (charIt == d_ptr->characteristicList.constEnd())
         return 0;
 
-    return d_ptr->characteristicList[data->handle].valueHandle;
+    return charIt->valueHandle;
 }
 
 /*!
@@ -407,19 +419,18 @@ QList<QLowEnergyDescriptor> QLowEnergyCharacteristic::descriptors() const
 {
     QList<QLowEnergyDescriptor> result;
 
-    if (d_ptr.isNull() || !data
-                       || !d_ptr->characteristicList.contains(data->handle))
+    if (d_ptr.isNull() || !data)
         return result;
 
-    QList<QLowEnergyHandle> descriptorKeys = d_ptr->characteristicList[data->handle].
-                                                    descriptorList.keys();
-
-    std::sort(descriptorKeys.begin(), descriptorKeys.end());
+    const auto charIt = d_ptr->characteristicList.constFind(data->handle);
+    if (charIt == d_ptr->characteristicList.constEnd())
+        return result;
 
-    for (const QLowEnergyHandle descHandle : std::as_const(descriptorKeys)) {
-        QLowEnergyDescriptor descriptor(d_ptr, data->handle, descHandle);
-        result.append(descriptor);
-    }
+    // The descriptors are sorted by handle
+    const DescriptorDataMap &descriptorList = charIt->descriptorList;
+    result.reserve(descriptorList.size());
+    for (auto descIt = descriptorList.constBegin(); descIt != descriptorList.constEnd(); ++descIt)
+        result.append(QLowEnergyDescriptor(d_ptr, data->handle, descIt.key()));
 
     return result;
 }
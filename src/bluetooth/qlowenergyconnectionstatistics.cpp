@@ -0,0 +1,242 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qlowenergyconnectionstatistics.h"
+#include "qlowenergyconnectionstatistics_p.h"
+
+QT_BEGIN_NAMESPACE
+
+QT_IMPL_METATYPE_EXTERN(QLowEnergyConnectionStatistics)
+
+/*!
+    \since 6.9
+    \class QLowEnergyConnectionStatistics
+    \brief The QLowEnergyConnectionStatistics class is a snapshot of the GATT
+           traffic of a Bluetooth LE connection.
+
+    An object of this class is returned by
+    \l QLowEnergyController::statistics(). The counters start at zero whenever
+    the controller establishes a new connection, and are kept after the
+    connection was closed until the next one is established. Collecting them
+    does not depend on logging being enabled.
+
+    Requests are the ATT requests sent by a controller in the central role.
+    Their latency, which is the time from sending a request until its response
+    was received, is recorded in a histogram per ATT opcode. Backends which do
+    not use ATT directly record each GATT operation under the opcode of the
+    equivalent ATT request.
+
+    The statistics are only collected by the BlueZ backends on Linux. On other
+    platforms all values remain zero.
+
+    \inmodule QtBluetooth
+    \ingroup shared
+
+    \sa QLowEnergyController::statistics()
+*/
+
+/*!
+    \variable QLowEnergyConnectionStatistics::LatencyBucketCount
+
+    The number of buckets of each latency histogram.
+
+    \sa latencyHistogram(), latencyBucketLimit()
+*/
+
+/*!
+   Constructs a new object of this class with all counters set to zero.
+ */
+QLowEnergyConnectionStatistics::QLowEnergyConnectionStatistics()
+    : d(new QLowEnergyConnectionStatisticsPrivate)
+{
+}
+
+/*!
+    \internal
+    Constructs a snapshot owning \a dd.
+ */
+QLowEnergyConnectionStatistics::QLowEnergyConnectionStatistics(
+        QLowEnergyConnectionStatisticsPrivate *dd)
+    : d(dd)
+{
+}
+
+/*! Constructs a new object of this class that is a copy of \a other. */
+QLowEnergyConnectionStatistics::QLowEnergyConnectionStatistics(
+        const QLowEnergyConnectionStatistics &other)
+    : d(other.d)
+{
+}
+
+/*! Destroys this object. */
+QLowEnergyConnectionStatistics::~QLowEnergyConnectionStatistics()
+{
+}
+
+/*! Makes this object a copy of \a other and returns the new value of this object. */
+QLowEnergyConnectionStatistics &QLowEnergyConnectionStatistics::operator=(
+        const QLowEnergyConnectionStatistics &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+   Returns the number of ATT requests sent to the remote device.
+ */
+quint64 QLowEnergyConnectionStatistics::requestCount() const
+{
+    return d->requests;
+}
+
+/*!
+   Returns the number of ATT requests which were not answered within the
+   GATT request timeout of the controller.
+ */
+quint64 QLowEnergyConnectionStatistics::requestTimeoutCount() const
+{
+    return d->requestTimeouts;
+}
+
+/*!
+   Returns the number of ATT requests which the remote device answered with an
+   error.
+ */
+quint64 QLowEnergyConnectionStatistics::errorResponseCount() const
+{
+    return d->errorResponses;
+}
+
+/*!
+   Returns the number of requests which were queued or waiting for their
+   response when this snapshot was taken.
+
+   \sa maximumPendingRequestCount()
+ */
+int QLowEnergyConnectionStatistics::pendingRequestCount() const
+{
+    return d->pendingRequests;
+}
+
+/*!
+   Returns the largest number of queued requests seen when sending a request.
+   A growing queue indicates that the connection cannot keep up with the
+   requests of the application.
+
+   \sa pendingRequestCount()
+ */
+int QLowEnergyConnectionStatistics::maximumPendingRequestCount() const
+{
+    return d->maximumPendingRequests;
+}
+
+/*!
+   Returns the number of notifications and indications received in the central
+   role or sent in the peripheral role.
+
+   \sa notifiedBytes()
+ */
+quint64 QLowEnergyConnectionStatistics::notificationCount() const
+{
+    return d->notifications;
+}
+
+/*!
+   Returns the size of the values of the notifications and indications counted
+   by notificationCount().
+ */
+quint64 QLowEnergyConnectionStatistics::notifiedBytes() const
+{
+    return d->notifiedBytes;
+}
+
+/*!
+   Returns the number of characteristic and descriptor writes sent in the
+   central role or received in the peripheral role.
+
+   \sa writtenBytes()
+ */
+quint64 QLowEnergyConnectionStatistics::writeCount() const
+{
+    return d->writes;
+}
+
+/*!
+   Returns the size of the values of the writes counted by writeCount().
+ */
+quint64 QLowEnergyConnectionStatistics::writtenBytes() const
+{
+    return d->writtenBytes;
+}
+
+/*!
+   Returns how often the MTU of the connection was negotiated.
+ */
+quint64 QLowEnergyConnectionStatistics::mtuExchangeCount() const
+{
+    return d->mtuExchanges;
+}
+
+/*!
+   Returns how often the encryption of the link was changed to fulfill the
+   security requirements of an attribute.
+ */
+quint64 QLowEnergyConnectionStatistics::encryptionChangeCount() const
+{
+    return d->encryptionChanges;
+}
+
+/*!
+   Returns the ATT opcodes of the requests for which latencies were recorded,
+   in ascending order.
+
+   \sa latencyHistogram()
+ */
+QList<quint8> QLowEnergyConnectionStatistics::latencyOpcodes() const
+{
+    return d->latencies.keys();
+}
+
+/*!
+   Returns the latency histogram of the requests with the ATT opcode
+   \a attOpcode, for example \c 0x0a for read requests and \c 0x12 for write
+   requests.
+
+   The returned list has \l LatencyBucketCount entries. The entry at index \c n
+   counts the requests whose latency was below latencyBucketLimit(\c n) and,
+   for \c n greater than zero, not below latencyBucketLimit(\c{n - 1}). The
+   list is empty if no latency was recorded for \a attOpcode.
+
+   \sa latencyOpcodes()
+ */
+QList<quint64> QLowEnergyConnectionStatistics::latencyHistogram(quint8 attOpcode) const
+{
+    const auto it = d->latencies.constFind(attOpcode);
+    if (it == d->latencies.cend())
+        return {};
+    return QList<quint64>(it->cbegin(), it->cend());
+}
+
+/*!
+   Returns the exclusive upper limit of the latency histogram bucket
+   \a bucket. The limit doubles from one bucket to the next, starting at one
+   millisecond. The last bucket has no upper limit, and
+   \c{std::chrono::milliseconds::max()} is returned for it.
+
+   \sa latencyHistogram()
+ */
+std::chrono::milliseconds QLowEnergyConnectionStatistics::latencyBucketLimit(int bucket)
+{
+    if (bucket < 0)
+        return std::chrono::milliseconds(0);
+    if (bucket >= LatencyBucketCount - 1)
+        return std::chrono::milliseconds::max();
+    return std::chrono::milliseconds(1LL << bucket);
+}
+
+/*!
+   \fn void QLowEnergyConnectionStatistics::swap(QLowEnergyConnectionStatistics &other)
+   Swaps this object with \a other.
+ */
+
+QT_END_NAMESPACE
@@ -0,0 +1,61 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QLOWENERGYCONNECTIONSTATISTICS_H
+#define QLOWENERGYCONNECTIONSTATISTICS_H
+
+#include <QtBluetooth/qtbluetoothglobal.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmetatype.h>
+#include <QtCore/qshareddata.h>
+
+#include <chrono>
+
+QT_BEGIN_NAMESPACE
+
+class QLowEnergyConnectionStatisticsPrivate;
+
+class Q_BLUETOOTH_EXPORT QLowEnergyConnectionStatistics
+{
+public:
+    static constexpr int LatencyBucketCount = 12;
+
+    QLowEnergyConnectionStatistics();
+    QLowEnergyConnectionStatistics(const QLowEnergyConnectionStatistics &other);
+    ~QLowEnergyConnectionStatistics();
+
+    QLowEnergyConnectionStatistics &operator=(const QLowEnergyConnectionStatistics &other);
+
+    quint64 requestCount() const;
+    quint64 requestTimeoutCount() const;
+    quint64 errorResponseCount() const;
+    int pendingRequestCount() const;
+    int maximumPendingRequestCount() const;
+
+    quint64 notificationCount() const;
+    quint64 notifiedBytes() const;
+    quint64 writeCount() const;
+    quint64 writtenBytes() const;
+
+    quint64 mtuExchangeCount() const;
+    quint64 encryptionChangeCount() const;
+
+    QList<quint8> latencyOpcodes() const;
+    QList<quint64> latencyHistogram(quint8 attOpcode) const;
+    static std::chrono::milliseconds latencyBucketLimit(int bucket);
+
+    void swap(QLowEnergyConnectionStatistics &other) noexcept { d.swap(other.d); }
+
+private:
+    friend class QLowEnergyController;
+    explicit QLowEnergyConnectionStatistics(QLowEnergyConnectionStatisticsPrivate *dd);
+    QSharedDataPointer<QLowEnergyConnectionStatisticsPrivate> d;
+};
+
+Q_DECLARE_SHARED(QLowEnergyConnectionStatistics)
+
+QT_END_NAMESPACE
+
+QT_DECL_METATYPE_EXTERN(QLowEnergyConnectionStatistics, Q_BLUETOOTH_EXPORT)
+
+#endif // Include guard
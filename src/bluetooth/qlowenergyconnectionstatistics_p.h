@@ -0,0 +1,91 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QLOWENERGYCONNECTIONSTATISTICS_P_H
+#define QLOWENERGYCONNECTIONSTATISTICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qlowenergyconnectionstatistics.h"
+
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qmap.h>
+
+#include <array>
+
+QT_BEGIN_NAMESPACE
+
+// The counters of a connection, updated by the backends
+class QLowEnergyConnectionStatisticsPrivate : public QSharedData
+{
+public:
+    using LatencyHistogram = std::array<quint64, QLowEnergyConnectionStatistics::LatencyBucketCount>;
+
+    void recordRequest(qsizetype queuedRequests)
+    {
+        ++requests;
+        maximumPendingRequests = qMax(maximumPendingRequests, int(queuedRequests));
+    }
+
+    void recordLatency(quint8 opcode, qint64 nsecs)
+    {
+        // Bucket n > 0 holds latencies in [2^(n-1), 2^n) milliseconds
+        const quint64 msecs = quint64(qMax(nsecs, qint64(0))) / 1000000;
+        const int bucket = msecs == 0
+                ? 0
+                : qMin(64 - int(qCountLeadingZeroBits(msecs)),
+                       QLowEnergyConnectionStatistics::LatencyBucketCount - 1);
+        auto it = latencies.find(opcode);
+        if (it == latencies.end())
+            it = latencies.insert(opcode, LatencyHistogram{});
+        ++(*it)[bucket];
+    }
+
+    void recordNotification(qsizetype size)
+    {
+        ++notifications;
+        notifiedBytes += quint64(size);
+    }
+
+    void recordWrite(qsizetype size)
+    {
+        ++writes;
+        writtenBytes += quint64(size);
+    }
+
+    void reset()
+    {
+        // QSharedData cannot be assigned
+        requests = requestTimeouts = errorResponses = 0;
+        pendingRequests = maximumPendingRequests = 0;
+        notifications = notifiedBytes = writes = writtenBytes = 0;
+        mtuExchanges = encryptionChanges = 0;
+        latencies.clear();
+    }
+
+    quint64 requests = 0;
+    quint64 requestTimeouts = 0;
+    quint64 errorResponses = 0;
+    int pendingRequests = 0;
+    int maximumPendingRequests = 0;
+    quint64 notifications = 0;
+    quint64 notifiedBytes = 0;
+    quint64 writes = 0;
+    quint64 writtenBytes = 0;
+    quint64 mtuExchanges = 0;
+    quint64 encryptionChanges = 0;
+    QMap<quint8, LatencyHistogram> latencies;
+};
+
+QT_END_NAMESPACE
+
+#endif // QLOWENERGYCONNECTIONSTATISTICS_P_H
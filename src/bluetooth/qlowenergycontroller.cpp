@@ -38,6 +38,9 @@ QT_IMPL_METATYPE_EXTERN_TAGGED(QLowEnergyController::ControllerState,
 QT_IMPL_METATYPE_EXTERN_TAGGED(QLowEnergyController::RemoteAddressType,
                                QLowEnergyController__RemoteAddressType)
 QT_IMPL_METATYPE_EXTERN_TAGGED(QLowEnergyController::Role, QLowEnergyController__Role)
+QT_IMPL_METATYPE_EXTERN_TAGGED(QLowEnergyController::LinkProfile,
+                               QLowEnergyController__LinkProfile)
+QT_IMPL_METATYPE_EXTERN_TAGGED(QLowEnergyController::Phy, QLowEnergyController__Phy)
 
 Q_DECLARE_LOGGING_CATEGORY(QT_BT)
 #if defined(QT_ANDROID_BLUETOOTH)
@@ -186,6 +189,41 @@ Q_DECLARE_LOGGING_CATEGORY(QT_BT_ANDROID)
          or newer.
  */
 
+/*!
+    \enum QLowEnergyController::LinkProfile
+
+    Describes a set of link layer settings which is applied to a connection.
+
+    \value DefaultLinkProfile
+       The link settings chosen by the platform are kept. This is the default.
+    \value LowLatencyLinkProfile
+       Short connection intervals without peripheral latency. Where supported,
+       the maximum data length and the LE 2M PHY are requested as well.
+    \value HighThroughputLinkProfile
+       Connection intervals suitable for bulk transfers. Where supported,
+       the maximum data length and the LE 2M PHY are requested as well.
+    \value PowerSavingLinkProfile
+       Long connection intervals with peripheral latency, reducing the number of
+       radio events at the expense of latency.
+
+    \sa setLinkProfile()
+    \since 6.9
+ */
+
+/*!
+    \enum QLowEnergyController::Phy
+
+    Describes the physical layer used by a connection.
+
+    \value UnknownPhy The physical layer is not known.
+    \value Le1MPhy    The LE 1M physical layer.
+    \value Le2MPhy    The LE 2M physical layer.
+    \value LeCodedPhy The LE Coded physical layer.
+
+    \sa phyChanged()
+    \since 6.9
+ */
+
 
 /*!
     \fn void QLowEnergyController::connected()
@@ -290,6 +328,29 @@ Q_DECLARE_LOGGING_CATEGORY(QT_BT_ANDROID)
     \sa requestConnectionUpdate()
 */
 
+/*!
+    \fn void QLowEnergyController::dataLengthChanged(int maxTxOctets, int maxRxOctets)
+
+    This signal is emitted when the maximum link layer payload size of the connection
+    changes, for example as a result of \l setLinkProfile(). \a maxTxOctets and
+    \a maxRxOctets are the new maximum payload sizes in bytes for the sending and
+    receiving direction.
+
+    \since 6.9
+    \sa setLinkProfile()
+*/
+
+/*!
+    \fn void QLowEnergyController::phyChanged(QLowEnergyController::Phy txPhy, QLowEnergyController::Phy rxPhy)
+
+    This signal is emitted when the physical layer of the connection changes, for example
+    as a result of \l setLinkProfile(). \a txPhy and \a rxPhy are the physical layers now
+    used for the sending and receiving direction.
+
+    \since 6.9
+    \sa setLinkProfile()
+*/
+
 
 void registerQLowEnergyControllerMetaType()
 {
@@ -297,6 +358,7 @@ void registerQLowEnergyControllerMetaType()
     if (!initDone) {
         qRegisterMetaType<QLowEnergyController::ControllerState>();
         qRegisterMetaType<QLowEnergyController::Error>();
+        qRegisterMetaType<QLowEnergyController::Phy>();
         qRegisterMetaType<QLowEnergyConnectionParameters>();
         qRegisterMetaType<QLowEnergyCharacteristic>();
         qRegisterMetaType<QLowEnergyDescriptor>();
@@ -768,7 +830,24 @@ QLowEnergyService *QLowEnergyController::createServiceObject(
    all advertisement data is recommended to set in the main \a advertisingData parameter. If both
    advertisement and scan response data is set, the scan response data is given precedence.
 
+   On the BlueZ kernel backend, several controllers using the same local adapter may advertise
+   at the same time. If the adapter supports LE extended advertising, each controller is given
+   its own advertising set with its own interval. Otherwise the adapter's single advertising
+   instance is shared by switching between the advertisements at regular intervals.
+
    If this object is currently not in the \l UnconnectedState, nothing happens.
+   As an exception, since Qt 6.9 a controller of the BlueZ kernel backend may
+   call this function in the \l ConnectedState to accept a connection from
+   another central device. All centrals share the services of the controller,
+   while the MTU, client characteristic configurations and queued writes are
+   kept per connection. Notifications and indications are only sent to the
+   centrals which enabled them. The \l connected() signal is emitted for each
+   central, and the controller stays in the \l ConnectedState until the last
+   one has disconnected. \l remoteAddress(), \l remoteName() and \l mtu()
+   refer to the central which has been connected the longest. The values of
+   the local client characteristic configuration descriptors keep their
+   defaults, the configuration written by a central only applies to that
+   central.
 
    \since 5.7
    \sa stopAdvertising()
@@ -782,7 +861,8 @@ void QLowEnergyController::startAdvertising(const QLowEnergyAdvertisingParameter
         qCWarning(QT_BT) << "Cannot start advertising in central role" << state();
         return;
     }
-    if (state() != UnconnectedState) {
+    if (state() != UnconnectedState
+            && !(state() == ConnectedState && d->canAdvertiseWhileConnected())) {
         qCWarning(QT_BT) << "Cannot start advertising in state" << state();
         return;
     }
@@ -791,6 +871,8 @@ void QLowEnergyController::startAdvertising(const QLowEnergyAdvertisingParameter
 
 /*!
    Stops advertising, if this object is currently in the advertising state.
+   A connected controller which started advertising again to accept further
+   centrals stops doing so, but stays connected.
 
    The controller has to be in the \l PeripheralRole for this function to work.
    It does not invalidate services which have previously been added via \l addService().
@@ -801,7 +883,8 @@ void QLowEnergyController::startAdvertising(const QLowEnergyAdvertisingParameter
 void QLowEnergyController::stopAdvertising()
 {
     Q_D(QLowEnergyController);
-    if (state() != AdvertisingState) {
+    if (state() != AdvertisingState
+            && !(state() == ConnectedState && d->canAdvertiseWhileConnected())) {
         qCDebug(QT_BT) << "stopAdvertising called in state" << state();
         return;
     }
@@ -889,6 +972,60 @@ void QLowEnergyController::requestConnectionUpdate(const QLowEnergyConnectionPar
     }
 }
 
+/*!
+  Sets the link profile of the controller to \a profile.
+
+  The profile is applied each time a connection is established. If the controller is
+  already connected, the profile is applied to the current connection right away.
+  Applying a profile requests connection parameters matching the profile,
+  as if \l requestConnectionUpdate() had been called. On the Linux kernel backend the
+  maximum link layer data length and the LE 2M PHY are requested as well for the
+  \l LowLatencyLinkProfile and the \l HighThroughputLinkProfile, which can increase
+  the throughput of bulk transfers considerably.
+
+  The values that were actually negotiated are reported by the \l connectionUpdated(),
+  \l dataLengthChanged(), \l phyChanged() and \l mtuChanged() signals. The remote
+  device and the local Bluetooth controller may not support all of the requested
+  settings.
+
+  Setting the \l DefaultLinkProfile does not revert settings that were already applied
+  to the current connection.
+
+  \note Currently, this functionality is only implemented on Linux kernel backend and Android.
+
+  \sa linkProfile(), requestConnectionUpdate()
+  \since 6.9
+ */
+void QLowEnergyController::setLinkProfile(LinkProfile profile)
+{
+    Q_D(QLowEnergyController);
+    if (d->linkProfile == profile)
+        return;
+
+    d->linkProfile = profile;
+    switch (state()) {
+    case ConnectedState:
+    case DiscoveredState:
+    case DiscoveringState:
+        d->applyLinkProfile();
+        break;
+    default:
+        break;
+    }
+}
+
+/*!
+  Returns the link profile of the controller.
+
+  \sa setLinkProfile()
+  \since 6.9
+ */
+QLowEnergyController::LinkProfile QLowEnergyController::linkProfile() const
+{
+    Q_D(const QLowEnergyController);
+    return d->linkProfile;
+}
+
 /*!
     Returns the last occurred error or \l NoError.
 */
@@ -946,6 +1083,28 @@ int QLowEnergyController::mtu() const
     return d_ptr->mtu();
 }
 
+/*!
+   Returns a snapshot of the statistics of the current connection, or of the
+   last connection if the controller is not connected.
+
+   The statistics include the number of requests, timeouts and error
+   responses, the length of the request queue, the amount of notified and
+   written data and the request latencies. They are collected independently
+   of logging and can be used to detect a degrading link.
+
+   \note The statistics are only collected by the BlueZ backends on Linux.
+
+   \since 6.9
+   \sa QLowEnergyConnectionStatistics
+ */
+QLowEnergyConnectionStatistics QLowEnergyController::statistics() const
+{
+    Q_D(const QLowEnergyController);
+    auto snapshot = new QLowEnergyConnectionStatisticsPrivate(d->statistics);
+    snapshot->pendingRequests = d->pendingRequestCount();
+    return QLowEnergyConnectionStatistics(snapshot);
+}
+
 /*!
     readRssi() reads RSSI (received signal strength indicator) for a connected remote device.
     If the read was successful, the RSSI is then reported by rssiRead() signal.
@@ -10,6 +10,7 @@
 #include <QtBluetooth/QBluetoothUuid>
 #include <QtBluetooth/QLowEnergyAdvertisingData>
 #include <QtBluetooth/QLowEnergyConnectionParameters>
+#include <QtBluetooth/QLowEnergyConnectionStatistics>
 #include <QtBluetooth/QLowEnergyService>
 
 QT_BEGIN_NAMESPACE
@@ -57,6 +58,22 @@ public:
     enum Role { CentralRole, PeripheralRole };
     Q_ENUM(Role)
 
+    enum LinkProfile {
+        DefaultLinkProfile = 0,
+        LowLatencyLinkProfile,
+        HighThroughputLinkProfile,
+        PowerSavingLinkProfile
+    };
+    Q_ENUM(LinkProfile)
+
+    enum Phy {
+        UnknownPhy = 0,
+        Le1MPhy,
+        Le2MPhy,
+        LeCodedPhy
+    };
+    Q_ENUM(Phy)
+
     static QLowEnergyController *createCentral(const QBluetoothDeviceInfo &remoteDevice,
                                                QObject *parent = nullptr);
     static QLowEnergyController *createCentral(const QBluetoothDeviceInfo &remoteDevice,
@@ -98,6 +115,9 @@ public:
 
     void requestConnectionUpdate(const QLowEnergyConnectionParameters &parameters);
 
+    void setLinkProfile(LinkProfile profile);
+    LinkProfile linkProfile() const;
+
     Error error() const;
     QString errorString() const;
 
@@ -106,6 +126,8 @@ public:
     int mtu() const;
     void readRssi();
 
+    QLowEnergyConnectionStatistics statistics() const;
+
 Q_SIGNALS:
     void connected();
     void disconnected();
@@ -117,6 +139,8 @@ Q_SIGNALS:
     void serviceDiscovered(const QBluetoothUuid &newService);
     void discoveryFinished();
     void connectionUpdated(const QLowEnergyConnectionParameters &parameters);
+    void dataLengthChanged(int maxTxOctets, int maxRxOctets);
+    void phyChanged(QLowEnergyController::Phy txPhy, QLowEnergyController::Phy rxPhy);
 
 
 private:
@@ -145,5 +169,10 @@ QT_DECL_METATYPE_EXTERN_TAGGED(QLowEnergyController::RemoteAddressType,
                                Q_BLUETOOTH_EXPORT)
 QT_DECL_METATYPE_EXTERN_TAGGED(QLowEnergyController::Role, QLowEnergyController__Role,
                                Q_BLUETOOTH_EXPORT)
+QT_DECL_METATYPE_EXTERN_TAGGED(QLowEnergyController::LinkProfile,
+                               QLowEnergyController__LinkProfile,
+                               Q_BLUETOOTH_EXPORT)
+QT_DECL_METATYPE_EXTERN_TAGGED(QLowEnergyController::Phy, QLowEnergyController__Phy,
+                               Q_BLUETOOTH_EXPORT)
 
 #endif // QLOWENERGYCONTROLLER_H
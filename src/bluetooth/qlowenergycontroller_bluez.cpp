@@ -7,6 +7,7 @@
 #include "qbluetoothsocketbase_p.h"
 #include "qbluetoothsocket_bluez_p.h"
 #include "qleadvertiser_bluez_p.h"
+#include "qleattreceiver_bluez_p.h"
 #include "bluez/bluez_data_p.h"
 #include "bluez/hcimanager_p.h"
 #include "bluez/objectmanager_p.h"
@@ -16,6 +17,8 @@
 
 #include <QtCore/QFileInfo>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QPointer>
+#include <QtCore/QScopeGuard>
 #include <QtCore/QSettings>
 #include <QtCore/QTimer>
 #include <QtBluetooth/QBluetoothLocalDevice>
@@ -25,9 +28,12 @@
 #include <QtBluetooth/QLowEnergyService>
 #include <QtBluetooth/QLowEnergyServiceData>
 
+#include <qtbluetooth_tracepoints_p.h>
+
 #include <algorithm>
 #include <climits>
 #include <cstring>
+#include <utility>
 #include <errno.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -158,11 +164,20 @@ template<> void putDataAndIncrement(const QByteArray &value, char *&dst)
     dst += value.size();
 }
 
+// Stops reading the socket of receiver, which must be done before closing it
+static void stopAttReceiver(QLeAttReceiver *&receiver)
+{
+    if (!receiver)
+        return;
+    receiver->stop();
+    receiver->deleteLater();
+    receiver = nullptr;
+}
+
 QLowEnergyControllerPrivateBluez::QLowEnergyControllerPrivateBluez()
     : QLowEnergyControllerPrivate(),
       requestPending(false),
       mtuSize(ATT_DEFAULT_LE_MTU),
-      securityLevelValue(-1),
       encryptionChangePending(false)
 {
     registerQLowEnergyControllerMetaType();
@@ -185,27 +200,56 @@ void QLowEnergyControllerPrivateBluez::init()
     hciManager->monitorEvent(HciManager::HciEvent::EVT_LE_META_EVENT);
     hciManager->monitorAclPackets();
     connect(hciManager.get(), &HciManager::connectionComplete, this, [this](quint16 handle) {
-        connectionHandle = handle;
+        // In the peripheral role, the connection belongs to the next accepted central
+        if (role == QLowEnergyController::PeripheralRole)
+            incomingConnectionHandle = handle;
+        else
+            connectionHandle = handle;
         qCDebug(QT_BT_BLUEZ) << "received connection complete event, handle:" << handle;
+        if (linkProfilePending && role == QLowEnergyController::CentralRole)
+            applyLinkProfile();
     });
     connect(hciManager.get(), &HciManager::connectionUpdate, this,
             [this](quint16 handle, const QLowEnergyConnectionParameters &params) {
-                if (handle == connectionHandle)
+                if (ownsConnectionHandle(handle))
                     emit q_ptr->connectionUpdated(params);
             }
     );
+    connect(hciManager.get(), &HciManager::dataLengthChanged, this,
+            [this](quint16 handle, quint16 maxTxOctets, quint16 maxRxOctets) {
+                if (ownsConnectionHandle(handle))
+                    emit q_ptr->dataLengthChanged(maxTxOctets, maxRxOctets);
+            }
+    );
+    connect(hciManager.get(), &HciManager::phyUpdated, this,
+            [this](quint16 handle, quint8 txPhy, quint8 rxPhy) {
+                // The HCI PHY values match the QLowEnergyController::Phy enum
+                if (ownsConnectionHandle(handle))
+                    emit q_ptr->phyChanged(QLowEnergyController::Phy(txPhy),
+                                           QLowEnergyController::Phy(rxPhy));
+            }
+    );
     connect(hciManager.get(), &HciManager::signatureResolvingKeyReceived, this,
             [this](quint16 handle, bool remoteKey, const QUuid::Id128Bytes &csrk) {
-                if (handle != connectionHandle)
-                    return;
                 if ((remoteKey && role == QLowEnergyController::CentralRole)
                         || (!remoteKey && role == QLowEnergyController::PeripheralRole)) {
                     return;
                 }
+                QBluetoothAddress address;
+                if (role == QLowEnergyController::CentralRole) {
+                    if (handle != connectionHandle)
+                        return;
+                    address = remoteDevice;
+                } else {
+                    const ServerSession *const session = sessionForHandle(handle);
+                    if (!session)
+                        return;
+                    address = session->remoteDevice;
+                }
                 qCDebug(QT_BT_BLUEZ) << "received new signature resolving key"
                                      << QByteArray(reinterpret_cast<const char *>(csrk.data),
                                                    sizeof csrk).toHex();
-                signingData.insert(remoteDevice.toUInt64(), SigningData(csrk));
+                signingData.insert(address.toUInt64(), SigningData(csrk));
         }
     );
 
@@ -231,6 +275,14 @@ void QLowEnergyControllerPrivateBluez::init()
 
 void QLowEnergyControllerPrivateBluez::handleGattRequestTimeout()
 {
+    // The I/O thread may have received the response while this thread was busy
+    if (!sessions.empty() && sessions.front()->attReceiver
+            && sessions.front()->attReceiver->hasPackets()) {
+        processReceivedPackets(*sessions.front());
+        if (!requestPending || requestTimer->isActive())
+            return;
+    }
+
     // antyhing open that might require cancellation or a warning?
     if (encryptionChangePending) {
         // We cannot really recover for now but the warning is essential for debugging
@@ -241,6 +293,8 @@ void QLowEnergyControllerPrivateBluez::handleGattRequestTimeout()
     if (!openRequests.isEmpty() && requestPending) {
         const Request currentRequest = openRequests.dequeue();
         requestPending = false; // reset pending flag
+        requestElapsedTimer.invalidate();
+        ++statistics.requestTimeouts;
 
         qCWarning(QT_BT_BLUEZ).nospace() << "****** Request type 0x" << currentRequest.command
                                          << " to server/peripheral timed out";
@@ -315,6 +369,8 @@ void QLowEnergyControllerPrivateBluez::handleGattRequestTimeout()
 
 QLowEnergyControllerPrivateBluez::~QLowEnergyControllerPrivateBluez()
 {
+    for (const auto &session : sessions)
+        stopAttReceiver(session->attReceiver);
     closeServerSocket();
     delete cmacCalculator;
     cmacCalculator = nullptr;
@@ -381,7 +437,10 @@ void QLowEnergyControllerPrivateBluez::startAdvertising(const QLowEnergyAdvertis
         connect(advertiser, &QLeAdvertiser::errorOccurred, this,
                 &QLowEnergyControllerPrivateBluez::handleAdvertisingError);
     }
-    setState(QLowEnergyController::AdvertisingState);
+    // A connected peripheral keeps serving its centrals while accepting another one
+    const bool isConnected = state == QLowEnergyController::ConnectedState;
+    if (!isConnected)
+        setState(QLowEnergyController::AdvertisingState);
     advertiser->startAdvertising();
     if (params.mode() == QLowEnergyAdvertisingParameters::AdvNonConnInd
             || params.mode() == QLowEnergyAdvertisingParameters::AdvScanInd) {
@@ -390,10 +449,14 @@ void QLowEnergyControllerPrivateBluez::startAdvertising(const QLowEnergyAdvertis
         return;
     }
 
+    closeServerSocket();
     ServerSocket serverSocket;
     if (!serverSocket.listen(localAdapter)) {
         setError(QLowEnergyController::AdvertisingError);
-        setState(QLowEnergyController::UnconnectedState);
+        if (isConnected)
+            advertiser->stopAdvertising();
+        else
+            setState(QLowEnergyController::UnconnectedState);
         return;
     }
 
@@ -405,8 +468,12 @@ void QLowEnergyControllerPrivateBluez::startAdvertising(const QLowEnergyAdvertis
 
 void QLowEnergyControllerPrivateBluez::stopAdvertising()
 {
-    setState(QLowEnergyController::UnconnectedState);
-    advertiser->stopAdvertising();
+    if (state == QLowEnergyController::ConnectedState)
+        closeServerSocket();
+    else
+        setState(QLowEnergyController::UnconnectedState);
+    if (advertiser)
+        advertiser->stopAdvertising();
 }
 
 void QLowEnergyControllerPrivateBluez::requestConnectionUpdate(const QLowEnergyConnectionParameters &params)
@@ -415,10 +482,12 @@ void QLowEnergyControllerPrivateBluez::requestConnectionUpdate(const QLowEnergyC
     // devices, but BlueZ allows it only for master devices. So for slave devices, we have to use a
     // connection parameter update request, which we need to wrap in an ACL command, as BlueZ
     // does not allow user-space sockets for the signaling channel.
-    if (role == QLowEnergyController::CentralRole)
+    if (role == QLowEnergyController::CentralRole) {
         hciManager->sendConnectionUpdateCommand(connectionHandle, params);
-    else
-        hciManager->sendConnectionParameterUpdateRequest(connectionHandle, params);
+    } else {
+        for (const auto &session : std::as_const(sessions))
+            hciManager->sendConnectionParameterUpdateRequest(session->connectionHandle, params);
+    }
 }
 
 void QLowEnergyControllerPrivateBluez::connectToDevice()
@@ -542,7 +611,7 @@ void QLowEnergyControllerPrivateBluez::establishL2cpClientSocket()
     // Unbuffered mode required to separate each GATT packet
     l2cpSocket->connectToService(remoteDevice, ATTRIBUTE_CHANNEL_ID,
                                  QIODevice::ReadWrite | QIODevice::Unbuffered);
-    loadSigningDataIfNecessary(LocalSigningKey);
+    loadSigningDataIfNecessary(LocalSigningKey, remoteDevice);
 }
 
 void QLowEnergyControllerPrivateBluez::createServicesForCentralIfRequired()
@@ -615,7 +684,9 @@ void QLowEnergyControllerPrivateBluez::l2cpConnected()
 {
     Q_Q(QLowEnergyController);
 
-    securityLevelValue = securityLevel();
+    ServerSession &session = addSession(l2cpSocket, remoteDevice);
+    refreshLinkState(session);
+    startAttReceiver(session);
     exchangeMTU();
 
     setState(QLowEnergyController::ConnectedState);
@@ -625,13 +696,21 @@ void QLowEnergyControllerPrivateBluez::l2cpConnected()
 void QLowEnergyControllerPrivateBluez::disconnectFromDevice()
 {
     setState(QLowEnergyController::ClosingState);
-    if (l2cpSocket)
-        l2cpSocket->close();
+    // Only the last connection of a peripheral is closed the usual way
+    while (sessions.size() > 1)
+        closeSession(sessions.back().get());
+    QBluetoothSocket *socket = l2cpSocket;
+    if (!sessions.empty()) {
+        stopAttReceiver(sessions.front()->attReceiver);
+        socket = sessions.front()->socket;
+    }
+    if (socket)
+        socket->close();
     resetController();
 
     // this may happen when RemoteDeviceManager::JobType::JobDisconnectDevice
     // is pending.
-    if (!l2cpSocket) {
+    if (!socket) {
         qWarning(QT_BT_BLUEZ) << "Unexpected closure of device. Cleaning up internal states.";
         l2cpDisconnected();
     }
@@ -642,7 +721,8 @@ void QLowEnergyControllerPrivateBluez::l2cpDisconnected()
     Q_Q(QLowEnergyController);
 
     if (role == QLowEnergyController::PeripheralRole) {
-        storeClientConfigurations();
+        for (const auto &session : std::as_const(sessions))
+            storeClientConfigurations(*session);
         remoteDevice.clear();
         remoteName.clear();
     }
@@ -654,6 +734,16 @@ void QLowEnergyControllerPrivateBluez::l2cpDisconnected()
 
 void QLowEnergyControllerPrivateBluez::l2cpErrorChanged(QBluetoothSocket::SocketError e)
 {
+    if (sessionsInUse > 0) {
+        // A failed write reports the error synchronously, the session must
+        // outlive the code that wrote to it
+        QMetaObject::invokeMethod(this, [this, e]() {
+            if (state != QLowEnergyController::UnconnectedState)
+                l2cpErrorChanged(e);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
     switch (e) {
     case QBluetoothSocket::SocketError::HostNotFoundError:
         setError(QLowEnergyController::UnknownRemoteDeviceError);
@@ -674,7 +764,8 @@ void QLowEnergyControllerPrivateBluez::l2cpErrorChanged(QBluetoothSocket::Socket
     default:
         // these errors shouldn't happen -> as it means
         // the code in this file has bugs
-        qCDebug(QT_BT_BLUEZ) << "Unknown l2cp socket error: " << e << l2cpSocket->errorString();
+        qCDebug(QT_BT_BLUEZ) << "Unknown l2cp socket error: " << e
+                             << (l2cpSocket ? l2cpSocket->errorString() : QString());
         setError(QLowEnergyController::UnknownError);
         break;
     }
@@ -688,15 +779,14 @@ void QLowEnergyControllerPrivateBluez::l2cpErrorChanged(QBluetoothSocket::Socket
 void QLowEnergyControllerPrivateBluez::resetController()
 {
     openRequests.clear();
-    openPrepareWriteRequests.clear();
-    scheduledIndications.clear();
-    indicationInFlight = false;
     requestPending = false;
     encryptionChangePending = false;
-    receivedMtuExchangeRequest = false;
     mtuSize = ATT_DEFAULT_LE_MTU;
-    securityLevelValue = -1;
     connectionHandle = 0;
+    linkProfilePending = false;
+    const auto releasedSessions = std::exchange(sessions, {});
+    for (const auto &session : releasedSessions)
+        releaseSession(*session);
 
     if (role == QLowEnergyController::PeripheralRole) {
         // public API behavior requires stop of advertisement
@@ -706,6 +796,7 @@ void QLowEnergyControllerPrivateBluez::resetController()
             advertiser = nullptr;
         }
         localAttributes.clear();
+        clientConfigDefaults.clear();
     }
 }
 
@@ -720,17 +811,32 @@ void QLowEnergyControllerPrivateBluez::restartRequestTimer()
 
 void QLowEnergyControllerPrivateBluez::l2cpReadyRead()
 {
-    const QByteArray incomingPacket = l2cpSocket->readAll();
+    if (!sessions.empty())
+        processPacket(*sessions.front(), l2cpSocket->readAll(), 0);
+}
+
+/*
+    Handles \a incomingPacket of \a session, which was received \a queuedNsecs
+    nanoseconds ago by the ATT I/O thread.
+*/
+void QLowEnergyControllerPrivateBluez::processPacket(ServerSession &session,
+                                                     QByteArray incomingPacket,
+                                                     qint64 queuedNsecs)
+{
     qCDebug(QT_BT_BLUEZ) << "Received size:" << incomingPacket.size() << "data:"
                          << incomingPacket.toHex();
     if (incomingPacket.isEmpty())
         return;
 
+    // Keeps session alive if answering the packet fails
+    ++sessionsInUse;
+    const auto inUse = qScopeGuard([this]() { --sessionsInUse; });
+
     const QBluezConst::AttCommand command =
             static_cast<QBluezConst::AttCommand>(incomingPacket.constData()[0]);
     switch (command) {
     case QBluezConst::AttCommand::ATT_OP_HANDLE_VAL_NOTIFICATION: {
-        processUnsolicitedReply(incomingPacket);
+        processUnsolicitedReply(std::move(incomingPacket));
         return;
     }
     case QBluezConst::AttCommand::ATT_OP_HANDLE_VAL_INDICATION: {
@@ -739,50 +845,50 @@ void QLowEnergyControllerPrivateBluez::l2cpReadyRead()
         packet.append(static_cast<quint8>(QBluezConst::AttCommand::ATT_OP_HANDLE_VAL_CONFIRMATION));
         sendPacket(packet);
 
-        processUnsolicitedReply(incomingPacket);
+        processUnsolicitedReply(std::move(incomingPacket));
         return;
     }
     //--------------------------------------------------
     // Peripheral side packet handling
     case QBluezConst::AttCommand::ATT_OP_EXCHANGE_MTU_REQUEST:
-        handleExchangeMtuRequest(incomingPacket);
+        handleExchangeMtuRequest(session, incomingPacket);
         return;
     case QBluezConst::AttCommand::ATT_OP_FIND_INFORMATION_REQUEST:
-        handleFindInformationRequest(incomingPacket);
+        handleFindInformationRequest(session, incomingPacket);
         return;
     case QBluezConst::AttCommand::ATT_OP_FIND_BY_TYPE_VALUE_REQUEST:
-        handleFindByTypeValueRequest(incomingPacket);
+        handleFindByTypeValueRequest(session, incomingPacket);
         return;
     case QBluezConst::AttCommand::ATT_OP_READ_BY_TYPE_REQUEST:
-        handleReadByTypeRequest(incomingPacket);
+        handleReadByTypeRequest(session, incomingPacket);
         return;
     case QBluezConst::AttCommand::ATT_OP_READ_REQUEST:
-        handleReadRequest(incomingPacket);
+        handleReadRequest(session, incomingPacket);
         return;
     case QBluezConst::AttCommand::ATT_OP_READ_BLOB_REQUEST:
-        handleReadBlobRequest(incomingPacket);
+        handleReadBlobRequest(session, incomingPacket);
         return;
     case QBluezConst::AttCommand::ATT_OP_READ_MULTIPLE_REQUEST:
-        handleReadMultipleRequest(incomingPacket);
+        handleReadMultipleRequest(session, incomingPacket);
         return;
     case QBluezConst::AttCommand::ATT_OP_READ_BY_GROUP_REQUEST:
-        handleReadByGroupTypeRequest(incomingPacket);
+        handleReadByGroupTypeRequest(session, incomingPacket);
         return;
     case QBluezConst::AttCommand::ATT_OP_WRITE_REQUEST:
     case QBluezConst::AttCommand::ATT_OP_WRITE_COMMAND:
     case QBluezConst::AttCommand::ATT_OP_SIGNED_WRITE_COMMAND:
-        handleWriteRequestOrCommand(incomingPacket);
+        handleWriteRequestOrCommand(session, incomingPacket);
         return;
     case QBluezConst::AttCommand::ATT_OP_PREPARE_WRITE_REQUEST:
-        handlePrepareWriteRequest(incomingPacket);
+        handlePrepareWriteRequest(session, incomingPacket);
         return;
     case QBluezConst::AttCommand::ATT_OP_EXECUTE_WRITE_REQUEST:
-        handleExecuteWriteRequest(incomingPacket);
+        handleExecuteWriteRequest(session, incomingPacket);
         return;
     case QBluezConst::AttCommand::ATT_OP_HANDLE_VAL_CONFIRMATION:
-        if (indicationInFlight) {
-            indicationInFlight = false;
-            sendNextIndication();
+        if (session.indicationInFlight) {
+            session.indicationInFlight = false;
+            sendNextIndication(session);
         } else {
             qCWarning(QT_BT_BLUEZ) << "received unexpected handle value confirmation";
         }
@@ -796,11 +902,23 @@ void QLowEnergyControllerPrivateBluez::l2cpReadyRead()
 
     if (openRequests.isEmpty()) {
         qCWarning(QT_BT_BLUEZ) << "Received unexpected packet from peer, disconnecting.";
-        disconnectFromDevice();
+        if (sessions.size() > 1)
+            closeSession(&session);
+        else
+            disconnectFromDevice();
         return;
     }
 
     const Request request = openRequests.dequeue();
+    const qint64 latency = requestElapsedTimer.isValid()
+            ? qMax(requestElapsedTimer.nsecsElapsed() - queuedNsecs, qint64(0)) : -1;
+    requestElapsedTimer.invalidate();
+    Q_TRACE(QLowEnergyControllerPrivateBluez_attResponseReceived, quint8(request.command),
+            quint8(command), incomingPacket.size(), latency);
+    if (latency >= 0)
+        statistics.recordLatency(quint8(request.command), latency);
+    if (command == QBluezConst::AttCommand::ATT_OP_ERROR_RESPONSE)
+        ++statistics.errorResponses;
     processReply(request, incomingPacket);
 
     sendNextPendingRequest();
@@ -818,13 +936,21 @@ void QLowEnergyControllerPrivateBluez::l2cpReadyRead()
 void QLowEnergyControllerPrivateBluez::encryptionChangedEvent(
         const QBluetoothAddress &address, bool wasSuccess)
 {
-    if (!encryptionChangePending) // somebody else caused change event
+    // Pairing also changes the encryption
+    if (role == QLowEnergyController::PeripheralRole) {
+        if (ServerSession *const session = sessionForAddress(address))
+            refreshLinkState(*session);
         return;
+    }
+    if (address != remoteDevice || sessions.empty())
+        return;
+    refreshLinkState(*sessions.front());
 
-    if (remoteDevice != address)
+    if (!encryptionChangePending) // somebody else caused change event
         return;
 
-    securityLevelValue = securityLevel();
+    if (wasSuccess)
+        ++statistics.encryptionChanges;
 
     // On success continue to process ATT command queue
     if (!wasSuccess) {
@@ -866,15 +992,21 @@ void QLowEnergyControllerPrivateBluez::encryptionChangedEvent(
 
 void QLowEnergyControllerPrivateBluez::sendPacket(const QByteArray &packet)
 {
-    qint64 result = l2cpSocket->write(packet.constData(),
-                                      packet.size());
+    sendPacket(l2cpSocket, packet);
+}
+
+void QLowEnergyControllerPrivateBluez::sendPacket(QBluetoothSocket *socket,
+                                                  const QByteArray &packet)
+{
+    qint64 result = socket->write(packet.constData(),
+                                  packet.size());
     // We ignore result == 0 which is likely to be caused by EAGAIN.
     // This packet is effectively discarded but the controller can still recover
 
     if (result == -1) {
         qCDebug(QT_BT_BLUEZ) << "Cannot write L2CP packet:" << Qt::hex
                              << packet.toHex()
-                             << l2cpSocket->errorString();
+                             << socket->errorString();
         setError(QLowEnergyController::NetworkError);
     } else if (result < packet.size()) {
         qCWarning(QT_BT_BLUEZ) << "L2CP write request incomplete:"
@@ -894,6 +1026,15 @@ void QLowEnergyControllerPrivateBluez::sendNextPendingRequest()
 
     requestPending = true;
     restartRequestTimer();
+    if (Q_TRACE_ENABLED(QLowEnergyControllerPrivateBluez_attRequestSent)) {
+        // Most requests start with a handle, the MTU exchange is the exception
+        const quint16 handle = request.payload.size() >= 3
+                ? bt_get_le16(request.payload.constData() + 1) : 0;
+        Q_TRACE(QLowEnergyControllerPrivateBluez_attRequestSent, quint8(request.command), handle,
+                request.payload.size());
+    }
+    statistics.recordRequest(openRequests.size());
+    requestElapsedTimer.start();
     sendPacket(request.payload);
 }
 
@@ -969,6 +1110,8 @@ void QLowEnergyControllerPrivateBluez::processReply(
     case QBluezConst::AttCommand::ATT_OP_EXCHANGE_MTU_RESPONSE: {
         Q_ASSERT(request.command == QBluezConst::AttCommand::ATT_OP_EXCHANGE_MTU_REQUEST);
         quint16 oldMtuSize = mtuSize;
+        if (!isErrorResponse)
+            ++statistics.mtuExchanges;
         if (isErrorResponse) {
             mtuSize = ATT_DEFAULT_LE_MTU;
         } else {
@@ -980,6 +1123,9 @@ void QLowEnergyControllerPrivateBluez::processReply(
 
             qCDebug(QT_BT_BLUEZ) << "Server MTU:" << mtu << "resulting mtu:" << mtuSize;
         }
+        // The local services are served with the same MTU
+        if (!sessions.empty())
+            sessions.front()->mtuSize = mtuSize;
         if (oldMtuSize != mtuSize)
             emit q->mtuChanged(mtuSize);
     } break;
@@ -1718,12 +1864,15 @@ void QLowEnergyControllerPrivateBluez::discoverServiceDescriptors(
     discoverNextDescriptor(service, keys, keys[0]);
 }
 
-void QLowEnergyControllerPrivateBluez::processUnsolicitedReply(const QByteArray &payload)
+void QLowEnergyControllerPrivateBluez::processUnsolicitedReply(QByteArray payload)
 {
     const char *data = payload.constData();
     bool isNotification = (static_cast<QBluezConst::AttCommand>(data[0])
                            == QBluezConst::AttCommand::ATT_OP_HANDLE_VAL_NOTIFICATION);
     const QLowEnergyHandle changedHandle = bt_get_le16(&data[1]);
+    Q_TRACE(QLowEnergyControllerPrivateBluez_attNotificationReceived, quint8(data[0]),
+            changedHandle, payload.size());
+    statistics.recordNotification(payload.size() - 3);
 
     if (QT_BT_BLUEZ().isDebugEnabled()) {
         if (isNotification)
@@ -1734,9 +1883,13 @@ void QLowEnergyControllerPrivateBluez::processUnsolicitedReply(const QByteArray
 
     const QLowEnergyCharacteristic ch = characteristicForHandle(changedHandle);
     if (ch.isValid() && ch.handle() == changedHandle) {
+        // Dropping the header of the unshared packet only moves its begin, so
+        // the stored and the emitted value share the received buffer
+        payload.remove(0, 3);
+        const QByteArray newValue = std::move(payload);
         if (ch.properties() & QLowEnergyCharacteristic::Read)
-            updateValueOfCharacteristic(ch.attributeHandle(), payload.mid(3), NEW_VALUE);
-        emit ch.d_ptr->characteristicChanged(ch, payload.mid(3));
+            updateValueOfCharacteristic(ch.attributeHandle(), newValue, NEW_VALUE);
+        emit ch.d_ptr->characteristicChanged(ch, newValue);
     } else {
         qCWarning(QT_BT_BLUEZ) << "Cannot find matching characteristic for "
                                   "notification/indication";
@@ -1762,9 +1915,9 @@ void QLowEnergyControllerPrivateBluez::exchangeMTU()
     sendNextPendingRequest();
 }
 
-int QLowEnergyControllerPrivateBluez::securityLevel() const
+int QLowEnergyControllerPrivateBluez::securityLevel(const ServerSession &session) const
 {
-    int socket = l2cpSocket->socketDescriptor();
+    int socket = session.socket->socketDescriptor();
     if (socket < 0) {
         qCWarning(QT_BT_BLUEZ) << "Invalid l2cp socket, aborting getting of sec level";
         return -1;
@@ -1801,6 +1954,28 @@ int QLowEnergyControllerPrivateBluez::securityLevel() const
     return -1;
 }
 
+/*
+    Returns the security level of the link without a system call. The level
+    only changes with the encryption of the link, which is reported by the
+    HCI manager. Without the HCI manager the level has to be queried.
+*/
+int QLowEnergyControllerPrivateBluez::linkSecurityLevel(const ServerSession &session) const
+{
+    if (!hciManager || !hciManager->isValid())
+        return securityLevel(session);
+    return session.securityLevelValue;
+}
+
+/*
+    Reads the security level of a new or newly encrypted link, and forgets
+    the bond state which may have changed with it.
+*/
+void QLowEnergyControllerPrivateBluez::refreshLinkState(ServerSession &session)
+{
+    session.securityLevelValue = securityLevel(session);
+    session.bondedValue.reset();
+}
+
 bool QLowEnergyControllerPrivateBluez::setSecurityLevel(int level)
 {
     if (level > BT_SECURITY_HIGH || level < BT_SECURITY_LOW)
@@ -1998,10 +2173,70 @@ void QLowEnergyControllerPrivateBluez::writeDescriptor(
 {
     Q_ASSERT(!service.isNull());
 
-    if (role == QLowEnergyController::PeripheralRole)
+    if (role == QLowEnergyController::PeripheralRole) {
         writeDescriptorForPeripheral(service, charHandle, descriptorHandle, newValue);
-    else
+    } else {
+        statistics.recordWrite(newValue.size());
         writeDescriptorForCentral(charHandle, descriptorHandle, newValue);
+    }
+}
+
+/*
+    Requests the connection parameters, the data length and the PHY of the
+    link profile. All of them need the HCI connection handle, a peripheral
+    applies the profile to the links of all connected centrals.
+ */
+void QLowEnergyControllerPrivateBluez::applyLinkProfile()
+{
+    linkProfilePending = false;
+    if (linkProfile == QLowEnergyController::DefaultLinkProfile)
+        return;
+
+    if (role == QLowEnergyController::PeripheralRole) {
+        for (const auto &session : std::as_const(sessions))
+            applyLinkProfile(session->connectionHandle);
+        return;
+    }
+
+    if (connectionHandle == 0) {
+        // The socket of a central may connect before the connection complete
+        // event arrived, the profile is applied when it does
+        qCDebug(QT_BT_BLUEZ) << "Deferring link profile until the connection handle is known";
+        linkProfilePending = true;
+        return;
+    }
+    applyLinkProfile(connectionHandle);
+}
+
+void QLowEnergyControllerPrivateBluez::applyLinkProfile(quint16 handle)
+{
+    if (handle == 0) {
+        qCWarning(QT_BT_BLUEZ) << "Cannot apply link profile without connection handle";
+        return;
+    }
+
+    qCDebug(QT_BT_BLUEZ) << "Applying link profile" << linkProfile << "to connection" << handle;
+    const QLowEnergyConnectionParameters params = connectionParametersForProfile(linkProfile);
+    if (role == QLowEnergyController::CentralRole)
+        hciManager->sendConnectionUpdateCommand(handle, params);
+    else
+        hciManager->sendConnectionParameterUpdateRequest(handle, params);
+
+    if (linkProfile != QLowEnergyController::LowLatencyLinkProfile
+            && linkProfile != QLowEnergyController::HighThroughputLinkProfile) {
+        return;
+    }
+
+    // Spec v5.3, Vol 6, Part B, 4.5.10
+    // 251 bytes is the maximum payload, taking 2120 microseconds on the LE 1M PHY.
+    constexpr quint16 maxTxOctets = 251;
+    constexpr quint16 maxTxTime = 2120;
+    hciManager->sendSetDataLengthCommand(handle, maxTxOctets, maxTxTime);
+
+    // Prefer the LE 2M PHY in both directions, the controller falls back to
+    // LE 1M if the remote device does not support it.
+    constexpr quint8 le2MPhy = 0x02;
+    hciManager->sendSetPhyCommand(handle, le2MPhy, le2MPhy);
 }
 
 /*!
@@ -2089,7 +2324,8 @@ void QLowEnergyControllerPrivateBluez::readDescriptor(
 bool QLowEnergyControllerPrivateBluez::increaseEncryptLevelfRequired(
         QBluezConst::AttError errorCode)
 {
-    if (securityLevelValue == BT_SECURITY_HIGH)
+    const int level = sessions.empty() ? -1 : sessions.front()->securityLevelValue;
+    if (level == BT_SECURITY_HIGH)
         return false;
 
     switch (errorCode) {
@@ -2100,7 +2336,7 @@ bool QLowEnergyControllerPrivateBluez::increaseEncryptLevelfRequired(
             return false;
         if (!hciManager->monitorEvent(HciManager::HciEvent::EVT_ENCRYPT_CHANGE))
             return false;
-        if (securityLevelValue != BT_SECURITY_HIGH) {
+        if (level != BT_SECURITY_HIGH) {
             qCDebug(QT_BT_BLUEZ) << "Requesting encrypted link";
             if (setSecurityLevel(BT_SECURITY_HIGH)) {
                 restartRequestTimer();
@@ -2122,8 +2358,9 @@ void QLowEnergyControllerPrivateBluez::handleAdvertisingError()
     setState(QLowEnergyController::UnconnectedState);
 }
 
-bool QLowEnergyControllerPrivateBluez::checkPacketSize(const QByteArray &packet, int minSize,
-                                                  int maxSize)
+bool QLowEnergyControllerPrivateBluez::checkPacketSize(ServerSession &session,
+                                                       const QByteArray &packet, int minSize,
+                                                       int maxSize)
 {
     if (maxSize == -1)
         maxSize = minSize;
@@ -2131,78 +2368,92 @@ bool QLowEnergyControllerPrivateBluez::checkPacketSize(const QByteArray &packet,
         return true;
     qCWarning(QT_BT_BLUEZ) << "client request of type" << packet.at(0)
                            << "has unexpected packet size" << packet.size();
-    sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), 0,
+    sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)), 0,
                       QBluezConst::AttError::ATT_ERROR_INVALID_PDU);
     return false;
 }
 
-bool QLowEnergyControllerPrivateBluez::checkHandle(const QByteArray &packet, QLowEnergyHandle handle)
+bool QLowEnergyControllerPrivateBluez::checkHandle(ServerSession &session,
+                                                   const QByteArray &packet,
+                                                   QLowEnergyHandle handle)
 {
     if (handle != 0 && handle <= lastLocalHandle)
         return true;
-    sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
+    sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
                       QBluezConst::AttError::ATT_ERROR_INVALID_HANDLE);
     return false;
 }
 
-bool QLowEnergyControllerPrivateBluez::checkHandlePair(QBluezConst::AttCommand request,
+bool QLowEnergyControllerPrivateBluez::checkHandlePair(ServerSession &session,
+                                                       QBluezConst::AttCommand request,
                                                        QLowEnergyHandle startingHandle,
                                                        QLowEnergyHandle endingHandle)
 {
     if (startingHandle == 0 || startingHandle > endingHandle) {
         qCDebug(QT_BT_BLUEZ) << "handle range invalid";
-        sendErrorResponse(request, startingHandle, QBluezConst::AttError::ATT_ERROR_INVALID_HANDLE);
+        sendErrorResponse(session, request, startingHandle,
+                          QBluezConst::AttError::ATT_ERROR_INVALID_HANDLE);
         return false;
     }
     return true;
 }
 
-void QLowEnergyControllerPrivateBluez::handleExchangeMtuRequest(const QByteArray &packet)
+void QLowEnergyControllerPrivateBluez::handleExchangeMtuRequest(ServerSession &session,
+                                                                const QByteArray &packet)
 {
     // Spec v4.2, Vol 3, Part F, 3.4.2
 
-    if (!checkPacketSize(packet, 3))
+    if (!checkPacketSize(session, packet, 3))
         return;
-    if (receivedMtuExchangeRequest) { // Client must only send this once per connection.
+    if (session.receivedMtuExchangeRequest) { // Client must only send this once per connection.
         qCDebug(QT_BT_BLUEZ) << "Client sent extraneous MTU exchange packet";
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), 0,
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)), 0,
                           QBluezConst::AttError::ATT_ERROR_REQUEST_NOT_SUPPORTED);
         return;
     }
-    receivedMtuExchangeRequest = true;
+    session.receivedMtuExchangeRequest = true;
 
     // Send reply.
     QByteArray reply(MTU_EXCHANGE_HEADER_SIZE, Qt::Uninitialized);
     reply[0] = static_cast<quint8>(QBluezConst::AttCommand::ATT_OP_EXCHANGE_MTU_RESPONSE);
     putBtData(ATT_MAX_LE_MTU, reply.data() + 1);
-    sendPacket(reply);
+    sendPacket(session.socket, reply);
 
     // Apply requested MTU.
     const quint16 clientRxMtu = bt_get_le16(packet.constData() + 1);
-    mtuSize = std::clamp(clientRxMtu, ATT_DEFAULT_LE_MTU, ATT_MAX_LE_MTU);
+    session.mtuSize = std::clamp(clientRxMtu, ATT_DEFAULT_LE_MTU, ATT_MAX_LE_MTU);
+    ++statistics.mtuExchanges;
     qCDebug(QT_BT_BLUEZ) << "MTU request from client:" << clientRxMtu
-                         << "effective client RX MTU:" << mtuSize;
+                         << "effective client RX MTU:" << session.mtuSize;
     qCDebug(QT_BT_BLUEZ) << "Sending server RX MTU" << ATT_MAX_LE_MTU;
+
+    // The controller reports the MTU of the first central it is connected to.
+    if (&session == sessions.front().get() && mtuSize != session.mtuSize) {
+        Q_Q(QLowEnergyController);
+        mtuSize = session.mtuSize;
+        emit q->mtuChanged(mtuSize);
+    }
 }
 
-void QLowEnergyControllerPrivateBluez::handleFindInformationRequest(const QByteArray &packet)
+void QLowEnergyControllerPrivateBluez::handleFindInformationRequest(ServerSession &session,
+                                                                    const QByteArray &packet)
 {
     // Spec v4.2, Vol 3, Part F, 3.4.3.1-2
 
-    if (!checkPacketSize(packet, 5))
+    if (!checkPacketSize(session, packet, 5))
         return;
     const QLowEnergyHandle startingHandle = bt_get_le16(packet.constData() + 1);
     const QLowEnergyHandle endingHandle = bt_get_le16(packet.constData() + 3);
     qCDebug(QT_BT_BLUEZ) << "client sends find information request; start:" << startingHandle
                          << "end:" << endingHandle;
-    if (!checkHandlePair(static_cast<QBluezConst::AttCommand>(packet.at(0)), startingHandle,
-                         endingHandle))
+    if (!checkHandlePair(session, static_cast<QBluezConst::AttCommand>(packet.at(0)),
+                         startingHandle, endingHandle))
         return;
 
-    QList<Attribute> results = getAttributes(startingHandle, endingHandle);
+    QList<Attribute> results = getAttributes(session, startingHandle, endingHandle);
     if (results.isEmpty()) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), startingHandle,
-                          QBluezConst::AttError::ATT_ERROR_ATTRIBUTE_NOT_FOUND);
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)),
+                          startingHandle, QBluezConst::AttError::ATT_ERROR_ATTRIBUTE_NOT_FOUND);
         return;
     }
     ensureUniformUuidSizes(results);
@@ -2217,15 +2468,16 @@ void QLowEnergyControllerPrivateBluez::handleFindInformationRequest(const QByteA
         putDataAndIncrement(attr.handle, data);
         putDataAndIncrement(attr.type, data);
     };
-    sendListResponse(responsePrefix, elementSize, results, elemWriter);
+    sendListResponse(session, responsePrefix, elementSize, results, elemWriter);
 
 }
 
-void QLowEnergyControllerPrivateBluez::handleFindByTypeValueRequest(const QByteArray &packet)
+void QLowEnergyControllerPrivateBluez::handleFindByTypeValueRequest(ServerSession &session,
+                                                                    const QByteArray &packet)
 {
     // Spec v4.2, Vol 3, Part F, 3.4.3.3-4
 
-    if (!checkPacketSize(packet, 7, mtuSize))
+    if (!checkPacketSize(session, packet, 7, session.mtuSize))
         return;
     const QLowEnergyHandle startingHandle = bt_get_le16(packet.constData() + 1);
     const QLowEnergyHandle endingHandle = bt_get_le16(packet.constData() + 3);
@@ -2234,18 +2486,19 @@ void QLowEnergyControllerPrivateBluez::handleFindByTypeValueRequest(const QByteA
     qCDebug(QT_BT_BLUEZ) << "client sends find by type value request; start:" << startingHandle
                          << "end:" << endingHandle << "type:" << type
                          << "value:" << value.toHex();
-    if (!checkHandlePair(static_cast<QBluezConst::AttCommand>(packet.at(0)), startingHandle,
-                         endingHandle))
+    if (!checkHandlePair(session, static_cast<QBluezConst::AttCommand>(packet.at(0)),
+                         startingHandle, endingHandle))
         return;
 
-    const auto predicate = [value, this, type](const Attribute &attr) {
+    const auto predicate = [value, this, type, &session](const Attribute &attr) {
         return attr.type == QBluetoothUuid(type) && attr.value == value
-                && checkReadPermissions(attr) == QBluezConst::AttError::ATT_ERROR_NO_ERROR;
+                && checkReadPermissions(session, attr) == QBluezConst::AttError::ATT_ERROR_NO_ERROR;
     };
-    const QList<Attribute> results = getAttributes(startingHandle, endingHandle, predicate);
+    const QList<Attribute> results =
+            getAttributes(session, startingHandle, endingHandle, predicate);
     if (results.isEmpty()) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), startingHandle,
-                          QBluezConst::AttError::ATT_ERROR_ATTRIBUTE_NOT_FOUND);
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)),
+                          startingHandle, QBluezConst::AttError::ATT_ERROR_ATTRIBUTE_NOT_FOUND);
         return;
     }
 
@@ -2256,14 +2509,15 @@ void QLowEnergyControllerPrivateBluez::handleFindByTypeValueRequest(const QByteA
         putDataAndIncrement(attr.handle, data);
         putDataAndIncrement(attr.groupEndHandle, data);
     };
-    sendListResponse(responsePrefix, elemSize, results, elemWriter);
+    sendListResponse(session, responsePrefix, elemSize, results, elemWriter);
 }
 
-void QLowEnergyControllerPrivateBluez::handleReadByTypeRequest(const QByteArray &packet)
+void QLowEnergyControllerPrivateBluez::handleReadByTypeRequest(ServerSession &session,
+                                                               const QByteArray &packet)
 {
     // Spec v4.2, Vol 3, Part F, 3.4.4.1-2
 
-    if (!checkPacketSize(packet, 7, 21))
+    if (!checkPacketSize(session, packet, 7, 21))
         return;
     const QLowEnergyHandle startingHandle = bt_get_le16(packet.constData() + 1);
     const QLowEnergyHandle endingHandle = bt_get_le16(packet.constData() + 3);
@@ -2277,31 +2531,31 @@ void QLowEnergyControllerPrivateBluez::handleReadByTypeRequest(const QByteArray
         type = QUuid::fromBytes(typeStart, QSysInfo::LittleEndian);
     } else {
         qCWarning(QT_BT_BLUEZ) << "read by type request has invalid packet size" << packet.size();
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), 0,
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)), 0,
                           QBluezConst::AttError::ATT_ERROR_INVALID_PDU);
         return;
     }
     qCDebug(QT_BT_BLUEZ) << "client sends read by type request, start:" << startingHandle
                          << "end:" << endingHandle << "type:" << type;
-    if (!checkHandlePair(static_cast<QBluezConst::AttCommand>(packet.at(0)), startingHandle,
-                         endingHandle))
+    if (!checkHandlePair(session, static_cast<QBluezConst::AttCommand>(packet.at(0)),
+                         startingHandle, endingHandle))
         return;
 
     // Get all attributes with matching type.
     QList<Attribute> results =
-            getAttributes(startingHandle, endingHandle,
+            getAttributes(session, startingHandle, endingHandle,
                           [type](const Attribute &attr) { return attr.type == type; });
     ensureUniformValueSizes(results);
 
     if (results.isEmpty()) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), startingHandle,
-                          QBluezConst::AttError::ATT_ERROR_ATTRIBUTE_NOT_FOUND);
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)),
+                          startingHandle, QBluezConst::AttError::ATT_ERROR_ATTRIBUTE_NOT_FOUND);
         return;
     }
 
-    const QBluezConst::AttError error = checkReadPermissions(results);
+    const QBluezConst::AttError error = checkReadPermissions(session, results);
     if (error != QBluezConst::AttError::ATT_ERROR_NO_ERROR) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)),
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)),
                           results.first().handle, error);
         return;
     }
@@ -2314,85 +2568,90 @@ void QLowEnergyControllerPrivateBluez::handleReadByTypeRequest(const QByteArray
         putDataAndIncrement(attr.handle, data);
         putDataAndIncrement(attr.value, data);
     };
-    sendListResponse(responsePrefix, elementSize, results, elemWriter);
+    sendListResponse(session, responsePrefix, elementSize, results, elemWriter);
 }
 
-void QLowEnergyControllerPrivateBluez::handleReadRequest(const QByteArray &packet)
+void QLowEnergyControllerPrivateBluez::handleReadRequest(ServerSession &session,
+                                                         const QByteArray &packet)
 {
     // Spec v4.2, Vol 3, Part F, 3.4.4.3-4
 
-    if (!checkPacketSize(packet, 3))
+    if (!checkPacketSize(session, packet, 3))
         return;
     const QLowEnergyHandle handle = bt_get_le16(packet.constData() + 1);
     qCDebug(QT_BT_BLUEZ) << "client sends read request; handle:" << handle;
 
-    if (!checkHandle(packet, handle))
+    if (!checkHandle(session, packet, handle))
         return;
     const Attribute &attribute = localAttributes.at(handle);
-    const QBluezConst::AttError permissionsError = checkReadPermissions(attribute);
+    const QBluezConst::AttError permissionsError = checkReadPermissions(session, attribute);
     if (permissionsError != QBluezConst::AttError::ATT_ERROR_NO_ERROR) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
                           permissionsError);
         return;
     }
+    const QByteArray value = attributeValue(session, attribute);
 
-    const qsizetype sentValueLength = (std::min)(attribute.value.size(), qsizetype(mtuSize) - 1);
+    const qsizetype sentValueLength = (std::min)(value.size(), qsizetype(session.mtuSize) - 1);
     QByteArray response(1 + sentValueLength, Qt::Uninitialized);
     response[0] = static_cast<quint8>(QBluezConst::AttCommand::ATT_OP_READ_RESPONSE);
     using namespace std;
-    memcpy(response.data() + 1, attribute.value.constData(), sentValueLength);
+    memcpy(response.data() + 1, value.constData(), sentValueLength);
     qCDebug(QT_BT_BLUEZ) << "sending response:" << response.toHex();
-    sendPacket(response);
+    sendPacket(session.socket, response);
 }
 
-void QLowEnergyControllerPrivateBluez::handleReadBlobRequest(const QByteArray &packet)
+void QLowEnergyControllerPrivateBluez::handleReadBlobRequest(ServerSession &session,
+                                                             const QByteArray &packet)
 {
     // Spec v4.2, Vol 3, Part F, 3.4.4.5-6
 
-    if (!checkPacketSize(packet, 5))
+    if (!checkPacketSize(session, packet, 5))
         return;
     const QLowEnergyHandle handle = bt_get_le16(packet.constData() + 1);
     const quint16 valueOffset = bt_get_le16(packet.constData() + 3);
     qCDebug(QT_BT_BLUEZ) << "client sends read blob request; handle:" << handle
                          << "offset:" << valueOffset;
 
-    if (!checkHandle(packet, handle))
+    if (!checkHandle(session, packet, handle))
         return;
     const Attribute &attribute = localAttributes.at(handle);
-    const QBluezConst::AttError permissionsError = checkReadPermissions(attribute);
+    const QBluezConst::AttError permissionsError = checkReadPermissions(session, attribute);
     if (permissionsError != QBluezConst::AttError::ATT_ERROR_NO_ERROR) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
                           permissionsError);
         return;
     }
-    if (valueOffset > attribute.value.size()) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
+    const QByteArray value = attributeValue(session, attribute);
+    if (valueOffset > value.size()) {
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
                           QBluezConst::AttError::ATT_ERROR_INVALID_OFFSET);
         return;
     }
-    if (attribute.value.size() <= mtuSize - 3) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
+    if (value.size() <= session.mtuSize - 3) {
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
                           QBluezConst::AttError::ATT_ERROR_ATTRIBUTE_NOT_LONG);
         return;
     }
 
     // Yes, this value can be zero.
-    const qsizetype sentValueLength = (std::min)(attribute.value.size() - valueOffset,
-                                                 qsizetype(mtuSize) - 1);
+    const qsizetype sentValueLength = (std::min)(value.size() - valueOffset,
+                                                 qsizetype(session.mtuSize) - 1);
 
     QByteArray response(1 + sentValueLength, Qt::Uninitialized);
     response[0] = static_cast<quint8>(QBluezConst::AttCommand::ATT_OP_READ_BLOB_RESPONSE);
     using namespace std;
-    memcpy(response.data() + 1, attribute.value.constData() + valueOffset, sentValueLength);
+    memcpy(response.data() + 1, value.constData() + valueOffset, sentValueLength);
     qCDebug(QT_BT_BLUEZ) << "sending response:" << response.toHex();
-    sendPacket(response);
+    sendPacket(session.socket, response);
 }
 
-void QLowEnergyControllerPrivateBluez::handleReadMultipleRequest(const QByteArray &packet)
+void QLowEnergyControllerPrivateBluez::handleReadMultipleRequest(ServerSession &session,
+                                                                 const QByteArray &packet)
 {
     // Spec v4.2, Vol 3, Part F, 3.4.4.7-8
 
-    if (!checkPacketSize(packet, 5, mtuSize))
+    if (!checkPacketSize(session, packet, 5, session.mtuSize))
         return;
     QList<QLowEnergyHandle> handles((packet.size() - 1) / sizeof(QLowEnergyHandle));
     auto *packetPtr = reinterpret_cast<const QLowEnergyHandle *>(packet.constData() + 1);
@@ -2403,35 +2662,36 @@ void QLowEnergyControllerPrivateBluez::handleReadMultipleRequest(const QByteArra
     const auto it = std::find_if(handles.constBegin(), handles.constEnd(),
             [this](QLowEnergyHandle handle) { return handle >= lastLocalHandle; });
     if (it != handles.constEnd()) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), *it,
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)), *it,
                           QBluezConst::AttError::ATT_ERROR_INVALID_HANDLE);
         return;
     }
-    const QList<Attribute> results = getAttributes(handles.first(), handles.last());
+    const QList<Attribute> results = getAttributes(session, handles.first(), handles.last());
     QByteArray response(
             1, static_cast<quint8>(QBluezConst::AttCommand::ATT_OP_READ_MULTIPLE_RESPONSE));
     for (const Attribute &attr : results) {
-        const QBluezConst::AttError error = checkReadPermissions(attr);
+        const QBluezConst::AttError error = checkReadPermissions(session, attr);
         if (error != QBluezConst::AttError::ATT_ERROR_NO_ERROR) {
-            sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), attr.handle,
-                              error);
+            sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)),
+                              attr.handle, error);
             return;
         }
 
         // Note: We do not abort if no more values fit into the packet, because we still have to
         //       report possible permission errors for the other handles.
-        response += attr.value.left(mtuSize - response.size());
+        response += attr.value.left(session.mtuSize - response.size());
     }
 
     qCDebug(QT_BT_BLUEZ) << "sending response:" << response.toHex();
-    sendPacket(response);
+    sendPacket(session.socket, response);
 }
 
-void QLowEnergyControllerPrivateBluez::handleReadByGroupTypeRequest(const QByteArray &packet)
+void QLowEnergyControllerPrivateBluez::handleReadByGroupTypeRequest(ServerSession &session,
+                                                                    const QByteArray &packet)
 {
     // Spec v4.2, Vol 3, Part F, 3.4.4.9-10
 
-    if (!checkPacketSize(packet, 7, 21))
+    if (!checkPacketSize(session, packet, 7, 21))
         return;
     const QLowEnergyHandle startingHandle = bt_get_le16(packet.constData() + 1);
     const QLowEnergyHandle endingHandle = bt_get_le16(packet.constData() + 3);
@@ -2446,34 +2706,34 @@ void QLowEnergyControllerPrivateBluez::handleReadByGroupTypeRequest(const QByteA
     } else {
         qCWarning(QT_BT_BLUEZ) << "read by group type request has invalid packet size"
                                << packet.size();
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), 0,
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)), 0,
                           QBluezConst::AttError::ATT_ERROR_INVALID_PDU);
         return;
     }
     qCDebug(QT_BT_BLUEZ) << "client sends read by group type request, start:" << startingHandle
                          << "end:" << endingHandle << "type:" << type;
 
-    if (!checkHandlePair(static_cast<QBluezConst::AttCommand>(packet.at(0)), startingHandle,
-                         endingHandle))
+    if (!checkHandlePair(session, static_cast<QBluezConst::AttCommand>(packet.at(0)),
+                         startingHandle, endingHandle))
         return;
     if (type != QBluetoothUuid(static_cast<quint16>(GATT_PRIMARY_SERVICE))
             && type != QBluetoothUuid(static_cast<quint16>(GATT_SECONDARY_SERVICE))) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), startingHandle,
-                          QBluezConst::AttError::ATT_ERROR_UNSUPPRTED_GROUP_TYPE);
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)),
+                          startingHandle, QBluezConst::AttError::ATT_ERROR_UNSUPPRTED_GROUP_TYPE);
         return;
     }
 
     QList<Attribute> results =
-            getAttributes(startingHandle, endingHandle,
+            getAttributes(session, startingHandle, endingHandle,
                           [type](const Attribute &attr) { return attr.type == type; });
     if (results.isEmpty()) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), startingHandle,
-                          QBluezConst::AttError::ATT_ERROR_ATTRIBUTE_NOT_FOUND);
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)),
+                          startingHandle, QBluezConst::AttError::ATT_ERROR_ATTRIBUTE_NOT_FOUND);
         return;
     }
-    const QBluezConst::AttError error = checkReadPermissions(results);
+    const QBluezConst::AttError error = checkReadPermissions(session, results);
     if (error != QBluezConst::AttError::ATT_ERROR_NO_ERROR) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)),
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)),
                           results.first().handle, error);
         return;
     }
@@ -2489,16 +2749,25 @@ void QLowEnergyControllerPrivateBluez::handleReadByGroupTypeRequest(const QByteA
         putDataAndIncrement(attr.groupEndHandle, data);
         putDataAndIncrement(attr.value, data);
     };
-    sendListResponse(responsePrefix, elementSize, results, elemWriter);
+    sendListResponse(session, responsePrefix, elementSize, results, elemWriter);
 }
 
 void QLowEnergyControllerPrivateBluez::updateLocalAttributeValue(
+        ServerSession &session,
         QLowEnergyHandle handle,
         const QByteArray &value,
         QLowEnergyCharacteristic &characteristic,
         QLowEnergyDescriptor &descriptor)
 {
-    localAttributes[handle].value = value;
+    // Client characteristic configurations belong to the central that wrote them, the
+    // shared attribute and descriptor values show the ones of the primary central.
+    const bool isClientConfig = localAttributes.at(handle).type
+            == QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration;
+    if (isClientConfig)
+        session.clientConfigValues[handle] = value;
+    const bool isLocalValue = !isClientConfig || &session == sessions.front().get();
+    if (isLocalValue)
+        localAttributes[handle].value = value;
     for (const auto &service : std::as_const(localServices)) {
         if (handle < service->startHandle || handle > service->endHandle)
             continue;
@@ -2513,7 +2782,8 @@ void QLowEnergyControllerPrivateBluez::updateLocalAttributeValue(
             for (auto descIt = charData.descriptorList.begin();
                  descIt != charData.descriptorList.end(); ++descIt) {
                 if (handle == descIt.key()) {
-                    descIt.value().value = value;
+                    if (isLocalValue)
+                        descIt.value().value = value;
                     descriptor = QLowEnergyDescriptor(service, charIt.key(), handle);
                     return;
                 }
@@ -2545,35 +2815,47 @@ void QLowEnergyControllerPrivateBluez::writeCharacteristicForPeripheral(
             = attribute.properties & QLowEnergyCharacteristic::Indicate;
     if (!hasNotifyProperty && !hasIndicateProperty)
         return;
-    for (const QLowEnergyServicePrivate::DescData &desc : std::as_const(charData.descriptorList)) {
+    const auto isSubscribed = [=](quint16 configValue) {
+        return (isNotificationEnabled(configValue) && hasNotifyProperty)
+                || (isIndicationEnabled(configValue) && hasIndicateProperty);
+    };
+    for (auto descIt = charData.descriptorList.cbegin();
+         descIt != charData.descriptorList.cend(); ++descIt) {
+        const QLowEnergyServicePrivate::DescData &desc = descIt.value();
         if (desc.uuid != QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration)
             continue;
 
-        // Notify/indicate currently connected client.
+        // Notify/indicate the connected clients that subscribed to the characteristic.
         const bool isConnected = state == QLowEnergyController::ConnectedState;
         if (isConnected) {
-            Q_ASSERT(desc.value.size() == 2);
-            quint16 configValue = bt_get_le16(desc.value.constData());
-            if (isNotificationEnabled(configValue) && hasNotifyProperty) {
-                sendNotification(valueHandle);
-            } else if (isIndicationEnabled(configValue) && hasIndicateProperty) {
-                if (indicationInFlight)
-                    scheduledIndications << valueHandle;
-                else
-                    sendIndication(valueHandle);
+            ++sessionsInUse;
+            const auto inUse = qScopeGuard([this]() { --sessionsInUse; });
+            for (const auto &session : std::as_const(sessions)) {
+                const QByteArray configData =
+                        attributeValue(*session, localAttributes.at(descIt.key()));
+                if (configData.size() != 2)
+                    continue;
+                const quint16 configValue = bt_get_le16(configData.constData());
+                if (isNotificationEnabled(configValue) && hasNotifyProperty) {
+                    sendNotification(*session, valueHandle);
+                } else if (isIndicationEnabled(configValue) && hasIndicateProperty) {
+                    if (session->indicationInFlight)
+                        session->scheduledIndications << valueHandle;
+                    else
+                        sendIndication(*session, valueHandle);
+                }
             }
         }
 
         // Prepare notification/indication of unconnected, bonded clients.
         for (auto it = clientConfigData.begin(); it != clientConfigData.end(); ++it) {
-            if (isConnected && it.key() == remoteDevice.toUInt64())
+            if (isConnected && isConnectedCentral(it.key()))
                 continue;
             QList<ClientConfigurationData> &configDataList = it.value();
             for (ClientConfigurationData &configData : configDataList) {
                 if (configData.charValueHandle != valueHandle)
                     continue;
-                if ((isNotificationEnabled(configData.configValue) && hasNotifyProperty)
-                        || (isIndicationEnabled(configData.configValue) && hasIndicateProperty)) {
+                if (isSubscribed(configData.configValue)) {
                     configData.charValueWasUpdated = true;
                     break;
                 }
@@ -2589,6 +2871,7 @@ void QLowEnergyControllerPrivateBluez::writeCharacteristicForCentral(const QShar
         const QByteArray &newValue,
         QLowEnergyService::WriteMode mode)
 {
+    statistics.recordWrite(newValue.size());
     QByteArray packet(WRITE_REQUEST_HEADER_SIZE + newValue.size(), Qt::Uninitialized);
     putBtData(valueHandle, packet.data() + 1);
     memcpy(packet.data() + 3, newValue.constData(), newValue.size());
@@ -2609,12 +2892,12 @@ void QLowEnergyControllerPrivateBluez::writeCharacteristicForCentral(const QShar
         break;
     case QLowEnergyService::WriteSigned:
         packet[0] = static_cast<quint8>(QBluezConst::AttCommand::ATT_OP_SIGNED_WRITE_COMMAND);
-        if (!isBonded()) {
+        if (sessions.empty() || !isBonded(*sessions.front())) {
             qCWarning(QT_BT_BLUEZ) << "signed write not possible: requires bond between devices";
             service->setError(QLowEnergyService::CharacteristicWriteError);
             return;
         }
-        if (securityLevel() >= BT_SECURITY_MEDIUM) {
+        if (linkSecurityLevel(*sessions.front()) >= BT_SECURITY_MEDIUM) {
             qCWarning(QT_BT_BLUEZ) << "signed write not possible: not allowed on encrypted link";
             service->setError(QLowEnergyService::CharacteristicWriteError);
             return;
@@ -2630,7 +2913,7 @@ void QLowEnergyControllerPrivateBluez::writeCharacteristicForCentral(const QShar
         const quint64 mac = LeCmacCalculator().calculateMac(packet, signingDataIt.value().key);
         packet.resize(packet.size() + sizeof mac);
         putBtData(mac, packet.data() + packet.size() - sizeof mac);
-        storeSignCounter(LocalSigningKey);
+        storeSignCounter(LocalSigningKey, remoteDevice);
         break;
     }
 
@@ -2707,7 +2990,8 @@ void QLowEnergyControllerPrivateBluez::writeDescriptorForCentral(
     sendNextPendingRequest();
 }
 
-void QLowEnergyControllerPrivateBluez::handleWriteRequestOrCommand(const QByteArray &packet)
+void QLowEnergyControllerPrivateBluez::handleWriteRequestOrCommand(ServerSession &session,
+                                                                   const QByteArray &packet)
 {
     // Spec v4.2, Vol 3, Part F, 3.4.5.1-3
 
@@ -2715,37 +2999,37 @@ void QLowEnergyControllerPrivateBluez::handleWriteRequestOrCommand(const QByteAr
             == QBluezConst::AttCommand::ATT_OP_WRITE_REQUEST;
     const bool isSigned = static_cast<QBluezConst::AttCommand>(packet.at(0))
             == QBluezConst::AttCommand::ATT_OP_SIGNED_WRITE_COMMAND;
-    if (!checkPacketSize(packet, isSigned ? 15 : 3, mtuSize))
+    if (!checkPacketSize(session, packet, isSigned ? 15 : 3, session.mtuSize))
         return;
     const QLowEnergyHandle handle = bt_get_le16(packet.constData() + 1);
     qCDebug(QT_BT_BLUEZ) << "client sends" << (isSigned ? "signed" : "") << "write"
                          << (isRequest ? "request" : "command") << "for handle" << handle;
 
-    if (!checkHandle(packet, handle))
+    if (!checkHandle(session, packet, handle))
         return;
 
     Attribute &attribute = localAttributes[handle];
     const QLowEnergyCharacteristic::PropertyType type = isRequest
             ? QLowEnergyCharacteristic::Write : isSigned
               ? QLowEnergyCharacteristic::WriteSigned : QLowEnergyCharacteristic::WriteNoResponse;
-    const QBluezConst::AttError permissionsError = checkPermissions(attribute, type);
+    const QBluezConst::AttError permissionsError = checkPermissions(session, attribute, type);
     if (permissionsError != QBluezConst::AttError::ATT_ERROR_NO_ERROR) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
                           permissionsError);
         return;
     }
 
     int valueLength;
     if (isSigned) {
-        if (!isBonded()) {
+        if (!isBonded(session)) {
             qCWarning(QT_BT_BLUEZ) << "Ignoring signed write from non-bonded device.";
             return;
         }
-        if (securityLevel() >= BT_SECURITY_MEDIUM) {
+        if (linkSecurityLevel(session) >= BT_SECURITY_MEDIUM) {
             qCWarning(QT_BT_BLUEZ) << "Ignoring signed write on encrypted link.";
             return;
         }
-        const auto signingDataIt = signingData.find(remoteDevice.toUInt64());
+        const auto signingDataIt = signingData.find(session.remoteDevice.toUInt64());
         if (signingDataIt == signingData.constEnd()) {
             qCWarning(QT_BT_BLUEZ) << "No CSRK found for peer device, ignoring signed write";
             return;
@@ -2765,19 +3049,23 @@ void QLowEnergyControllerPrivateBluez::handleWriteRequestOrCommand(const QByteAr
                 signingDataIt.value().key, signCounter, macFromClient);
         if (!signatureCorrect) {
             qCWarning(QT_BT_BLUEZ) << "Signed Write packet has wrong signature, disconnecting";
-            disconnectFromDevice(); // Recommended by spec v4.2, Vol 3, part C, 10.4.2
+            // Recommended by spec v4.2, Vol 3, part C, 10.4.2
+            if (sessions.size() > 1)
+                closeSession(&session);
+            else
+                disconnectFromDevice();
             return;
         }
 
         signingDataIt.value().counter = signCounter;
-        storeSignCounter(RemoteSigningKey);
+        storeSignCounter(RemoteSigningKey, session.remoteDevice);
         valueLength = packet.size() - 15;
     } else {
         valueLength = packet.size() - 3;
     }
 
     if (valueLength > attribute.maxLength) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
                           QBluezConst::AttError::ATT_ERROR_INVAL_ATTR_VALUE_LEN);
         return;
     }
@@ -2785,17 +3073,20 @@ void QLowEnergyControllerPrivateBluez::handleWriteRequestOrCommand(const QByteAr
     // If the attribute value has a fixed size and the value in the packet is shorter,
     // then we overwrite only the start of the attribute value and keep the rest.
     QByteArray value = packet.mid(3, valueLength);
-    if (attribute.minLength == attribute.maxLength && valueLength < attribute.minLength)
-        value += attribute.value.mid(valueLength, attribute.maxLength - valueLength);
+    if (attribute.minLength == attribute.maxLength && valueLength < attribute.minLength) {
+        value += attributeValue(session, attribute)
+                         .mid(valueLength, attribute.maxLength - valueLength);
+    }
 
     QLowEnergyCharacteristic characteristic;
     QLowEnergyDescriptor descriptor;
-    updateLocalAttributeValue(handle, value, characteristic, descriptor);
+    updateLocalAttributeValue(session, handle, value, characteristic, descriptor);
+    statistics.recordWrite(value.size());
 
     if (isRequest) {
         const QByteArray response =
                 QByteArray(1, static_cast<quint8>(QBluezConst::AttCommand::ATT_OP_WRITE_RESPONSE));
-        sendPacket(response);
+        sendPacket(session.socket, response);
     }
 
     if (characteristic.isValid()) {
@@ -2806,65 +3097,69 @@ void QLowEnergyControllerPrivateBluez::handleWriteRequestOrCommand(const QByteAr
     }
 }
 
-void QLowEnergyControllerPrivateBluez::handlePrepareWriteRequest(const QByteArray &packet)
+void QLowEnergyControllerPrivateBluez::handlePrepareWriteRequest(ServerSession &session,
+                                                                 const QByteArray &packet)
 {
     // Spec v4.2, Vol 3, Part F, 3.4.6.1
 
-    if (!checkPacketSize(packet, 5, mtuSize))
+    if (!checkPacketSize(session, packet, 5, session.mtuSize))
         return;
     const quint16 handle = bt_get_le16(packet.constData() + 1);
     qCDebug(QT_BT_BLUEZ) << "client sends prepare write request for handle" << handle;
 
-    if (!checkHandle(packet, handle))
+    if (!checkHandle(session, packet, handle))
         return;
     const Attribute &attribute = localAttributes.at(handle);
     const QBluezConst::AttError permissionsError =
-            checkPermissions(attribute, QLowEnergyCharacteristic::Write);
+            checkPermissions(session, attribute, QLowEnergyCharacteristic::Write);
     if (permissionsError != QBluezConst::AttError::ATT_ERROR_NO_ERROR) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
                           permissionsError);
         return;
     }
-    if (openPrepareWriteRequests.size() >= maxPrepareQueueSize) {
-        sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
+    if (session.openPrepareWriteRequests.size() >= maxPrepareQueueSize) {
+        sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)), handle,
                           QBluezConst::AttError::ATT_ERROR_PREPARE_QUEUE_FULL);
         return;
     }
 
     // The value is not checked here, but on the Execute request.
-    openPrepareWriteRequests << WriteRequest(handle, bt_get_le16(packet.constData() + 3),
+    session.openPrepareWriteRequests << WriteRequest(handle, bt_get_le16(packet.constData() + 3),
                                                     packet.mid(5));
 
     QByteArray response = packet;
     response[0] = static_cast<quint8>(QBluezConst::AttCommand::ATT_OP_PREPARE_WRITE_RESPONSE);
-    sendPacket(response);
+    sendPacket(session.socket, response);
 }
 
-void QLowEnergyControllerPrivateBluez::handleExecuteWriteRequest(const QByteArray &packet)
+void QLowEnergyControllerPrivateBluez::handleExecuteWriteRequest(ServerSession &session,
+                                                                 const QByteArray &packet)
 {
     // Spec v4.2, Vol 3, Part F, 3.4.6.3
 
-    if (!checkPacketSize(packet, 2))
+    if (!checkPacketSize(session, packet, 2))
         return;
     const bool cancel = packet.at(1) == 0;
     qCDebug(QT_BT_BLUEZ) << "client sends execute write request; flag is"
                          << (cancel ? "cancel" : "flush");
 
-    QList<WriteRequest> requests = openPrepareWriteRequests;
-    openPrepareWriteRequests.clear();
+    QList<WriteRequest> requests = session.openPrepareWriteRequests;
+    session.openPrepareWriteRequests.clear();
     QList<QLowEnergyCharacteristic> characteristics;
     QList<QLowEnergyDescriptor> descriptors;
     if (!cancel) {
+        qsizetype writtenBytes = 0;
         for (const WriteRequest &request : std::as_const(requests)) {
-            Attribute &attribute = localAttributes[request.handle];
-            if (request.valueOffset > attribute.value.size()) {
-                sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)),
+            const Attribute &attribute = localAttributes.at(request.handle);
+            const QByteArray oldValue = attributeValue(session, attribute);
+            if (request.valueOffset > oldValue.size()) {
+                sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)),
                                   request.handle, QBluezConst::AttError::ATT_ERROR_INVALID_OFFSET);
                 return;
             }
-            const QByteArray newValue = attribute.value.left(request.valueOffset) + request.value;
+            const QByteArray newValue = oldValue.left(request.valueOffset) + request.value;
             if (newValue.size() > attribute.maxLength) {
-                sendErrorResponse(static_cast<QBluezConst::AttCommand>(packet.at(0)),
+                sendErrorResponse(session, static_cast<QBluezConst::AttCommand>(packet.at(0)),
                                   request.handle,
                                   QBluezConst::AttError::ATT_ERROR_INVAL_ATTR_VALUE_LEN);
                 return;
@@ -2873,7 +3168,9 @@ void QLowEnergyControllerPrivateBluez::handleExecuteWriteRequest(const QByteArra
             QLowEnergyDescriptor descriptor;
             // TODO: Redundant attribute lookup for the case of the same handle appearing
             //       more than once.
-            updateLocalAttributeValue(request.handle, newValue, characteristic, descriptor);
+            updateLocalAttributeValue(session, request.handle, newValue, characteristic,
+                                      descriptor);
+            writtenBytes += request.value.size();
             if (characteristic.isValid()) {
                 characteristics << characteristic;
             } else if (descriptor.isValid()) {
@@ -2881,18 +3178,24 @@ void QLowEnergyControllerPrivateBluez::handleExecuteWriteRequest(const QByteArra
                 descriptors << descriptor;
             }
         }
+        if (!requests.isEmpty())
+            statistics.recordWrite(writtenBytes);
     }
 
-    sendPacket(QByteArray(
+    sendPacket(session.socket, QByteArray(
             1, static_cast<quint8>(QBluezConst::AttCommand::ATT_OP_EXECUTE_WRITE_RESPONSE)));
 
     for (const QLowEnergyCharacteristic &characteristic : std::as_const(characteristics))
         emit characteristic.d_ptr->characteristicChanged(characteristic, characteristic.value());
-    for (const QLowEnergyDescriptor &descriptor : std::as_const(descriptors))
-        emit descriptor.d_ptr->descriptorWritten(descriptor, descriptor.value());
+    for (const QLowEnergyDescriptor &descriptor : std::as_const(descriptors)) {
+        // Client characteristic configurations are only stored in the session.
+        const QByteArray value = attributeValue(session, localAttributes.at(descriptor.handle()));
+        emit descriptor.d_ptr->descriptorWritten(descriptor, value);
+    }
 }
 
-void QLowEnergyControllerPrivateBluez::sendErrorResponse(QBluezConst::AttCommand request,
+void QLowEnergyControllerPrivateBluez::sendErrorResponse(ServerSession &session,
+                                                         QBluezConst::AttCommand request,
                                                          quint16 handle, QBluezConst::AttError code)
 {
     // An ATT command never receives an error response.
@@ -2908,16 +3211,18 @@ void QLowEnergyControllerPrivateBluez::sendErrorResponse(QBluezConst::AttCommand
     qCWarning(QT_BT_BLUEZ) << "sending error response; request:"
                            << request << "handle:" << handle
                            << "code:" << code;
-    sendPacket(packet);
+    sendPacket(session.socket, packet);
 }
 
-void QLowEnergyControllerPrivateBluez::sendListResponse(const QByteArray &packetStart,
+void QLowEnergyControllerPrivateBluez::sendListResponse(ServerSession &session,
+                                                        const QByteArray &packetStart,
                                                         qsizetype elemSize,
                                                         const QList<Attribute> &attributes,
                                                         const ElemWriter &elemWriter)
 {
     const qsizetype offset = packetStart.size();
-    const qsizetype elemCount = (std::min)(attributes.size(), (mtuSize - offset) / elemSize);
+    const qsizetype elemCount =
+            (std::min)(attributes.size(), (session.mtuSize - offset) / elemSize);
     const qsizetype totalPacketSize = offset + elemCount * elemSize;
     QByteArray response(totalPacketSize, Qt::Uninitialized);
     using namespace std;
@@ -2926,40 +3231,47 @@ void QLowEnergyControllerPrivateBluez::sendListResponse(const QByteArray &packet
     for_each(attributes.constBegin(), attributes.constBegin() + elemCount,
              [&data, elemWriter](const Attribute &attr) { elemWriter(attr, data); });
     qCDebug(QT_BT_BLUEZ) << "sending response:" << response.toHex();
-    sendPacket(response);
+    sendPacket(session.socket, response);
 }
 
-void QLowEnergyControllerPrivateBluez::sendNotification(QLowEnergyHandle handle)
+void QLowEnergyControllerPrivateBluez::sendNotification(ServerSession &session,
+                                                        QLowEnergyHandle handle)
 {
-    sendNotificationOrIndication(QBluezConst::AttCommand::ATT_OP_HANDLE_VAL_NOTIFICATION, handle);
+    sendNotificationOrIndication(session, QBluezConst::AttCommand::ATT_OP_HANDLE_VAL_NOTIFICATION,
+                                 handle);
 }
 
-void QLowEnergyControllerPrivateBluez::sendIndication(QLowEnergyHandle handle)
+void QLowEnergyControllerPrivateBluez::sendIndication(ServerSession &session,
+                                                      QLowEnergyHandle handle)
 {
-    Q_ASSERT(!indicationInFlight);
-    indicationInFlight = true;
-    sendNotificationOrIndication(QBluezConst::AttCommand::ATT_OP_HANDLE_VAL_INDICATION, handle);
+    Q_ASSERT(!session.indicationInFlight);
+    session.indicationInFlight = true;
+    sendNotificationOrIndication(session, QBluezConst::AttCommand::ATT_OP_HANDLE_VAL_INDICATION,
+                                 handle);
 }
 
-void QLowEnergyControllerPrivateBluez::sendNotificationOrIndication(QBluezConst::AttCommand opCode,
+void QLowEnergyControllerPrivateBluez::sendNotificationOrIndication(ServerSession &session,
+                                                                    QBluezConst::AttCommand opCode,
                                                                     QLowEnergyHandle handle)
 {
     Q_ASSERT(handle <= lastLocalHandle);
     const Attribute &attribute = localAttributes.at(handle);
-    const qsizetype maxValueLength = (std::min)(attribute.value.size(), qsizetype(mtuSize) - 3);
+    const qsizetype maxValueLength =
+            (std::min)(attribute.value.size(), qsizetype(session.mtuSize) - 3);
     QByteArray packet(3 + maxValueLength, Qt::Uninitialized);
     packet[0] = static_cast<quint8>(opCode);
     putBtData(handle, packet.data() + 1);
     using namespace std;
     memcpy(packet.data() + 3, attribute.value.constData(), maxValueLength);
     qCDebug(QT_BT_BLUEZ) << "sending notification/indication:" << packet.toHex();
-    sendPacket(packet);
+    statistics.recordNotification(maxValueLength);
+    sendPacket(session.socket, packet);
 }
 
-void QLowEnergyControllerPrivateBluez::sendNextIndication()
+void QLowEnergyControllerPrivateBluez::sendNextIndication(ServerSession &session)
 {
-    if (!scheduledIndications.isEmpty())
-        sendIndication(scheduledIndications.takeFirst());
+    if (!session.scheduledIndications.isEmpty())
+        sendIndication(session, session.scheduledIndications.takeFirst());
 }
 
 static QString nameOfRemoteCentral(const QBluetoothAddress &peerAddress)
@@ -2993,7 +3305,8 @@ static QString nameOfRemoteCentral(const QBluetoothAddress &peerAddress)
 
 void QLowEnergyControllerPrivateBluez::handleConnectionRequest()
 {
-    if (state != QLowEnergyController::AdvertisingState) {
+    if (state != QLowEnergyController::AdvertisingState
+            && state != QLowEnergyController::ConnectedState) {
         qCWarning(QT_BT_BLUEZ) << "Incoming connection request in unexpected state" << state;
         return;
     }
@@ -3010,41 +3323,243 @@ void QLowEnergyControllerPrivateBluez::handleConnectionRequest()
         return;
     }
 
-    remoteDevice = QBluetoothAddress(convertAddress(clientAddr.l2_bdaddr.b));
-    remoteName = nameOfRemoteCentral(remoteDevice);
-    qCDebug(QT_BT_BLUEZ) << "GATT connection from device" << remoteDevice << remoteName;
+    // Further centrals are accepted after advertising was started again
+    closeServerSocket();
+
+    const QBluetoothAddress address(convertAddress(clientAddr.l2_bdaddr.b));
+    ServerSession &session = acceptCentral(clientSocket, address);
+    session.remoteName = nameOfRemoteCentral(address);
+    qCDebug(QT_BT_BLUEZ) << "GATT connection from device" << address << session.remoteName;
 
-    if (connectionHandle == 0)
+    session.connectionHandle = incomingConnectionHandle;
+    incomingConnectionHandle = 0;
+    if (session.connectionHandle == 0)
         qCWarning(QT_BT_BLUEZ) << "Received client connection, but no connection complete event";
 
+    restoreClientConfigurations(session);
+    loadSigningDataIfNecessary(RemoteSigningKey, address);
+    centralConnected(session);
+}
+
+/*
+    Creates a socket for the connected \a socketDescriptor. Its signals are
+    connected by the caller.
+*/
+QBluetoothSocket *QLowEnergyControllerPrivateBluez::createL2cpSocket(int socketDescriptor)
+{
+    QBluetoothSocketPrivateBluez *rawSocketPrivate = new QBluetoothSocketPrivateBluez();
+    QBluetoothSocket *const socket = new QBluetoothSocket(
+                rawSocketPrivate, QBluetoothServiceInfo::L2capProtocol, this);
+    socket->d_ptr->lowEnergySocketType = addressType == QLowEnergyController::PublicAddress
+            ? BDADDR_LE_PUBLIC : BDADDR_LE_RANDOM;
+    socket->setSocketDescriptor(socketDescriptor, QBluetoothServiceInfo::L2capProtocol,
+                                QBluetoothSocket::SocketState::ConnectedState,
+                                QIODevice::ReadWrite | QIODevice::Unbuffered);
+    return socket;
+}
+
+/*
+    Creates the session of a central connected on \a socketDescriptor in the
+    peripheral role. The session owns its socket.
+*/
+QLowEnergyControllerPrivateBluez::ServerSession &
+QLowEnergyControllerPrivateBluez::acceptCentral(int socketDescriptor,
+                                                const QBluetoothAddress &address)
+{
+    QBluetoothSocket *const socket = createL2cpSocket(socketDescriptor);
+    connect(socket, &QBluetoothSocket::disconnected, this, [this, socket]() {
+        ServerSession *const session = sessionForSocket(socket);
+        if (!session)
+            return;
+        // The other centrals stay connected
+        if (sessions.size() > 1)
+            closeSession(session);
+        else
+            l2cpDisconnected();
+    });
+    connect(socket, &QBluetoothSocket::errorOccurred, this,
+            [this, socket](QBluetoothSocket::SocketError error) {
+                sessionErrorOccurred(socket, error);
+            });
+    connect(socket, &QIODevice::readyRead, this, [this, socket]() {
+        if (ServerSession *const session = sessionForSocket(socket))
+            processPacket(*session, socket->readAll(), 0);
+    });
+
+    ServerSession &session = addSession(socket, address);
+    refreshLinkState(session);
+    startAttReceiver(session);
+    return session;
+}
+
+/*
+    Handles the \a error of the \a socket of a central. The session is closed
+    once it is no longer in use, as a failed write reports the error while the
+    sessions are iterated or a packet of the session is processed.
+*/
+void QLowEnergyControllerPrivateBluez::sessionErrorOccurred(QBluetoothSocket *socket,
+                                                            QBluetoothSocket::SocketError error)
+{
+    if (sessionsInUse > 0) {
+        const QPointer<QBluetoothSocket> guardedSocket = socket;
+        QMetaObject::invokeMethod(this, [this, guardedSocket, error]() {
+            if (guardedSocket)
+                sessionErrorOccurred(guardedSocket, error);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    ServerSession *const session = sessionForSocket(socket);
+    if (!session)
+        return;
+    if (sessions.size() > 1) {
+        qCDebug(QT_BT_BLUEZ) << "l2cp socket error" << error
+                             << "on the connection to" << session->remoteDevice;
+        closeSession(session);
+    } else {
+        l2cpErrorChanged(error);
+    }
+}
+
+/*
+    Announces the connection of the central of \a session. The first central
+    connects the controller, the link profile is applied to the further ones.
+*/
+void QLowEnergyControllerPrivateBluez::centralConnected(ServerSession &session)
+{
+    Q_Q(QLowEnergyController);
+    if (sessions.size() == 1) {
+        updatePrimarySession();
+        setState(QLowEnergyController::ConnectedState);
+    } else if (linkProfile != QLowEnergyController::DefaultLinkProfile) {
+        applyLinkProfile(session.connectionHandle);
+    }
+    emit q->connected();
+}
+
+/*
+    Hands reading the socket of \a session over to the ATT I/O thread, if it
+    is enabled. Processing the packets stays in this thread.
+*/
+void QLowEnergyControllerPrivateBluez::startAttReceiver(ServerSession &session)
+{
+    if (!QLeAttReceiver::isEnabled())
+        return;
+    auto socketPrivate = qobject_cast<QBluetoothSocketPrivateBluez *>(session.socket->d_ptr);
+    const int socketDescriptor = session.socket->socketDescriptor();
+    if (!socketPrivate || socketDescriptor < 0)
+        return;
+
+    stopAttReceiver(session.attReceiver);
+    socketPrivate->setReadNotificationEnabled(false);
+    QLeAttReceiver *const receiver = new QLeAttReceiver(socketDescriptor);
+    session.attReceiver = receiver;
+
+    const QPointer<QBluetoothSocket> socket = session.socket;
+    const auto isConnected = [socket]() {
+        return socket && socket->state() == QBluetoothSocket::SocketState::ConnectedState;
+    };
+    connect(receiver, &QLeAttReceiver::packetsReceived, this, [=]() {
+        if (!isConnected())
+            return;
+        ServerSession *const current = sessionForSocket(socket);
+        if (current && current->attReceiver == receiver)
+            processReceivedPackets(*current);
+    });
+    connect(receiver, &QLeAttReceiver::readFailed, this, [=](int errorCode) {
+        // The socket reports the error and disconnects, as if it had read itself
+        if (isConnected())
+            socketPrivate->handleReadError(errorCode);
+    });
+    receiver->start();
+
+    // Read before the hand-over
+    if (session.socket->bytesAvailable() > 0)
+        processPacket(session, session.socket->readAll(), 0);
+}
+
+void QLowEnergyControllerPrivateBluez::processReceivedPackets(ServerSession &session)
+{
+    QBluetoothSocket *const socket = session.socket;
+    QList<QLeAttReceiver::Packet> packets = session.attReceiver->takePackets();
+    for (QLeAttReceiver::Packet &packet : packets) {
+        // Handling a packet may close the connection and release the session
+        ServerSession *const current = sessionForSocket(socket);
+        if (!current || socket->state() != QBluetoothSocket::SocketState::ConnectedState)
+            return;
+        processPacket(*current, std::move(packet.data), packet.receivedTimer.nsecsElapsed());
+    }
+}
+
+/*
+    Runs the ATT protocol on \a socketDescriptor, which must be a connected
+    socket preserving message boundaries. There is no HCI connection in this
+    case, so the link cannot be encrypted and link parameters cannot be changed.
+*/
+void QLowEnergyControllerPrivateBluez::connectToSocket(int socketDescriptor)
+{
+    // The local adapter is not needed, ignore errors caused by its absence
+    error = QLowEnergyController::NoError;
+    errorString.clear();
+
+    if (role == QLowEnergyController::PeripheralRole) {
+        centralConnected(acceptCentral(socketDescriptor, QBluetoothAddress()));
+        return;
+    }
+
+    setState(QLowEnergyController::ConnectingState);
+    createServicesForCentralIfRequired();
+
     if (l2cpSocket) {
         disconnect(l2cpSocket);
         if (l2cpSocket->isOpen())
             l2cpSocket->close();
-
         l2cpSocket->deleteLater();
-        l2cpSocket = nullptr;
     }
-    closeServerSocket();
-
-    QBluetoothSocketPrivateBluez *rawSocketPrivate = new QBluetoothSocketPrivateBluez();
-    l2cpSocket = new QBluetoothSocket(
-                rawSocketPrivate, QBluetoothServiceInfo::L2capProtocol, this);
+    l2cpSocket = createL2cpSocket(socketDescriptor);
     connect(l2cpSocket, &QBluetoothSocket::disconnected,
             this, &QLowEnergyControllerPrivateBluez::l2cpDisconnected);
-    connect(l2cpSocket, &QBluetoothSocket::errorOccurred, this,
-            &QLowEnergyControllerPrivateBluez::l2cpErrorChanged);
-    connect(l2cpSocket, &QIODevice::readyRead, this, &QLowEnergyControllerPrivateBluez::l2cpReadyRead);
-    l2cpSocket->d_ptr->lowEnergySocketType = addressType == QLowEnergyController::PublicAddress
-            ? BDADDR_LE_PUBLIC : BDADDR_LE_RANDOM;
-    l2cpSocket->setSocketDescriptor(clientSocket, QBluetoothServiceInfo::L2capProtocol,
-            QBluetoothSocket::SocketState::ConnectedState, QIODevice::ReadWrite | QIODevice::Unbuffered);
-    restoreClientConfigurations();
-    loadSigningDataIfNecessary(RemoteSigningKey);
+    connect(l2cpSocket, &QBluetoothSocket::errorOccurred,
+            this, &QLowEnergyControllerPrivateBluez::l2cpErrorChanged);
+    connect(l2cpSocket, &QIODevice::readyRead,
+            this, &QLowEnergyControllerPrivateBluez::l2cpReadyRead);
+    l2cpConnected();
+}
 
-    Q_Q(QLowEnergyController);
-    setState(QLowEnergyController::ConnectedState);
-    emit q->connected();
+/*
+    Connects \a central and \a peripheral using a SOCK_SEQPACKET socket pair.
+    Both controllers must use this backend and the central must be unconnected.
+    The services of the peripheral should be added before connecting the first
+    central, a connected peripheral serves each further central in a new session.
+
+    Returns \c true if the controllers were connected.
+*/
+bool QLowEnergyControllerPrivateBluez::connectOverSocketPair(QLowEnergyController *central,
+                                                             QLowEnergyController *peripheral)
+{
+    auto centralPrivate = qobject_cast<QLowEnergyControllerPrivateBluez *>(
+            QLowEnergyControllerPrivate::get(central));
+    auto peripheralPrivate = qobject_cast<QLowEnergyControllerPrivateBluez *>(
+            QLowEnergyControllerPrivate::get(peripheral));
+    if (!centralPrivate || !peripheralPrivate
+            || centralPrivate->role != QLowEnergyController::CentralRole
+            || peripheralPrivate->role != QLowEnergyController::PeripheralRole
+            || centralPrivate->state != QLowEnergyController::UnconnectedState
+            || (peripheralPrivate->state != QLowEnergyController::UnconnectedState
+                && peripheralPrivate->state != QLowEnergyController::ConnectedState)) {
+        qCWarning(QT_BT_BLUEZ) << "Cannot connect controllers over a socket pair";
+        return false;
+    }
+
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) == -1) {
+        qCWarning(QT_BT_BLUEZ) << "socketpair() failed:" << qt_error_string(errno);
+        return false;
+    }
+
+    peripheralPrivate->connectToSocket(fds[1]);
+    centralPrivate->connectToSocket(fds[0]);
+    return true;
 }
 
 void QLowEnergyControllerPrivateBluez::closeServerSocket()
@@ -3057,28 +3572,180 @@ void QLowEnergyControllerPrivateBluez::closeServerSocket()
     serverSocketNotifier = nullptr;
 }
 
-bool QLowEnergyControllerPrivateBluez::isBonded() const
+/*
+    Adds the session of the connection on \a socket to the device \a address.
+*/
+QLowEnergyControllerPrivateBluez::ServerSession &
+QLowEnergyControllerPrivateBluez::addSession(QBluetoothSocket *socket,
+                                             const QBluetoothAddress &address)
 {
-    // Pairing does not necessarily imply bonding, but we don't know whether the
-    // bonding flag was set in the original pairing request.
-    return QBluetoothLocalDevice(localAdapter).pairingStatus(remoteDevice)
-            != QBluetoothLocalDevice::Unpaired;
+    auto session = std::make_unique<ServerSession>();
+    session->socket = socket;
+    session->remoteDevice = address;
+    session->mtuSize = ATT_DEFAULT_LE_MTU;
+    sessions.push_back(std::move(session));
+    return *sessions.back();
 }
 
-QList<QLowEnergyControllerPrivateBluez::TempClientConfigurationData>
-QLowEnergyControllerPrivateBluez::gatherClientConfigData()
+/*
+    Closes the connection of \a session while other centrals stay connected.
+*/
+void QLowEnergyControllerPrivateBluez::closeSession(ServerSession *session)
 {
-    QList<TempClientConfigurationData> data;
+    Q_ASSERT(sessions.size() > 1);
+    qCDebug(QT_BT_BLUEZ) << "Closing the connection to central" << session->remoteDevice;
+    storeClientConfigurations(*session);
+
+    const auto it = std::find_if(sessions.begin(), sessions.end(),
+                                 [session](const std::unique_ptr<ServerSession> &s) {
+                                     return s.get() == session;
+                                 });
+    Q_ASSERT(it != sessions.end());
+    const std::unique_ptr<ServerSession> closedSession = std::move(*it);
+    sessions.erase(it);
+    releaseSession(*closedSession);
+    updatePrimarySession();
+}
+
+/*
+    Stops reading the socket of \a session and closes it, unless it is the
+    socket of the central role.
+*/
+void QLowEnergyControllerPrivateBluez::releaseSession(ServerSession &session)
+{
+    stopAttReceiver(session.attReceiver);
+    QBluetoothSocket *const socket = session.socket;
+    if (!socket || socket == l2cpSocket)
+        return;
+    disconnect(socket, nullptr, this, nullptr);
+    if (socket->isOpen())
+        socket->close();
+    socket->deleteLater();
+}
+
+/*
+    The controller reports the remote device, its name and the MTU of the
+    first central it is connected to.
+*/
+void QLowEnergyControllerPrivateBluez::updatePrimarySession()
+{
+    if (sessions.empty())
+        return;
+    const ServerSession &session = *sessions.front();
+    remoteDevice = session.remoteDevice;
+    remoteName = session.remoteName;
+    if (mtuSize != session.mtuSize) {
+        Q_Q(QLowEnergyController);
+        mtuSize = session.mtuSize;
+        emit q->mtuChanged(mtuSize);
+    }
+
+    // The local client characteristic configurations are the ones of the primary central
     for (const auto &service : std::as_const(localServices)) {
         for (auto charIt = service->characteristicList.begin();
              charIt != service->characteristicList.end(); ++charIt) {
             QLowEnergyServicePrivate::CharData &charData = charIt.value();
             for (auto descIt = charData.descriptorList.begin();
                  descIt != charData.descriptorList.end(); ++descIt) {
-                QLowEnergyServicePrivate::DescData &descData = descIt.value();
+                if (descIt.value().uuid
+                        != QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration) {
+                    continue;
+                }
+                Attribute &attribute = localAttributes[descIt.key()];
+                attribute.value = attributeValue(session, attribute);
+                descIt.value().value = attribute.value;
+            }
+        }
+    }
+}
+
+QLowEnergyControllerPrivateBluez::ServerSession *
+QLowEnergyControllerPrivateBluez::sessionForSocket(const QBluetoothSocket *socket) const
+{
+    for (const auto &session : sessions) {
+        if (session->socket == socket)
+            return session.get();
+    }
+    return nullptr;
+}
+
+QLowEnergyControllerPrivateBluez::ServerSession *
+QLowEnergyControllerPrivateBluez::sessionForAddress(const QBluetoothAddress &address) const
+{
+    for (const auto &session : sessions) {
+        if (session->remoteDevice == address)
+            return session.get();
+    }
+    return nullptr;
+}
+
+QLowEnergyControllerPrivateBluez::ServerSession *
+QLowEnergyControllerPrivateBluez::sessionForHandle(quint16 handle) const
+{
+    for (const auto &session : sessions) {
+        if (session->connectionHandle == handle)
+            return session.get();
+    }
+    return nullptr;
+}
+
+// Returns true if the HCI connection handle belongs to a connection of this controller
+bool QLowEnergyControllerPrivateBluez::ownsConnectionHandle(quint16 handle) const
+{
+    if (handle == 0)
+        return false;
+    if (role == QLowEnergyController::CentralRole)
+        return handle == connectionHandle;
+    return sessionForHandle(handle) != nullptr;
+}
+
+bool QLowEnergyControllerPrivateBluez::isConnectedCentral(quint64 address) const
+{
+    if (state != QLowEnergyController::ConnectedState)
+        return false;
+    return std::any_of(sessions.cbegin(), sessions.cend(),
+                       [address](const std::unique_ptr<ServerSession> &session) {
+                           return session->remoteDevice.toUInt64() == address;
+                       });
+}
+
+bool QLowEnergyControllerPrivateBluez::isBonded(ServerSession &session)
+{
+    if (session.bondedValue)
+        return *session.bondedValue;
+
+    if (!localDevice) {
+        localDevice = new QBluetoothLocalDevice(localAdapter, this);
+        connect(localDevice, &QBluetoothLocalDevice::pairingFinished, this,
+                [this](const QBluetoothAddress &address, QBluetoothLocalDevice::Pairing pairing) {
+                    const bool bonded = pairing != QBluetoothLocalDevice::Unpaired;
+                    for (const auto &session : std::as_const(sessions)) {
+                        if (session->remoteDevice == address)
+                            session->bondedValue = bonded;
+                    }
+                });
+    }
+
+    // Pairing does not necessarily imply bonding, but we don't know whether the
+    // bonding flag was set in the original pairing request.
+    session.bondedValue = localDevice->pairingStatus(session.remoteDevice)
+            != QBluetoothLocalDevice::Unpaired;
+    return *session.bondedValue;
+}
+
+QList<QLowEnergyControllerPrivateBluez::TempClientConfigurationData>
+QLowEnergyControllerPrivateBluez::gatherClientConfigData() const
+{
+    QList<TempClientConfigurationData> data;
+    for (const auto &service : std::as_const(localServices)) {
+        for (auto charIt = service->characteristicList.cbegin();
+             charIt != service->characteristicList.cend(); ++charIt) {
+            const QLowEnergyServicePrivate::CharData &charData = charIt.value();
+            for (auto descIt = charData.descriptorList.cbegin();
+                 descIt != charData.descriptorList.cend(); ++descIt) {
+                const QLowEnergyServicePrivate::DescData &descData = descIt.value();
                 if (descData.uuid == QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration) {
-                    data << TempClientConfigurationData(&descData, charData.valueHandle,
-                                                        descIt.key());
+                    data << TempClientConfigurationData(charData.valueHandle, descIt.key());
                     break;
                 }
             }
@@ -3087,66 +3754,69 @@ QLowEnergyControllerPrivateBluez::gatherClientConfigData()
     return data;
 }
 
-void QLowEnergyControllerPrivateBluez::storeClientConfigurations()
+void QLowEnergyControllerPrivateBluez::storeClientConfigurations(ServerSession &session)
 {
-    if (!isBonded()) {
-        clientConfigData.remove(remoteDevice.toUInt64());
+    if (!isBonded(session)) {
+        clientConfigData.remove(session.remoteDevice.toUInt64());
         return;
     }
     QList<ClientConfigurationData> clientConfigs;
     const QList<TempClientConfigurationData> &tempConfigList = gatherClientConfigData();
     for (const auto &tempConfigData : tempConfigList) {
-        Q_ASSERT(tempConfigData.descData->value.size() == 2);
-        const quint16 value = bt_get_le16(tempConfigData.descData->value.constData());
+        const QByteArray configValue =
+                attributeValue(session, localAttributes.at(tempConfigData.configHandle));
+        if (configValue.size() != 2)
+            continue;
+        const quint16 value = bt_get_le16(configValue.constData());
         if (value != 0) {
             clientConfigs << ClientConfigurationData(tempConfigData.charValueHandle,
                                                      tempConfigData.configHandle, value);
         }
     }
-    clientConfigData.insert(remoteDevice.toUInt64(), clientConfigs);
+    clientConfigData.insert(session.remoteDevice.toUInt64(), clientConfigs);
 }
 
-void QLowEnergyControllerPrivateBluez::restoreClientConfigurations()
+void QLowEnergyControllerPrivateBluez::restoreClientConfigurations(ServerSession &session)
 {
     const QList<TempClientConfigurationData> &tempConfigList = gatherClientConfigData();
-    const QList<ClientConfigurationData> &restoredClientConfigs = isBonded()
-            ? clientConfigData.value(remoteDevice.toUInt64())
+    const QList<ClientConfigurationData> &restoredClientConfigs = isBonded(session)
+            ? clientConfigData.value(session.remoteDevice.toUInt64())
             : QList<ClientConfigurationData>();
     QList<QLowEnergyHandle> notifications;
+    session.clientConfigValues.clear();
     for (const auto &tempConfigData : tempConfigList) {
-        bool wasRestored = false;
+        Q_ASSERT(lastLocalHandle >= tempConfigData.configHandle);
+        Q_ASSERT(tempConfigData.configHandle > tempConfigData.charValueHandle);
         for (const auto &restoredData : restoredClientConfigs) {
             if (restoredData.charValueHandle == tempConfigData.charValueHandle) {
-                Q_ASSERT(tempConfigData.descData->value.size() == 2);
-                putBtData(restoredData.configValue, tempConfigData.descData->value.data());
-                wasRestored = true;
+                QByteArray value(2, Qt::Uninitialized);
+                putBtData(restoredData.configValue, value.data());
+                session.clientConfigValues.insert(tempConfigData.configHandle, value);
                 if (restoredData.charValueWasUpdated) {
                     if (isNotificationEnabled(restoredData.configValue))
                         notifications << restoredData.charValueHandle;
                     else if (isIndicationEnabled(restoredData.configValue))
-                        scheduledIndications << restoredData.charValueHandle;
+                        session.scheduledIndications << restoredData.charValueHandle;
                 }
                 break;
             }
         }
-        if (!wasRestored)
-            tempConfigData.descData->value = QByteArray(2, 0); // Default value.
-        Q_ASSERT(lastLocalHandle >= tempConfigData.configHandle);
-        Q_ASSERT(tempConfigData.configHandle > tempConfigData.charValueHandle);
-        localAttributes[tempConfigData.configHandle].value = tempConfigData.descData->value;
     }
 
+    ++sessionsInUse;
+    const auto inUse = qScopeGuard([this]() { --sessionsInUse; });
     for (const QLowEnergyHandle handle : std::as_const(notifications))
-        sendNotification(handle);
-    sendNextIndication();
+        sendNotification(session, handle);
+    sendNextIndication(session);
 }
 
-void QLowEnergyControllerPrivateBluez::loadSigningDataIfNecessary(SigningKeyType keyType)
+void QLowEnergyControllerPrivateBluez::loadSigningDataIfNecessary(SigningKeyType keyType,
+                                                                  const QBluetoothAddress &address)
 {
-    const auto signingDataIt = signingData.constFind(remoteDevice.toUInt64());
+    const auto signingDataIt = signingData.constFind(address.toUInt64());
     if (signingDataIt != signingData.constEnd())
         return; // We are up to date for this device.
-    const QString settingsFilePath = keySettingsFilePath();
+    const QString settingsFilePath = keySettingsFilePath(address);
     if (!QFileInfo(settingsFilePath).exists()) {
         qCDebug(QT_BT_BLUEZ) << "No settings found for peer device.";
         return;
@@ -3170,15 +3840,16 @@ void QLowEnergyControllerPrivateBluez::loadSigningDataIfNecessary(SigningKeyType
     using namespace std;
     BluezUint128 csrk;
     memcpy(csrk.data, keyData.constData(), keyData.size());
-    signingData.insert(remoteDevice.toUInt64(), SigningData(csrk, counter - 1));
+    signingData.insert(address.toUInt64(), SigningData(csrk, counter - 1));
 }
 
-void QLowEnergyControllerPrivateBluez::storeSignCounter(SigningKeyType keyType) const
+void QLowEnergyControllerPrivateBluez::storeSignCounter(SigningKeyType keyType,
+                                                        const QBluetoothAddress &address) const
 {
-    const auto signingDataIt = signingData.constFind(remoteDevice.toUInt64());
+    const auto signingDataIt = signingData.constFind(address.toUInt64());
     if (signingDataIt == signingData.constEnd())
         return;
-    const QString settingsFilePath = keySettingsFilePath();
+    const QString settingsFilePath = keySettingsFilePath(address);
     if (!QFileInfo(settingsFilePath).exists())
         return;
     QSettings settings(settingsFilePath, QSettings::IniFormat);
@@ -3199,10 +3870,11 @@ QString QLowEnergyControllerPrivateBluez::signingKeySettingsGroup(SigningKeyType
     return QLatin1String(keyType == LocalSigningKey ? "LocalSignatureKey" : "RemoteSignatureKey");
 }
 
-QString QLowEnergyControllerPrivateBluez::keySettingsFilePath() const
+QString QLowEnergyControllerPrivateBluez::keySettingsFilePath(
+        const QBluetoothAddress &address) const
 {
     return QString::fromLatin1("/var/lib/bluetooth/%1/%2/info")
-            .arg(localAdapter.toString(), remoteDevice.toString());
+            .arg(localAdapter.toString(), address.toString());
 }
 
 static QByteArray uuidToByteArray(const QBluetoothUuid &uuid)
@@ -3320,6 +3992,8 @@ void QLowEnergyControllerPrivateBluez::addToGenericAttributeList(const QLowEnerg
                                        << "bytes";
                 attribute.value = QByteArray(attribute.minLength, 0);
             }
+            if (attribute.type == QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration)
+                clientConfigDefaults.insert(attribute.handle, attribute.value);
             localAttributes[attribute.handle] = attribute;
         }
     }
@@ -3358,7 +4032,8 @@ void QLowEnergyControllerPrivateBluez::ensureUniformValueSizes(QList<Attribute>
 }
 
 QList<QLowEnergyControllerPrivateBluez::Attribute>
-QLowEnergyControllerPrivateBluez::getAttributes(QLowEnergyHandle startHandle,
+QLowEnergyControllerPrivateBluez::getAttributes(const ServerSession &session,
+                                                QLowEnergyHandle startHandle,
                                                 QLowEnergyHandle endHandle,
                                                 const AttributePredicate &attributePredicate)
 {
@@ -3372,14 +4047,34 @@ QLowEnergyControllerPrivateBluez::getAttributes(QLowEnergyHandle startHandle,
     const QLowEnergyHandle lastHandle = qMin(endHandle, lastLocalHandle);
     for (QLowEnergyHandle i = firstHandle; i <= lastHandle; ++i) {
         const Attribute &attr = localAttributes.at(i);
-        if (attributePredicate(attr))
-            results << attr;
+        if (attr.type != QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration) {
+            if (attributePredicate(attr))
+                results << attr;
+            continue;
+        }
+        // The client characteristic configuration is the one of the requesting client
+        Attribute clientConfig = attr;
+        clientConfig.value = attributeValue(session, attr);
+        if (attributePredicate(clientConfig))
+            results << clientConfig;
     }
     return results;
 }
 
+QByteArray QLowEnergyControllerPrivateBluez::attributeValue(const ServerSession &session,
+                                                            const Attribute &attribute) const
+{
+    if (attribute.type != QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration)
+        return attribute.value;
+    const auto it = session.clientConfigValues.constFind(attribute.handle);
+    if (it != session.clientConfigValues.cend())
+        return *it;
+    return clientConfigDefaults.value(attribute.handle, QByteArray(2, 0));
+}
+
 QBluezConst::AttError
-QLowEnergyControllerPrivateBluez::checkPermissions(const Attribute &attr,
+QLowEnergyControllerPrivateBluez::checkPermissions(const ServerSession &session,
+                                                   const Attribute &attr,
                                                    QLowEnergyCharacteristic::PropertyType type)
 {
     const bool isReadAccess = type == QLowEnergyCharacteristic::Read;
@@ -3396,7 +4091,7 @@ QLowEnergyControllerPrivateBluez::checkPermissions(const Attribute &attr,
         // can also be used if the link is encrypted.
         const bool unsignedWriteOk = isWriteCommand
                 && (attr.properties & QLowEnergyCharacteristic::WriteSigned)
-                && securityLevel() >= BT_SECURITY_MEDIUM;
+                && linkSecurityLevel(session) >= BT_SECURITY_MEDIUM;
         if (!unsignedWriteOk)
             return QBluezConst::AttError::ATT_ERROR_WRITE_NOT_PERM;
     }
@@ -3406,23 +4101,26 @@ QLowEnergyControllerPrivateBluez::checkPermissions(const Attribute &attr,
         return QBluezConst::AttError::ATT_ERROR_INSUF_AUTHORIZATION; // TODO: emit signal (and offer
                                                                      // authorization function)?
     if (constraints.testFlag(AttAccessConstraint::AttEncryptionRequired)
-        && securityLevel() < BT_SECURITY_MEDIUM)
+        && linkSecurityLevel(session) < BT_SECURITY_MEDIUM)
         return QBluezConst::AttError::ATT_ERROR_INSUF_ENCRYPTION;
     if (constraints.testFlag(AttAccessConstraint::AttAuthenticationRequired)
-        && securityLevel() < BT_SECURITY_HIGH)
+        && linkSecurityLevel(session) < BT_SECURITY_HIGH)
         return QBluezConst::AttError::ATT_ERROR_INSUF_AUTHENTICATION;
     if (false)
         return QBluezConst::AttError::ATT_ERROR_INSUF_ENCR_KEY_SIZE;
     return QBluezConst::AttError::ATT_ERROR_NO_ERROR;
 }
 
-QBluezConst::AttError QLowEnergyControllerPrivateBluez::checkReadPermissions(const Attribute &attr)
+QBluezConst::AttError
+QLowEnergyControllerPrivateBluez::checkReadPermissions(const ServerSession &session,
+                                                       const Attribute &attr)
 {
-    return checkPermissions(attr, QLowEnergyCharacteristic::Read);
+    return checkPermissions(session, attr, QLowEnergyCharacteristic::Read);
 }
 
 QBluezConst::AttError
-QLowEnergyControllerPrivateBluez::checkReadPermissions(QList<Attribute> &attributes)
+QLowEnergyControllerPrivateBluez::checkReadPermissions(const ServerSession &session,
+                                                       QList<Attribute> &attributes)
 {
     if (attributes.isEmpty())
         return QBluezConst::AttError::ATT_ERROR_NO_ERROR;
@@ -3432,13 +4130,13 @@ QLowEnergyControllerPrivateBluez::checkReadPermissions(QList<Attribute> &attribu
     //       then that error is returned via an error response.
     //    2) If any other element of that list would cause a permissions error, then all
     //       attributes from this one on are not part of the result set, but no error is returned.
-    const QBluezConst::AttError error = checkReadPermissions(attributes.first());
+    const QBluezConst::AttError error = checkReadPermissions(session, attributes.first());
     if (error != QBluezConst::AttError::ATT_ERROR_NO_ERROR)
         return error;
-    const auto it =
-            std::find_if(attributes.begin() + 1, attributes.end(), [this](const Attribute &attr) {
-                return checkReadPermissions(attr) != QBluezConst::AttError::ATT_ERROR_NO_ERROR;
-            });
+    const auto it = std::find_if(attributes.begin() + 1, attributes.end(),
+                                 [this, &session](const Attribute &attr) {
+        return checkReadPermissions(session, attr) != QBluezConst::AttError::ATT_ERROR_NO_ERROR;
+    });
     if (it != attributes.end())
         attributes.erase(it, attributes.end());
     return QBluezConst::AttError::ATT_ERROR_NO_ERROR;
@@ -16,6 +16,7 @@
 //
 
 #include <qglobal.h>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QList>
 #include <QtCore/QQueue>
 #include <QtBluetooth/qbluetooth.h>
@@ -26,9 +27,14 @@
 
 #include <QtBluetooth/QBluetoothSocket>
 #include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
+class QBluetoothLocalDevice;
+class QLeAttReceiver;
 class QLowEnergyServiceData;
 class QTimer;
 
@@ -63,6 +69,7 @@ public:
     void stopAdvertising() override;
 
     void requestConnectionUpdate(const QLowEnergyConnectionParameters &params) override;
+    void applyLinkProfile() override;
 
     // read data
     void readCharacteristic(const QSharedPointer<QLowEnergyServicePrivate> service,
@@ -84,6 +91,14 @@ public:
                                    QLowEnergyHandle startHandle) override;
 
     int mtu() const override;
+    int pendingRequestCount() const override { return int(openRequests.size()); }
+    bool canAdvertiseWhileConnected() const override
+    { return role == QLowEnergyController::PeripheralRole; }
+
+    // Connects the controllers over a local socket pair instead of an L2CAP
+    // channel, so that the ATT implementation can be tested without hardware
+    Q_AUTOTEST_EXPORT static bool connectOverSocketPair(QLowEnergyController *central,
+                                                        QLowEnergyController *peripheral);
 
     struct Attribute {
         Attribute() : handle(0) {}
@@ -99,9 +114,13 @@ public:
         int maxLength;
     };
     QList<Attribute> localAttributes;
+    // configured client characteristic configurations, used until a central writes them
+    QHash<QLowEnergyHandle, QByteArray> clientConfigDefaults;
 
 private:
     quint16 connectionHandle = 0;
+    // the link profile waits for connectionHandle
+    bool linkProfilePending = false;
     QBluetoothSocket *l2cpSocket = nullptr;
     struct Request {
         QBluezConst::AttCommand command;
@@ -121,18 +140,11 @@ private:
         quint16 valueOffset;
         QByteArray value;
     };
-    QList<WriteRequest> openPrepareWriteRequests;
-
-    // Invariant: !scheduledIndications.isEmpty => indicationInFlight == true
-    QList<QLowEnergyHandle> scheduledIndications;
-    bool indicationInFlight = false;
 
     struct TempClientConfigurationData {
-        TempClientConfigurationData(QLowEnergyServicePrivate::DescData *dd = nullptr,
-                                    QLowEnergyHandle chHndl = 0, QLowEnergyHandle coHndl = 0)
-            : descData(dd), charValueHandle(chHndl), configHandle(coHndl) {}
+        TempClientConfigurationData(QLowEnergyHandle chHndl = 0, QLowEnergyHandle coHndl = 0)
+            : charValueHandle(chHndl), configHandle(coHndl) {}
 
-        QLowEnergyServicePrivate::DescData *descData;
         QLowEnergyHandle charValueHandle;
         QLowEnergyHandle configHandle;
     };
@@ -160,11 +172,41 @@ private:
     QHash<quint64, SigningData> signingData;
     LeCmacCalculator *cmacCalculator = nullptr;
 
+    // The ATT connection to a remote device, one per central of a peripheral
+    // and the one of the l2cpSocket of a central. The attribute database is
+    // shared, everything else is per connection.
+    struct ServerSession {
+        QBluetoothSocket *socket = nullptr;
+        // reads socket on the ATT I/O thread, if it is enabled
+        QLeAttReceiver *attReceiver = nullptr;
+        QBluetoothAddress remoteDevice;
+        QString remoteName;
+        quint16 connectionHandle = 0;
+        quint16 mtuSize = 0;
+        bool receivedMtuExchangeRequest = false;
+        int securityLevelValue = -1;
+        // unknown until needed, forgotten when the link or its encryption changes
+        std::optional<bool> bondedValue;
+        QList<WriteRequest> openPrepareWriteRequests;
+        // Invariant: !scheduledIndications.isEmpty => indicationInFlight == true
+        QList<QLowEnergyHandle> scheduledIndications;
+        bool indicationInFlight = false;
+        // client characteristic configuration values by descriptor handle
+        QHash<QLowEnergyHandle, QByteArray> clientConfigValues;
+    };
+    // in the order of connection, the first one is reported by the public API
+    std::vector<std::unique_ptr<ServerSession>> sessions;
+    // socket errors are handled later while the sessions are in use
+    int sessionsInUse = 0;
+    // handle of the connection which is accepted next in the peripheral role
+    quint16 incomingConnectionHandle = 0;
+
     bool requestPending;
+    // started when the pending request is sent
+    QElapsedTimer requestElapsedTimer;
     quint16 mtuSize;
-    int securityLevelValue;
+    QBluetoothLocalDevice *localDevice = nullptr;
     bool encryptionChangePending;
-    bool receivedMtuExchangeRequest = false;
 
     std::shared_ptr<HciManager> hciManager;
     QLeAdvertiser *advertiser = nullptr;
@@ -191,19 +233,38 @@ private:
 
     void handleConnectionRequest();
     void closeServerSocket();
-
-    bool isBonded() const;
-    QList<TempClientConfigurationData> gatherClientConfigData();
-    void storeClientConfigurations();
-    void restoreClientConfigurations();
+    QBluetoothSocket *createL2cpSocket(int socketDescriptor);
+    void connectToSocket(int socketDescriptor);
+    void startAttReceiver(ServerSession &session);
+    void processReceivedPackets(ServerSession &session);
+
+    ServerSession &addSession(QBluetoothSocket *socket, const QBluetoothAddress &address);
+    ServerSession &acceptCentral(int socketDescriptor, const QBluetoothAddress &address);
+    void centralConnected(ServerSession &session);
+    void sessionErrorOccurred(QBluetoothSocket *socket, QBluetoothSocket::SocketError error);
+    void closeSession(ServerSession *session);
+    void releaseSession(ServerSession &session);
+    void updatePrimarySession();
+    ServerSession *sessionForSocket(const QBluetoothSocket *socket) const;
+    ServerSession *sessionForAddress(const QBluetoothAddress &address) const;
+    ServerSession *sessionForHandle(quint16 handle) const;
+    bool ownsConnectionHandle(quint16 handle) const;
+    bool isConnectedCentral(quint64 address) const;
+
+    bool isBonded(ServerSession &session);
+    QList<TempClientConfigurationData> gatherClientConfigData() const;
+    void storeClientConfigurations(ServerSession &session);
+    void restoreClientConfigurations(ServerSession &session);
 
     enum SigningKeyType { LocalSigningKey, RemoteSigningKey };
-    void loadSigningDataIfNecessary(SigningKeyType keyType);
-    void storeSignCounter(SigningKeyType keyType) const;
+    void loadSigningDataIfNecessary(SigningKeyType keyType, const QBluetoothAddress &address);
+    void storeSignCounter(SigningKeyType keyType, const QBluetoothAddress &address) const;
     QString signingKeySettingsGroup(SigningKeyType keyType) const;
-    QString keySettingsFilePath() const;
+    QString keySettingsFilePath(const QBluetoothAddress &address) const;
 
+    void processPacket(ServerSession &session, QByteArray incomingPacket, qint64 queuedNsecs);
     void sendPacket(const QByteArray &packet);
+    void sendPacket(QBluetoothSocket *socket, const QByteArray &packet);
     void sendNextPendingRequest();
     void processReply(const Request &request, const QByteArray &reply);
 
@@ -221,10 +282,13 @@ private:
     void discoverNextDescriptor(QSharedPointer<QLowEnergyServicePrivate> serviceData,
                                 const QList<QLowEnergyHandle> pendingCharHandles,
                                 QLowEnergyHandle startingHandle);
-    void processUnsolicitedReply(const QByteArray &msg);
+    void processUnsolicitedReply(QByteArray payload);
     void exchangeMTU();
     bool setSecurityLevel(int level);
-    int securityLevel() const;
+    int securityLevel(const ServerSession &session) const;
+    int linkSecurityLevel(const ServerSession &session) const;
+    void refreshLinkState(ServerSession &session);
+    void applyLinkProfile(quint16 handle);
     void sendExecuteWriteRequest(const QLowEnergyHandle attrHandle,
                                  const QByteArray &newValue,
                                  bool isCancelation);
@@ -236,34 +300,37 @@ private:
 
     void handleAdvertisingError();
 
-    bool checkPacketSize(const QByteArray &packet, int minSize, int maxSize = -1);
-    bool checkHandle(const QByteArray &packet, QLowEnergyHandle handle);
-    bool checkHandlePair(QBluezConst::AttCommand request, QLowEnergyHandle startingHandle,
-                         QLowEnergyHandle endingHandle);
-
-    void handleExchangeMtuRequest(const QByteArray &packet);
-    void handleFindInformationRequest(const QByteArray &packet);
-    void handleFindByTypeValueRequest(const QByteArray &packet);
-    void handleReadByTypeRequest(const QByteArray &packet);
-    void handleReadRequest(const QByteArray &packet);
-    void handleReadBlobRequest(const QByteArray &packet);
-    void handleReadMultipleRequest(const QByteArray &packet);
-    void handleReadByGroupTypeRequest(const QByteArray &packet);
-    void handleWriteRequestOrCommand(const QByteArray &packet);
-    void handlePrepareWriteRequest(const QByteArray &packet);
-    void handleExecuteWriteRequest(const QByteArray &packet);
-
-    void sendErrorResponse(QBluezConst::AttCommand request, quint16 handle,
-                           QBluezConst::AttError code);
+    bool checkPacketSize(ServerSession &session, const QByteArray &packet, int minSize,
+                         int maxSize = -1);
+    bool checkHandle(ServerSession &session, const QByteArray &packet, QLowEnergyHandle handle);
+    bool checkHandlePair(ServerSession &session, QBluezConst::AttCommand request,
+                         QLowEnergyHandle startingHandle, QLowEnergyHandle endingHandle);
+
+    void handleExchangeMtuRequest(ServerSession &session, const QByteArray &packet);
+    void handleFindInformationRequest(ServerSession &session, const QByteArray &packet);
+    void handleFindByTypeValueRequest(ServerSession &session, const QByteArray &packet);
+    void handleReadByTypeRequest(ServerSession &session, const QByteArray &packet);
+    void handleReadRequest(ServerSession &session, const QByteArray &packet);
+    void handleReadBlobRequest(ServerSession &session, const QByteArray &packet);
+    void handleReadMultipleRequest(ServerSession &session, const QByteArray &packet);
+    void handleReadByGroupTypeRequest(ServerSession &session, const QByteArray &packet);
+    void handleWriteRequestOrCommand(ServerSession &session, const QByteArray &packet);
+    void handlePrepareWriteRequest(ServerSession &session, const QByteArray &packet);
+    void handleExecuteWriteRequest(ServerSession &session, const QByteArray &packet);
+
+    void sendErrorResponse(ServerSession &session, QBluezConst::AttCommand request,
+                           quint16 handle, QBluezConst::AttError code);
 
     using ElemWriter = std::function<void(const Attribute &, char *&)>;
-    void sendListResponse(const QByteArray &packetStart, qsizetype elemSize,
-                          const QList<Attribute> &attributes, const ElemWriter &elemWriter);
+    void sendListResponse(ServerSession &session, const QByteArray &packetStart,
+                          qsizetype elemSize, const QList<Attribute> &attributes,
+                          const ElemWriter &elemWriter);
 
-    void sendNotification(QLowEnergyHandle handle);
-    void sendIndication(QLowEnergyHandle handle);
-    void sendNotificationOrIndication(QBluezConst::AttCommand opCode, QLowEnergyHandle handle);
-    void sendNextIndication();
+    void sendNotification(ServerSession &session, QLowEnergyHandle handle);
+    void sendIndication(ServerSession &session, QLowEnergyHandle handle);
+    void sendNotificationOrIndication(ServerSession &session, QBluezConst::AttCommand opCode,
+                                      QLowEnergyHandle handle);
+    void sendNextIndication(ServerSession &session);
 
     void ensureUniformAttributes(QList<Attribute> &attributes,
                                  const std::function<int(const Attribute &)> &getSize);
@@ -272,18 +339,23 @@ private:
 
     using AttributePredicate = std::function<bool(const Attribute &)>;
     QList<Attribute> getAttributes(
-            QLowEnergyHandle startHandle, QLowEnergyHandle endHandle,
+            const ServerSession &session, QLowEnergyHandle startHandle, QLowEnergyHandle endHandle,
             const AttributePredicate &attributePredicate = [](const Attribute &) { return true; });
+    // the value of attribute as seen by the client of session
+    QByteArray attributeValue(const ServerSession &session, const Attribute &attribute) const;
 
-    QBluezConst::AttError checkPermissions(const Attribute &attr,
+    QBluezConst::AttError checkPermissions(const ServerSession &session, const Attribute &attr,
                                            QLowEnergyCharacteristic::PropertyType type);
-    QBluezConst::AttError checkReadPermissions(const Attribute &attr);
-    QBluezConst::AttError checkReadPermissions(QList<Attribute> &attributes);
+    QBluezConst::AttError checkReadPermissions(const ServerSession &session,
+                                               const Attribute &attr);
+    QBluezConst::AttError checkReadPermissions(const ServerSession &session,
+                                               QList<Attribute> &attributes);
 
     bool verifyMac(const QByteArray &message, BluezUint128 csrk, quint32 signCounter,
                    quint64 expectedMac);
 
     void updateLocalAttributeValue(
+            ServerSession &session,
             QLowEnergyHandle handle,
             const QByteArray &value,
             QLowEnergyCharacteristic &characteristic,
@@ -4,6 +4,7 @@
 #include "qlowenergycontroller_bluezdbus_p.h"
 #include "bluez/adapter1_bluez5_p.h"
 #include "bluez/bluez5_helper_p.h"
+#include "bluez/bluez_data_p.h"
 #include "bluez/device1_bluez5_p.h"
 #include "bluez/gattservice1_p.h"
 #include "bluez/gattchar1_p.h"
@@ -151,7 +152,7 @@ void QLowEnergyControllerPrivateBluezDBus::devicePropertiesChanged(
             if (serviceData->state != QLowEnergyService::RemoteServiceDiscovered)
                 return;
 
-            QHash<QLowEnergyHandle, QLowEnergyServicePrivate::CharData>::iterator iter;
+            CharacteristicDataMap::iterator iter;
             iter = serviceData->characteristicList.begin();
             while (iter != serviceData->characteristicList.end()) {
                 auto &charData = iter.value();
@@ -206,6 +207,7 @@ void QLowEnergyControllerPrivateBluezDBus::characteristicPropertiesChanged(
         return;
 
     const QByteArray newValue = changedProperties.value(QStringLiteral("Value")).toByteArray();
+    statistics.recordNotification(newValue.size());
     if (changedChar.properties() & QLowEnergyCharacteristic::Read)
         updateValueOfCharacteristic(charHandle, newValue, false); //TODO upgrade to NEW_VALUE/APPEND_VALUE
 
@@ -784,6 +786,36 @@ void QLowEnergyControllerPrivateBluezDBus::prepareNextJob()
     scheduleNextJob(); // continue with next job - if available
 }
 
+/*
+    BlueZ hides the ATT requests of the GATT operations, record each job under
+    the opcode of the equivalent ATT request.
+*/
+void QLowEnergyControllerPrivateBluezDBus::recordJobStatistics(const GattJob &job,
+                                                               const QDBusError &error)
+{
+    QBluezConst::AttCommand opcode = QBluezConst::AttCommand::ATT_OP_READ_REQUEST;
+    if (job.flags.testFlag(GattJob::CharWrite) || job.flags.testFlag(GattJob::DescWrite)) {
+        statistics.recordWrite(job.value.size());
+        if (job.flags.testFlag(GattJob::DescWrite)
+                || job.writeMode == QLowEnergyService::WriteWithResponse) {
+            opcode = QBluezConst::AttCommand::ATT_OP_WRITE_REQUEST;
+        } else if (job.writeMode == QLowEnergyService::WriteWithoutResponse) {
+            opcode = QBluezConst::AttCommand::ATT_OP_WRITE_COMMAND;
+        } else {
+            opcode = QBluezConst::AttCommand::ATT_OP_SIGNED_WRITE_COMMAND;
+        }
+    }
+
+    if (jobElapsedTimer.isValid())
+        statistics.recordLatency(quint8(opcode), jobElapsedTimer.nsecsElapsed());
+    jobElapsedTimer.invalidate();
+
+    if (error.type() == QDBusError::NoReply || error.type() == QDBusError::Timeout)
+        ++statistics.requestTimeouts;
+    else if (error.isValid())
+        ++statistics.errorResponses;
+}
+
 void QLowEnergyControllerPrivateBluezDBus::onCharReadFinished(QDBusPendingCallWatcher *call)
 {
     if (!jobPending || jobs.isEmpty()) {
@@ -808,6 +840,7 @@ void QLowEnergyControllerPrivateBluezDBus::onCharReadFinished(QDBusPendingCallWa
 
     bool isServiceDiscovery = nextJob.flags.testFlag(GattJob::ServiceDiscovery);
     QDBusPendingReply<QByteArray> reply = *call;
+    recordJobStatistics(nextJob, reply.error());
     if (reply.isError()) {
         qCWarning(QT_BT_BLUEZ) << "Cannot initiate reading of" << charData.uuid
                                << "of service" << service->uuid
@@ -873,6 +906,7 @@ void QLowEnergyControllerPrivateBluezDBus::onDescReadFinished(QDBusPendingCallWa
     bool isServiceDiscovery = nextJob.flags.testFlag(GattJob::ServiceDiscovery);
 
     QDBusPendingReply<QByteArray> reply = *call;
+    recordJobStatistics(nextJob, reply.error());
     if (reply.isError()) {
         qCWarning(QT_BT_BLUEZ) << "Cannot read descriptor (onDescReadFinished 3): "
                              << charData.descriptorList[nextJob.handle].uuid
@@ -921,6 +955,7 @@ void QLowEnergyControllerPrivateBluezDBus::onCharWriteFinished(QDBusPendingCallW
                         service->characteristicList.value(nextJob.handle);
 
     QDBusPendingReply<> reply = *call;
+    recordJobStatistics(nextJob, reply.error());
     if (reply.isError()) {
         qCWarning(QT_BT_BLUEZ) << "Cannot initiate writing of" << charData.uuid
                                << "of service" << service->uuid
@@ -973,6 +1008,7 @@ void QLowEnergyControllerPrivateBluezDBus::onDescWriteFinished(QDBusPendingCallW
     }
 
     QDBusPendingReply<> reply = *call;
+    recordJobStatistics(nextJob, reply.error());
     if (reply.isError()) {
         qCWarning(QT_BT_BLUEZ) << "Cannot initiate writing of" << descriptor.uuid()
                                << "of char" << associatedChar.uuid()
@@ -1006,6 +1042,8 @@ void QLowEnergyControllerPrivateBluezDBus::scheduleNextJob()
     }
 
     const GattService &dbusServiceData = dbusServices[service->uuid];
+    statistics.recordRequest(jobs.size());
+    jobElapsedTimer.start();
 
     if (nextJob.flags.testFlag(GattJob::CharRead)) {
         // characteristic reading ***************************************
@@ -1425,6 +1463,7 @@ void QLowEnergyControllerPrivateBluezDBus::handlePeripheralApplicationRegistered
 void QLowEnergyControllerPrivateBluezDBus::handlePeripheralCharacteristicValueUpdate(
         QLowEnergyHandle handle, const QByteArray& value)
 {
+    statistics.recordWrite(value.size());
     const auto characteristic = characteristicForHandle(handle);
     if (characteristic.d_ptr
             && updateValueOfCharacteristic(handle, value, false) == value.size()) {
@@ -1439,6 +1478,7 @@ void QLowEnergyControllerPrivateBluezDBus::handlePeripheralDescriptorValueUpdate
         QLowEnergyHandle descriptorHandle,
         const QByteArray& value)
 {
+    statistics.recordWrite(value.size());
     const auto descriptor = descriptorForHandle(descriptorHandle);
     if (descriptor.d_ptr && updateValueOfDescriptor(
                 characteristicHandle, descriptorHandle, value, false) == value.size()) {
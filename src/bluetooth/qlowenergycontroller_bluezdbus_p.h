@@ -20,6 +20,8 @@
 #include "qlowenergycontrollerbase_p.h"
 #include "qleadvertiser_bluezdbus_p.h"
 
+#include <QtCore/QElapsedTimer>
+#include <QtDBus/QDBusError>
 #include <QtDBus/QDBusObjectPath>
 
 class OrgBluezAdapter1Interface;
@@ -84,6 +86,7 @@ public:
                         QLowEnergyHandle startHandle) override;
 
     int mtu() const override;
+    int pendingRequestCount() const override { return int(jobs.size()); }
 
 private:
     void connectToDeviceHelper();
@@ -170,8 +173,10 @@ private:
 
     QList<GattJob> jobs;
     bool jobPending = false;
+    QElapsedTimer jobElapsedTimer;
 
     void prepareNextJob();
+    void recordJobStatistics(const GattJob &job, const QDBusError &error);
     void discoverBatteryServiceDetails(GattService &dbusData,
                                        QSharedPointer<QLowEnergyServicePrivate> serviceData);
     void executeClose(QLowEnergyController::Error newError);
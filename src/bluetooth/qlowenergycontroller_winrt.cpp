@@ -410,7 +410,7 @@ public:
     QBluetoothUuid mService;
     QLowEnergyService::DiscoveryMode mMode;
     GattDeviceService mDeviceService;
-    QHash<QLowEnergyHandle, QLowEnergyServicePrivate::CharData> mCharacteristicList;
+    CharacteristicDataMap mCharacteristicList;
     uint mCharacteristicsCountToBeDiscovered = 0;
     quint16 mStartHandle = 0;
     quint16 mEndHandle = 0;
@@ -419,7 +419,7 @@ public:
 
 signals:
     void charListObtained(const QBluetoothUuid &service,
-                          QHash<QLowEnergyHandle, QLowEnergyServicePrivate::CharData> charList,
+                          CharacteristicDataMap charList,
                           QList<QBluetoothUuid> indicateChars, QLowEnergyHandle startHandle,
                           QLowEnergyHandle endHandle);
     void errorOccured(const QString &error);
@@ -1270,8 +1270,8 @@ void QLowEnergyControllerPrivateWinRT::discoverServiceDetailsHelper(
     connect(worker, &QWinRTLowEnergyServiceHandler::errorOccured,
             this, &QLowEnergyControllerPrivateWinRT::handleServiceHandlerError);
     connect(worker, &QWinRTLowEnergyServiceHandler::charListObtained, this,
-            [this](const QBluetoothUuid &service, QHash<QLowEnergyHandle,
-            QLowEnergyServicePrivate::CharData> charList, QList<QBluetoothUuid> indicateChars,
+            [this](const QBluetoothUuid &service, CharacteristicDataMap charList,
+            QList<QBluetoothUuid> indicateChars,
             QLowEnergyHandle startHandle, QLowEnergyHandle endHandle) {
         if (!serviceList.contains(service)) {
             qCWarning(QT_BT_WINDOWS)
@@ -98,23 +98,145 @@ void QLowEnergyControllerPrivate::setState(
     if (state == newState)
         return;
 
+    const QLowEnergyController::ControllerState oldState = state;
     state = newState;
     if (state == QLowEnergyController::UnconnectedState
             && role == QLowEnergyController::PeripheralRole) {
         remoteDevice.clear();
     }
+    // A new connection has been established
+    if (state == QLowEnergyController::ConnectedState
+            && (oldState == QLowEnergyController::ConnectingState
+                || oldState == QLowEnergyController::AdvertisingState)
+            && linkProfile != QLowEnergyController::DefaultLinkProfile) {
+        applyLinkProfile();
+    }
+    // Requests may be sent before the connected state is entered
+    if (state == QLowEnergyController::ConnectingState
+            || (state == QLowEnergyController::ConnectedState
+                && (oldState == QLowEnergyController::UnconnectedState
+                    || oldState == QLowEnergyController::AdvertisingState))) {
+        statistics.reset();
+    }
     emit q->stateChanged(state);
 }
 
+QLowEnergyConnectionParameters QLowEnergyControllerPrivate::connectionParametersForProfile(
+        QLowEnergyController::LinkProfile profile)
+{
+    QLowEnergyConnectionParameters params;
+    switch (profile) {
+    case QLowEnergyController::LowLatencyLinkProfile:
+        params.setIntervalRange(7.5, 15);
+        params.setLatency(0);
+        params.setSupervisionTimeout(2000);
+        break;
+    case QLowEnergyController::HighThroughputLinkProfile:
+        params.setIntervalRange(15, 30);
+        params.setLatency(0);
+        params.setSupervisionTimeout(4000);
+        break;
+    case QLowEnergyController::PowerSavingLinkProfile:
+        params.setIntervalRange(100, 200);
+        params.setLatency(4);
+        params.setSupervisionTimeout(6000);
+        break;
+    case QLowEnergyController::DefaultLinkProfile:
+        break;
+    }
+    return params;
+}
+
+void QLowEnergyControllerPrivate::applyLinkProfile()
+{
+    if (linkProfile == QLowEnergyController::DefaultLinkProfile)
+        return;
+
+    qCDebug(QT_BT) << "Applying link profile" << linkProfile;
+    requestConnectionUpdate(connectionParametersForProfile(linkProfile));
+}
+
+// Upper bound of the handle range covered by the dispatch table, to limit its
+// size for devices with sparse handles
+static constexpr qsizetype MaxHandleDispatchSize = 0x2000;
+
+void QLowEnergyControllerPrivate::buildHandleDispatch()
+{
+    handleDispatch = {};
+    handleDispatch.valid = true;
+
+    const ServiceDataMap &currentList = (role == QLowEnergyController::PeripheralRole)
+            ? localServices : serviceList;
+
+    QLowEnergyHandle first = 0xffff;
+    QLowEnergyHandle last = 0;
+    for (const auto &service : currentList) {
+        if (service->state != QLowEnergyService::RemoteServiceDiscovered
+                && service->state != QLowEnergyService::LocalService) {
+            continue;
+        }
+        if (service->startHandle == 0 || service->endHandle < service->startHandle)
+            continue;
+
+        handleDispatch.services.append(service);
+        first = qMin(first, service->startHandle);
+        last = qMax(last, service->endHandle);
+    }
+
+    if (handleDispatch.services.isEmpty()
+            || handleDispatch.services.size() >= HandleDispatchEntry::NoService
+            || last - first + 1 > MaxHandleDispatchSize) {
+        handleDispatch.services.clear();
+        return;
+    }
+
+    handleDispatch.firstHandle = first;
+    handleDispatch.entries.resize(last - first + 1);
+
+    for (qsizetype i = 0; i < handleDispatch.services.size(); ++i) {
+        const auto &service = handleDispatch.services.at(i);
+        auto &entries = handleDispatch.entries;
+        for (qsizetype h = service->startHandle; h <= service->endHandle; ++h)
+            entries[h - first].serviceIndex = quint16(i);
+
+        // A characteristic spans from its declaration up to the next one
+        const CharacteristicDataMap &characteristics = service->characteristicList;
+        for (auto charIt = characteristics.constBegin(); charIt != characteristics.constEnd();) {
+            const QLowEnergyHandle charHandle = charIt.key();
+            const qsizetype end = (++charIt != characteristics.constEnd()) ? charIt.key() - 1
+                                                                          : service->endHandle;
+            for (qsizetype h = qMax(charHandle, service->startHandle); h <= end; ++h)
+                entries[h - first].charHandle = charHandle;
+        }
+    }
+}
+
+const QLowEnergyControllerPrivate::HandleDispatchEntry *
+QLowEnergyControllerPrivate::handleDispatchEntry(QLowEnergyHandle handle)
+{
+    if (!handleDispatch.valid)
+        buildHandleDispatch();
+
+    const qsizetype index = qsizetype(handle) - handleDispatch.firstHandle;
+    if (index < 0 || index >= handleDispatch.entries.size())
+        return nullptr;
+
+    const HandleDispatchEntry &entry = handleDispatch.entries.at(index);
+    if (entry.serviceIndex == HandleDispatchEntry::NoService)
+        return nullptr;
+    return &entry;
+}
+
 QSharedPointer<QLowEnergyServicePrivate> QLowEnergyControllerPrivate::serviceForHandle(
         QLowEnergyHandle handle)
 {
-    ServiceDataMap &currentList = serviceList;
-    if (role == QLowEnergyController::PeripheralRole)
-        currentList = localServices;
+    if (const auto *entry = handleDispatchEntry(handle))
+        return handleDispatch.services.at(entry->serviceIndex);
+
+    const ServiceDataMap &currentList = (role == QLowEnergyController::PeripheralRole)
+            ? localServices : serviceList;
 
-    const QList<QSharedPointer<QLowEnergyServicePrivate>> values = currentList.values();
-    for (auto service: values)
+    for (const auto &service : currentList)
         if (service->startHandle <= handle && handle <= service->endHandle)
             return service;
 
@@ -128,6 +250,13 @@ QSharedPointer<QLowEnergyServicePrivate> QLowEnergyControllerPrivate::serviceFor
 QLowEnergyCharacteristic QLowEnergyControllerPrivate::characteristicForHandle(
         QLowEnergyHandle handle)
 {
+    if (const auto *entry = handleDispatchEntry(handle)) {
+        if (entry->charHandle == 0)
+            return QLowEnergyCharacteristic();
+        return QLowEnergyCharacteristic(handleDispatch.services.at(entry->serviceIndex),
+                                        entry->charHandle);
+    }
+
     QSharedPointer<QLowEnergyServicePrivate> service = serviceForHandle(handle);
     if (service.isNull())
         return QLowEnergyCharacteristic();
@@ -139,16 +268,17 @@ QLowEnergyCharacteristic QLowEnergyControllerPrivate::characteristicForHandle(
     if (service->characteristicList.contains(handle))
         return QLowEnergyCharacteristic(service, handle);
 
-    // check whether it is the handle of the characteristic value or its descriptors
-    QList<QLowEnergyHandle> charHandles = service->characteristicList.keys();
-    std::sort(charHandles.begin(), charHandles.end());
-    for (qsizetype i = charHandles.size() - 1; i >= 0; --i) {
-        if (charHandles.at(i) > handle)
-            continue;
-
-        return QLowEnergyCharacteristic(service, charHandles.at(i));
+    // check whether it is the handle of the characteristic value or its descriptors,
+    // the characteristics are sorted by handle
+    QLowEnergyHandle charHandle = 0;
+    for (auto charIt = service->characteristicList.constBegin();
+         charIt != service->characteristicList.constEnd() && charIt.key() <= handle; ++charIt) {
+        charHandle = charIt.key();
     }
 
+    if (charHandle)
+        return QLowEnergyCharacteristic(service, charHandle);
+
     return QLowEnergyCharacteristic();
 }
 
@@ -163,7 +293,7 @@ QLowEnergyDescriptor QLowEnergyControllerPrivate::descriptorForHandle(
     if (!matchingChar.isValid())
         return QLowEnergyDescriptor();
 
-    const QLowEnergyServicePrivate::CharData charData = matchingChar.
+    const QLowEnergyServicePrivate::CharData &charData = matchingChar.
             d_ptr->characteristicList[matchingChar.attributeHandle()];
 
     if (charData.descriptorList.contains(handle))
@@ -238,6 +368,7 @@ void QLowEnergyControllerPrivate::invalidateServices()
     serviceList.clear();
     localServices.clear();
     lastLocalHandle = {};
+    invalidateHandleDispatch();
 }
 
 QLowEnergyService *QLowEnergyControllerPrivate::addServiceHelper(
@@ -293,6 +424,7 @@ QLowEnergyService *QLowEnergyControllerPrivate::addServiceHelper(
                    << servicePrivate->uuid;
     }
     this->localServices.insert(servicePrivate->uuid, servicePrivate);
+    invalidateHandleDispatch();
 
     this->addToGenericAttributeList(service, servicePrivate->startHandle);
     return new QLowEnergyService(servicePrivate);
@@ -20,6 +20,7 @@
 
 #include <QtBluetooth/qlowenergycontroller.h>
 
+#include "qlowenergyconnectionstatistics_p.h"
 #include "qlowenergyserviceprivate_p.h"
 
 QT_BEGIN_NAMESPACE
@@ -38,6 +39,9 @@ public:
     QLowEnergyControllerPrivate();
     virtual ~QLowEnergyControllerPrivate();
 
+    static QLowEnergyControllerPrivate *get(QLowEnergyController *controller)
+    { return controller->d_func(); }
+
     // interface definition
     virtual void init() = 0;
     virtual void connectToDevice() = 0;
@@ -80,6 +84,15 @@ public:
 
     virtual int mtu() const = 0;
     virtual void readRssi();
+    // number of queued requests, including the one waiting for its response
+    virtual int pendingRequestCount() const { return 0; }
+    // whether a connected peripheral can accept further centrals
+    virtual bool canAdvertiseWhileConnected() const { return false; }
+
+    // applies the connection parameters of linkProfile, backends may apply more
+    virtual void applyLinkProfile();
+    static QLowEnergyConnectionParameters connectionParametersForProfile(
+                        QLowEnergyController::LinkProfile profile);
 
     virtual QLowEnergyService *addServiceHelper(
                         const QLowEnergyServiceData &service);
@@ -92,6 +105,9 @@ public:
     // public variables
     QLowEnergyController::Role role;
     QLowEnergyController::RemoteAddressType addressType;
+    QLowEnergyController::LinkProfile linkProfile = QLowEnergyController::DefaultLinkProfile;
+    // reset when a new connection is established
+    QLowEnergyConnectionStatisticsPrivate statistics;
 
     // list of all found service uuids on remote device
     ServiceDataMap serviceList;
@@ -110,6 +126,8 @@ public:
                                  const QByteArray &value,
                                  bool appendValue);
     void invalidateServices();
+    // must be called whenever services or their characteristics change
+    void invalidateHandleDispatch() { handleDispatch = {}; }
 
 protected:
     QLowEnergyController::ControllerState state = QLowEnergyController::UnconnectedState;
@@ -121,6 +139,29 @@ protected:
 
     QLowEnergyHandle lastLocalHandle{};
 
+    // Maps each handle of the fully discovered (or local) services directly
+    // to the service and the characteristic containing it. The table is
+    // rebuilt on the next lookup after it was invalidated, handles of services
+    // that are still being discovered fall back to a scan of the services.
+    struct HandleDispatchEntry
+    {
+        static constexpr quint16 NoService = 0xffff;
+
+        quint16 serviceIndex = NoService;
+        QLowEnergyHandle charHandle = 0; // 0 if not part of a characteristic
+    };
+    struct HandleDispatchTable
+    {
+        bool valid = false;
+        QLowEnergyHandle firstHandle = 0;
+        QList<HandleDispatchEntry> entries;
+        QList<QSharedPointer<QLowEnergyServicePrivate>> services;
+    };
+    HandleDispatchTable handleDispatch;
+
+    const HandleDispatchEntry *handleDispatchEntry(QLowEnergyHandle handle);
+    void buildHandleDispatch();
+
     QString remoteName; // device name of the remote
     QBluetoothUuid deviceUuid; // quite useless anywhere but Darwin (CoreBluetooth).
 
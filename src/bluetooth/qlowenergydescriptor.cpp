@@ -38,6 +38,24 @@ struct QLowEnergyDescriptorPrivate
     QLowEnergyHandle descHandle;
 };
 
+static const QLowEnergyServicePrivate::DescData *
+descriptorData(const QSharedPointer<QLowEnergyServicePrivate> &service,
+               const QLowEnergyDescriptorPrivate *data)
+{
+    if (service.isNull() || !data)
+        return nullptr;
+
+    const auto charIt = service->characteristicList.constFind(data->charHandle);
+    if (charIt == service->characteristicList.constEnd())
+        return nullptr;
+
+    const auto descIt = charIt->descriptorList.constFind(data->descHandle);
+    if (descIt == charIt->descriptorList.constEnd())
+        return nullptr;
+
+    return &descIt.value();
+}
+
 /*!
     Construct a new QLowEnergyDescriptor. A default-constructed instance
     of this class is always invalid.
@@ -187,14 +205,11 @@ bool QLowEnergyDescriptor::isValid() const
 */
 QBluetoothUuid QLowEnergyDescriptor::uuid() const
 {
-    if (d_ptr.isNull() || !data
-                       || !d_ptr->characteristicList.contains(data->charHandle)
-                       || !d_ptr->characteristicList[data->charHandle].
-                                        descriptorList.contains(data->descHandle)) {
+    const auto *descriptor = descriptorData(d_ptr, data);
+    if (!descriptor)
         return QBluetoothUuid();
-    }
 
-    return d_ptr->characteristicList[data->charHandle].descriptorList[data->descHandle].uuid;
+    return descriptor->uuid;
 }
 
 /*!
@@ -222,14 +237,11 @@ QLowEnergyHandle QLowEnergyDescriptor::handle() const
 */
 QByteArray QLowEnergyDescriptor::value() const
 {
-    if (d_ptr.isNull() || !data
-                       || !d_ptr->characteristicList.contains(data->charHandle)
-                       || !d_ptr->characteristicList[data->charHandle].
-                                        descriptorList.contains(data->descHandle)) {
+    const auto *descriptor = descriptorData(d_ptr, data);
+    if (!descriptor)
         return QByteArray();
-    }
 
-    return d_ptr->characteristicList[data->charHandle].descriptorList[data->descHandle].value;
+    return descriptor->value;
 }
 
 /*!
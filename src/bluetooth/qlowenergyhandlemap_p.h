@@ -0,0 +1,184 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QLOWENERGYHANDLEMAP_P_H
+#define QLOWENERGYHANDLEMAP_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtBluetooth/qbluetooth.h>
+#include <QtCore/QList>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Map from attribute handles to T, stored as an array sorted by handle.
+
+    The attributes of a service are few, are added mostly in handle order
+    during discovery and are looked up far more often than they change. This
+    makes a sorted array cheaper than a hash, and iterating it yields the
+    attributes in handle order without sorting.
+
+    The API is the subset of QHash used by the backends. Like with QHash,
+    inserting invalidates iterators and references into the map.
+*/
+template <typename T>
+class QLowEnergyHandleMap
+{
+    struct Entry
+    {
+        QLowEnergyHandle key;
+        T value;
+    };
+    using Entries = QList<Entry>;
+
+public:
+    class const_iterator;
+
+    class iterator
+    {
+        friend class QLowEnergyHandleMap;
+        friend class const_iterator;
+        typename Entries::iterator i;
+        explicit iterator(typename Entries::iterator it) : i(it) { }
+
+    public:
+        iterator() = default;
+
+        QLowEnergyHandle key() const { return i->key; }
+        T &value() const { return i->value; }
+        T &operator*() const { return i->value; }
+        T *operator->() const { return &i->value; }
+
+        iterator &operator++() { ++i; return *this; }
+        iterator operator++(int) { iterator r = *this; ++i; return r; }
+
+        friend bool operator==(const iterator &lhs, const iterator &rhs) { return lhs.i == rhs.i; }
+        friend bool operator!=(const iterator &lhs, const iterator &rhs) { return lhs.i != rhs.i; }
+    };
+
+    class const_iterator
+    {
+        friend class QLowEnergyHandleMap;
+        typename Entries::const_iterator i;
+        explicit const_iterator(typename Entries::const_iterator it) : i(it) { }
+
+    public:
+        const_iterator() = default;
+        const_iterator(const iterator &it) : i(it.i) { }
+
+        QLowEnergyHandle key() const { return i->key; }
+        const T &value() const { return i->value; }
+        const T &operator*() const { return i->value; }
+        const T *operator->() const { return &i->value; }
+
+        const_iterator &operator++() { ++i; return *this; }
+        const_iterator operator++(int) { const_iterator r = *this; ++i; return r; }
+
+        friend bool operator==(const const_iterator &lhs, const const_iterator &rhs)
+        { return lhs.i == rhs.i; }
+        friend bool operator!=(const const_iterator &lhs, const const_iterator &rhs)
+        { return lhs.i != rhs.i; }
+    };
+
+    qsizetype size() const { return m_entries.size(); }
+    qsizetype count() const { return m_entries.size(); }
+    bool isEmpty() const { return m_entries.isEmpty(); }
+    void clear() { m_entries.clear(); }
+
+    iterator begin() { return iterator(m_entries.begin()); }
+    iterator end() { return iterator(m_entries.end()); }
+    const_iterator begin() const { return const_iterator(m_entries.cbegin()); }
+    const_iterator end() const { return const_iterator(m_entries.cend()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_iterator constBegin() const { return begin(); }
+    const_iterator constEnd() const { return end(); }
+
+    iterator find(QLowEnergyHandle key)
+    {
+        const qsizetype index = indexOf(key);
+        return index < 0 ? end() : iterator(m_entries.begin() + index);
+    }
+    const_iterator find(QLowEnergyHandle key) const { return constFind(key); }
+    const_iterator constFind(QLowEnergyHandle key) const
+    {
+        const qsizetype index = indexOf(key);
+        return index < 0 ? end() : const_iterator(m_entries.cbegin() + index);
+    }
+
+    bool contains(QLowEnergyHandle key) const { return indexOf(key) >= 0; }
+
+    T value(QLowEnergyHandle key, const T &defaultValue = T()) const
+    {
+        const qsizetype index = indexOf(key);
+        return index < 0 ? defaultValue : m_entries.at(index).value;
+    }
+
+    T &operator[](QLowEnergyHandle key)
+    {
+        const qsizetype index = lowerBound(key);
+        if (index == m_entries.size() || m_entries.at(index).key != key)
+            m_entries.insert(index, Entry{ key, T() });
+        return m_entries[index].value;
+    }
+    T operator[](QLowEnergyHandle key) const { return value(key); }
+
+    iterator insert(QLowEnergyHandle key, const T &value)
+    {
+        const qsizetype index = lowerBound(key);
+        if (index < m_entries.size() && m_entries.at(index).key == key)
+            m_entries[index].value = value;
+        else
+            m_entries.insert(index, Entry{ key, value });
+        return iterator(m_entries.begin() + index);
+    }
+
+    QList<QLowEnergyHandle> keys() const
+    {
+        QList<QLowEnergyHandle> result;
+        result.reserve(m_entries.size());
+        for (const Entry &entry : m_entries)
+            result.append(entry.key);
+        return result;
+    }
+
+private:
+    qsizetype lowerBound(QLowEnergyHandle key) const
+    {
+        // Discovery adds attributes in handle order
+        if (m_entries.isEmpty() || m_entries.constLast().key < key)
+            return m_entries.size();
+
+        const auto it = std::lower_bound(m_entries.cbegin(), m_entries.cend(), key,
+                                         [](const Entry &entry, QLowEnergyHandle k) {
+                                             return entry.key < k;
+                                         });
+        return it - m_entries.cbegin();
+    }
+
+    qsizetype indexOf(QLowEnergyHandle key) const
+    {
+        const qsizetype index = lowerBound(key);
+        if (index == m_entries.size() || m_entries.at(index).key != key)
+            return -1;
+        return index;
+    }
+
+    Entries m_entries;
+};
+
+QT_END_NAMESPACE
+
+#endif // QLOWENERGYHANDLEMAP_P_H
@@ -360,6 +360,56 @@ QT_IMPL_METATYPE_EXTERN_TAGGED(QLowEnergyService::WriteMode, QLowEnergyService__
     \sa writeDescriptor()
  */
 
+/*!
+    \class QLowEnergyService::CharacteristicChange
+    \inmodule QtBluetooth
+    \since 6.9
+
+    \brief The CharacteristicChange struct describes a single characteristic change
+    delivered by the \l characteristicsChanged() signal.
+
+    \sa setCharacteristicChangeBatchingEnabled()
+ */
+
+/*!
+    \variable QLowEnergyService::CharacteristicChange::characteristic
+
+    The characteristic whose value changed.
+ */
+
+/*!
+    \variable QLowEnergyService::CharacteristicChange::offset
+
+    The offset of the new value in the \c values buffer of the
+    \l characteristicsChanged() signal.
+ */
+
+/*!
+    \variable QLowEnergyService::CharacteristicChange::length
+
+    The length of the new value in the \c values buffer of the
+    \l characteristicsChanged() signal.
+ */
+
+/*!
+    \variable QLowEnergyService::CharacteristicChange::timestamp
+
+    The time at which the change was received.
+ */
+
+/*!
+    \fn void QLowEnergyService::characteristicsChanged(const QList<QLowEnergyService::CharacteristicChange> &changes, const QByteArray &values)
+    \since 6.9
+
+    This signal is emitted instead of \l characteristicChanged() while
+    characteristic change batching is enabled. It delivers all \a changes
+    received during the \l {characteristicChangeBatchInterval()}{batch interval},
+    in the order they were received. The new values are stored one after another
+    in \a values, each change refers to its value by offset and length.
+
+    \sa setCharacteristicChangeBatchingEnabled()
+ */
+
 /*!
   \internal
 
@@ -381,8 +431,14 @@ QLowEnergyService::QLowEnergyService(QSharedPointer<QLowEnergyServicePrivate> p,
             &QLowEnergyService::errorOccurred);
     connect(p.data(), &QLowEnergyServicePrivate::stateChanged,
             this, &QLowEnergyService::stateChanged);
-    connect(p.data(), &QLowEnergyServicePrivate::characteristicChanged,
-            this, &QLowEnergyService::characteristicChanged);
+    connect(p.data(), &QLowEnergyServicePrivate::characteristicChanged, this,
+            [this](const QLowEnergyCharacteristic &characteristic, const QByteArray &value) {
+                // Batched changes are delivered by characteristicsChanged()
+                if (!d_ptr->changeBatchingEnabled)
+                    emit characteristicChanged(characteristic, value);
+            });
+    connect(p.data(), &QLowEnergyServicePrivate::characteristicsChanged,
+            this, &QLowEnergyService::characteristicsChanged);
     connect(p.data(), &QLowEnergyServicePrivate::characteristicWritten,
             this, &QLowEnergyService::characteristicWritten);
     connect(p.data(), &QLowEnergyServicePrivate::descriptorWritten,
@@ -503,12 +559,12 @@ QLowEnergyCharacteristic QLowEnergyService::characteristic(const QBluetoothUuid
 QList<QLowEnergyCharacteristic> QLowEnergyService::characteristics() const
 {
     QList<QLowEnergyCharacteristic> results;
-    QList<QLowEnergyHandle> handles = d_ptr->characteristicList.keys();
-    std::sort(handles.begin(), handles.end());
-
-    for (const QLowEnergyHandle &handle : std::as_const(handles)) {
-        QLowEnergyCharacteristic characteristic(d_ptr, handle);
-        results.append(characteristic);
+    // The characteristics are sorted by handle
+    const CharacteristicDataMap &characteristicList = d_ptr->characteristicList;
+    results.reserve(characteristicList.size());
+    for (auto charIt = characteristicList.constBegin(); charIt != characteristicList.constEnd();
+         ++charIt) {
+        results.append(QLowEnergyCharacteristic(d_ptr, charIt.key()));
     }
     return results;
 }
@@ -847,6 +903,70 @@ void QLowEnergyService::writeDescriptor(const QLowEnergyDescriptor &descriptor,
                                    newValue);
 }
 
+/*!
+    \since 6.9
+
+    Enables or disables the batching of characteristic changes, depending on
+    \a enabled. Batching is disabled by default.
+
+    While batching is enabled, the \l characteristicChanged() signal is not
+    emitted. Instead, the changes are collected and delivered together by the
+    \l characteristicsChanged() signal once the
+    \l {characteristicChangeBatchInterval()}{batch interval} has passed since
+    the first of them. This reduces the overhead per change for services
+    that notify many changes per second.
+
+    Disabling batching delivers the pending changes immediately. The setting
+    is shared by all QLowEnergyService instances of the same service.
+
+    \sa isCharacteristicChangeBatchingEnabled(), setCharacteristicChangeBatchInterval()
+ */
+void QLowEnergyService::setCharacteristicChangeBatchingEnabled(bool enabled)
+{
+    Q_D(QLowEnergyService);
+    d->setChangeBatchingEnabled(enabled);
+}
+
+/*!
+    \since 6.9
+
+    Returns \c true if characteristic changes are batched; otherwise \c false.
+
+    \sa setCharacteristicChangeBatchingEnabled()
+ */
+bool QLowEnergyService::isCharacteristicChangeBatchingEnabled() const
+{
+    return d_ptr->changeBatchingEnabled;
+}
+
+/*!
+    \since 6.9
+
+    Sets the time for which characteristic changes are collected before they
+    are delivered to \a interval. The default interval of \c 0 delivers the
+    changes received until control returns to the event loop.
+
+    \sa characteristicChangeBatchInterval(), setCharacteristicChangeBatchingEnabled()
+ */
+void QLowEnergyService::setCharacteristicChangeBatchInterval(std::chrono::milliseconds interval)
+{
+    Q_D(QLowEnergyService);
+    d->changeBatchTimer.setInterval(interval);
+}
+
+/*!
+    \since 6.9
+
+    Returns the time for which characteristic changes are collected before
+    they are delivered.
+
+    \sa setCharacteristicChangeBatchInterval()
+ */
+std::chrono::milliseconds QLowEnergyService::characteristicChangeBatchInterval() const
+{
+    return d_ptr->changeBatchTimer.intervalAsDuration();
+}
+
 QT_END_NAMESPACE
 
 #include "moc_qlowenergyservice.cpp"
@@ -8,6 +8,8 @@
 #include <QtBluetooth/QBluetoothUuid>
 #include <QtBluetooth/QLowEnergyCharacteristic>
 
+#include <chrono>
+
 QT_BEGIN_NAMESPACE
 
 class QLowEnergyServicePrivate;
@@ -71,6 +73,14 @@ public:
     };
     Q_ENUM(WriteMode)
 
+    struct CharacteristicChange
+    {
+        QLowEnergyCharacteristic characteristic;
+        qsizetype offset = 0;
+        qsizetype length = 0;
+        std::chrono::steady_clock::time_point timestamp;
+    };
+
     ~QLowEnergyService();
 
     QList<QBluetoothUuid> includedServices() const;
@@ -98,10 +108,17 @@ public:
     void writeDescriptor(const QLowEnergyDescriptor &descriptor,
                          const QByteArray &newValue);
 
+    void setCharacteristicChangeBatchingEnabled(bool enabled);
+    bool isCharacteristicChangeBatchingEnabled() const;
+    void setCharacteristicChangeBatchInterval(std::chrono::milliseconds interval);
+    std::chrono::milliseconds characteristicChangeBatchInterval() const;
+
 Q_SIGNALS:
     void stateChanged(QLowEnergyService::ServiceState newState);
     void characteristicChanged(const QLowEnergyCharacteristic &info,
                                const QByteArray &value);
+    void characteristicsChanged(const QList<QLowEnergyService::CharacteristicChange> &changes,
+                                const QByteArray &values);
     void characteristicRead(const QLowEnergyCharacteristic &info,
                             const QByteArray &value);
     void characteristicWritten(const QLowEnergyCharacteristic &info,
@@ -10,7 +10,16 @@ QT_BEGIN_NAMESPACE
 QT_IMPL_METATYPE_EXTERN_TAGGED(QSharedPointer<QLowEnergyServicePrivate>,
                                QSharedPointer_QLowEnergyServicePrivate)
 
-QLowEnergyServicePrivate::QLowEnergyServicePrivate(QObject *parent) : QObject(parent) { }
+QLowEnergyServicePrivate::QLowEnergyServicePrivate(QObject *parent) : QObject(parent)
+{
+    // By default the changes are collected until control returns to the event loop
+    changeBatchTimer.setSingleShot(true);
+    changeBatchTimer.setInterval(0);
+    connect(&changeBatchTimer, &QTimer::timeout,
+            this, &QLowEnergyServicePrivate::flushCharacteristicChanges);
+    connect(this, &QLowEnergyServicePrivate::characteristicChanged,
+            this, &QLowEnergyServicePrivate::appendCharacteristicChange);
+}
 
 QLowEnergyServicePrivate::~QLowEnergyServicePrivate()
 {
@@ -18,6 +27,8 @@ QLowEnergyServicePrivate::~QLowEnergyServicePrivate()
 
 void QLowEnergyServicePrivate::setController(QLowEnergyControllerPrivate *control)
 {
+    if (controller)
+        controller->invalidateHandleDispatch();
     controller = control;
 
     if (control)
@@ -38,9 +49,48 @@ void QLowEnergyServicePrivate::setState(QLowEnergyService::ServiceState newState
         return;
 
     state = newState;
+    // The handles of the service are only dispatched once it is discovered
+    if (controller)
+        controller->invalidateHandleDispatch();
     emit stateChanged(newState);
 }
 
+void QLowEnergyServicePrivate::setChangeBatchingEnabled(bool enabled)
+{
+    if (changeBatchingEnabled == enabled)
+        return;
+
+    changeBatchingEnabled = enabled;
+    if (!enabled)
+        flushCharacteristicChanges();
+}
+
+void QLowEnergyServicePrivate::appendCharacteristicChange(
+        const QLowEnergyCharacteristic &characteristic, const QByteArray &value)
+{
+    if (!changeBatchingEnabled)
+        return;
+
+    batchedChanges.append({ characteristic, batchedValues.size(), value.size(),
+                            std::chrono::steady_clock::now() });
+    batchedValues.append(value);
+
+    if (!changeBatchTimer.isActive())
+        changeBatchTimer.start();
+}
+
+void QLowEnergyServicePrivate::flushCharacteristicChanges()
+{
+    changeBatchTimer.stop();
+    if (batchedChanges.isEmpty())
+        return;
+
+    // The slots may change the batching settings, or append new changes
+    const auto changes = std::exchange(batchedChanges, {});
+    const auto values = std::exchange(batchedValues, {});
+    emit characteristicsChanged(changes, values);
+}
+
 QT_END_NAMESPACE
 
 #include "moc_qlowenergyserviceprivate_p.cpp"
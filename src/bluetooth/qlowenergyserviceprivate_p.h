@@ -17,11 +17,14 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
+#include <QtCore/QTimer>
 #include <QtBluetooth/qbluetooth.h>
 #include <QtBluetooth/QLowEnergyService>
 #include <QtBluetooth/QLowEnergyCharacteristic>
 #include <QtCore/private/qglobal_p.h>
 
+#include "qlowenergyhandlemap_p.h"
+
 #if defined(QT_ANDROID_BLUETOOTH)
 #include <QtCore/QJniObject>
 #endif
@@ -47,7 +50,7 @@ public:
         QBluetoothUuid uuid;
         QLowEnergyCharacteristic::PropertyTypes properties;
         QByteArray value;
-        QHash<QLowEnergyHandle, DescData> descriptorList;
+        QLowEnergyHandleMap<DescData> descriptorList;
     };
 
     enum GattAttributeTypes {
@@ -61,11 +64,18 @@ public:
     void setError(QLowEnergyService::ServiceError newError);
     void setState(QLowEnergyService::ServiceState newState);
 
+    void setChangeBatchingEnabled(bool enabled);
+    void appendCharacteristicChange(const QLowEnergyCharacteristic &characteristic,
+                                    const QByteArray &value);
+    void flushCharacteristicChanges();
+
 signals:
     void stateChanged(QLowEnergyService::ServiceState newState);
     void errorOccurred(QLowEnergyService::ServiceError error);
     void characteristicChanged(const QLowEnergyCharacteristic &characteristic,
                                const QByteArray &newValue);
+    void characteristicsChanged(const QList<QLowEnergyService::CharacteristicChange> &changes,
+                                const QByteArray &values);
     void characteristicRead(const QLowEnergyCharacteristic &info,
                             const QByteArray &value);
     void characteristicWritten(const QLowEnergyCharacteristic &characteristic,
@@ -86,10 +96,17 @@ public:
     QLowEnergyService::ServiceError lastError = QLowEnergyService::NoError;
     QLowEnergyService::DiscoveryMode mode = QLowEnergyService::FullDiscovery;
 
-    QHash<QLowEnergyHandle, CharData> characteristicList;
+    // sorted by handle
+    QLowEnergyHandleMap<CharData> characteristicList;
 
     QPointer<QLowEnergyControllerPrivate> controller;
 
+    // characteristic changes collected while batching is enabled
+    bool changeBatchingEnabled = false;
+    QTimer changeBatchTimer;
+    QList<QLowEnergyService::CharacteristicChange> batchedChanges;
+    QByteArray batchedValues;
+
 #if defined(QT_ANDROID_BLUETOOTH)
     // reference to the BluetoothGattService object
     QJniObject androidService;
@@ -97,8 +114,8 @@ public:
 
 };
 
-typedef QHash<QLowEnergyHandle, QLowEnergyServicePrivate::CharData> CharacteristicDataMap;
-typedef QHash<QLowEnergyHandle, QLowEnergyServicePrivate::DescData> DescriptorDataMap;
+typedef QLowEnergyHandleMap<QLowEnergyServicePrivate::CharData> CharacteristicDataMap;
+typedef QLowEnergyHandleMap<QLowEnergyServicePrivate::DescData> DescriptorDataMap;
 
 QT_END_NAMESPACE
 
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qnfctagtype4ndeffsm_p.h"
+#include "qndefmessage_p.h"
 #include <QtCore/QtEndian>
 #include <QtCore/QLoggingCategory>
 
@@ -41,7 +42,11 @@ QByteArray QNfcTagType4NdefFsm::getCommand(QNdefAccessFsm::Action &nextAction)
     case SelectNdefFileForWrite:
         return QCommandApdu::build(0x00, QCommandApdu::Select, 0x00, 0x0C, m_ndefFileId);
     case ReadNdefMessageLength:
-        return QCommandApdu::build(0x00, QCommandApdu::ReadBinary, 0x00, 0x00, {}, 2);
+        // Validating a cached message only needs the length. Otherwise read
+        // the beginning of the message together with its length.
+        return QCommandApdu::build(0x00, QCommandApdu::ReadBinary, 0x00, 0x00, {},
+                                   m_hasCachedMessage ? uint16_t(2)
+                                                      : qMin(m_maxReadSize, m_maxNdefSize));
     case ReadNdefMessage: {
         uint16_t readSize = qMin(m_fileSize, m_maxReadSize);
 
@@ -50,7 +55,7 @@ QByteArray QNfcTagType4NdefFsm::getCommand(QNdefAccessFsm::Action &nextAction)
     }
     case ClearNdefLength:
         m_fileOffset = 2;
-        m_fileSize = m_ndefData.size();
+        m_fileSize = m_ndefMessageSize;
         return QCommandApdu::build(0x00, QCommandApdu::UpdateBinary, 0x00, 0x00,
                                    QByteArrayView::fromArray(ZeroLength));
     case WriteNdefFile: {
@@ -60,12 +65,26 @@ QByteArray QNfcTagType4NdefFsm::getCommand(QNdefAccessFsm::Action &nextAction)
         m_fileOffset += updateSize;
         m_fileSize -= updateSize;
 
+        if (updateSize == m_ndefMessageSize) {
+            // The whole message fits, serialize it straight into the command
+            return QCommandApdu::build(0x00, QCommandApdu::UpdateBinary, fileOffset >> 8,
+                                       fileOffset & 0xFF, updateSize, [this](char *out) {
+                QNdefMessageWriter::write(m_ndefMessage, out, m_ndefMessageSize);
+            });
+        }
+
+        if (m_ndefData.isEmpty())
+            m_ndefData = m_ndefMessage.toByteArray();
+
         return QCommandApdu::build(0x00, QCommandApdu::UpdateBinary, fileOffset >> 8,
-                                   fileOffset & 0xFF, m_ndefData.mid(fileOffset - 2, updateSize));
+                                   fileOffset & 0xFF,
+                                   QByteArrayView(m_ndefData).sliced(fileOffset - 2, updateSize));
     }
     case WriteNdefLength: {
         QByteArray data(2, Qt::Uninitialized);
-        qToUnaligned(qToBigEndian<uint16_t>(m_ndefData.size()), data.data());
+        qToUnaligned(qToBigEndian<uint16_t>(m_ndefMessageSize), data.data());
+        m_ndefMessage.clear();
+        m_ndefData.clear();
 
         return QCommandApdu::build(0x00, QCommandApdu::UpdateBinary, 0x00, 0x00, data);
     }
@@ -78,7 +97,8 @@ QByteArray QNfcTagType4NdefFsm::getCommand(QNdefAccessFsm::Action &nextAction)
 QNdefMessage QNfcTagType4NdefFsm::getMessage(QNdefAccessFsm::Action &nextAction)
 {
     if (m_currentState == NdefMessageRead) {
-        auto message = QNdefMessage::fromByteArray(m_ndefData);
+        auto message = m_messageFromCache ? m_cachedMessage
+                                          : QNdefMessage::fromByteArray(m_ndefData);
         m_ndefData.clear();
         m_currentState = NdefSupportDetected;
         nextAction = Done;
@@ -89,6 +109,20 @@ QNdefMessage QNfcTagType4NdefFsm::getMessage(QNdefAccessFsm::Action &nextAction)
     return {};
 }
 
+void QNfcTagType4NdefFsm::setCachedMessage(uint16_t length, const QNdefMessage &message)
+{
+    m_hasCachedMessage = true;
+    m_cachedMessageLength = length;
+    m_cachedMessage = message;
+}
+
+void QNfcTagType4NdefFsm::clearCachedMessage()
+{
+    m_hasCachedMessage = false;
+    m_cachedMessageLength = 0;
+    m_cachedMessage.clear();
+}
+
 QNdefAccessFsm::Action QNfcTagType4NdefFsm::detectNdefSupport()
 {
     switch (m_currentState) {
@@ -127,11 +161,15 @@ QNdefAccessFsm::Action QNfcTagType4NdefFsm::writeMessages(const QList<QNdefMessa
     if (messages.isEmpty() || messages.size() > 1)
         return Failed;
 
-    auto messageData = messages.first().toByteArray();
-    if (messageData.size() > m_maxNdefSize - 2)
+    // Only the size is needed up front, the message is serialized when
+    // the UPDATE BINARY commands are built.
+    const qsizetype messageSize = QNdefMessageWriter::encodedSize(messages.first());
+    if (messageSize > m_maxNdefSize - 2)
         return Failed;
 
-    m_ndefData = messageData;
+    m_ndefMessage = messages.first();
+    m_ndefMessageSize = messageSize;
+    m_ndefData.clear();
 
     m_targetState = NdefMessageWritten;
 
@@ -231,6 +269,8 @@ QNdefAccessFsm::Action QNfcTagType4NdefFsm::handleReadCCResponse(const QResponse
         idx += count;
         return res;
     };
+    m_capabilityContainer = response.data();
+
     auto ccLen = readU16();
     if (ccLen < 15) {
         qCDebug(QT_NFC_T4T) << "CC length is too small";
@@ -248,6 +288,20 @@ QNdefAccessFsm::Action QNfcTagType4NdefFsm::handleReadCCResponse(const QResponse
     }
 
     m_maxUpdateSize = readU16();
+
+    // Use the largest commands that both the reader and the card can handle.
+    // Short APDUs carry up to 255 bytes of data and 256 bytes of response,
+    // extended ones up to 65535 bytes. Lc takes 1 or 3 bytes after the header.
+    if (m_extendedLength) {
+        m_maxUpdateSize = qBound<qsizetype>(0, m_maxCommandLength - 7, m_maxUpdateSize);
+    } else {
+        m_maxReadSize = qMin<uint16_t>(m_maxReadSize, 256);
+        m_maxUpdateSize = qBound<qsizetype>(0, m_maxCommandLength - 5,
+                                            qMin<uint16_t>(m_maxUpdateSize, 255));
+    }
+    qCDebug(QT_NFC_T4T) << "Max read size:" << m_maxReadSize
+                        << "max update size:" << m_maxUpdateSize;
+
     auto tlvTag = readU8();
     if (tlvTag != 0x04) {
         qCDebug(QT_NFC_T4T) << "Invalid TLV tag";
@@ -295,7 +349,7 @@ QNdefAccessFsm::Action QNfcTagType4NdefFsm::handleReadCCResponse(const QResponse
         return SendCommand;
     } else if (m_targetState == NdefMessageWritten) {
         if (m_writable) {
-            if (m_ndefData.size() > m_maxNdefSize - 2) {
+            if (m_ndefMessageSize > m_maxNdefSize - 2) {
                 qCDebug(QT_NFC_T4T) << "Message is too large";
                 return Failed;
             }
@@ -325,8 +379,20 @@ QNfcTagType4NdefFsm::handleReadFileLengthResponse(const QResponseApdu &response)
         return Failed;
     }
 
-    m_fileOffset = 2;
+    m_messageLength = m_fileSize;
+    m_messageFromCache = m_hasCachedMessage && m_fileSize == m_cachedMessageLength;
+    if (m_messageFromCache) {
+        m_currentState = NdefMessageRead;
+        return GetMessage;
+    }
+
+    // The response may already contain the beginning of the message
+    auto readSize = qMin<qsizetype>(m_fileSize, response.data().size() - 2);
     m_ndefData.clear();
+    m_ndefData.reserve(m_fileSize);
+    m_ndefData.append(response.data().sliced(2, readSize));
+    m_fileOffset = 2 + readSize;
+    m_fileSize -= readSize;
 
     if (m_fileSize == 0) {
         m_currentState = NdefMessageRead;
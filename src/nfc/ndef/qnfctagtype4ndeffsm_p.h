@@ -31,6 +31,24 @@ public:
     Action readMessages() override;
     Action writeMessages(const QList<QNdefMessage> &messages) override;
 
+    // Limits of the reader and the card, applied on top of the limits from
+    // the capability container.
+    void setMaxCommandLength(qsizetype length) { m_maxCommandLength = length; }
+    void setExtendedLengthSupported(bool supported) { m_extendedLength = supported; }
+
+    // Raw contents of the capability container, available after NDEF support
+    // was detected.
+    const QByteArray &capabilityContainer() const { return m_capabilityContainer; }
+
+    // If a cached message is set, the next read only fetches NLEN from the tag,
+    // and provides the cached message if NLEN matches the cached length.
+    void setCachedMessage(uint16_t length, const QNdefMessage &message);
+    void clearCachedMessage();
+    // Whether the last message provided by getMessage() came from the cache
+    bool messageFromCache() const { return m_messageFromCache; }
+    // NLEN of the last message read from the tag
+    uint16_t messageLength() const { return m_messageLength; }
+
 private:
     enum State {
         SelectApplicationForProbe,
@@ -56,6 +74,9 @@ private:
     State m_currentState = SelectApplicationForProbe;
     State m_targetState = SelectApplicationForProbe;
 
+    qsizetype m_maxCommandLength = 4 + 3 + 0xFFFF;
+    bool m_extendedLength = true;
+
     // Initialized during the detection phase
     uint16_t m_maxReadSize;
     uint16_t m_maxUpdateSize;
@@ -67,6 +88,18 @@ private:
     uint16_t m_fileSize;
     uint16_t m_fileOffset;
     QByteArray m_ndefData;
+    QByteArray m_capabilityContainer;
+
+    bool m_hasCachedMessage = false;
+    bool m_messageFromCache = false;
+    uint16_t m_cachedMessageLength = 0;
+    uint16_t m_messageLength = 0;
+    QNdefMessage m_cachedMessage;
+
+    // The message being written, it is only serialized into m_ndefData if it
+    // does not fit into a single UPDATE BINARY command
+    QNdefMessage m_ndefMessage;
+    qsizetype m_ndefMessageSize = 0;
 
     Action handleSimpleResponse(const QResponseApdu &response, State okState, State failedState,
                                 Action okAction = SendCommand);
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qpcsc_p.h"
+#include <QtCore/QScopeGuard>
 
 QT_BEGIN_NAMESPACE
 
@@ -18,6 +19,72 @@ QString errorMessage(LONG error)
 #endif
 }
 
+/*
+    Reads the names of all the readers known to the context into \a readers.
+    A missing reader is not an error, the list is left empty in that case.
+*/
+LONG listReaders(SCARDCONTEXT context, QList<QPcscSlotName> *readers)
+{
+    Q_ASSERT(readers != nullptr);
+    readers->clear();
+
+#ifndef SCARD_AUTOALLOCATE
+    // macOS does not support automatic allocation. Try using a fixed-size
+    // buffer first, extending it if it is not sufficient.
+#define LIST_READER_BUFFER_EXTRA 1024
+    QPcscSlotName buf(nullptr);
+    DWORD listSize = LIST_READER_BUFFER_EXTRA;
+    buf.resize(listSize);
+    QPcscSlotName::Ptr list = buf.ptr();
+
+    auto ret = SCardListReaders(context, nullptr, list, &listSize);
+#else
+    QPcscSlotName::Ptr list;
+    DWORD listSize = SCARD_AUTOALLOCATE;
+    auto ret = SCardListReaders(context, nullptr, reinterpret_cast<QPcscSlotName::Ptr>(&list),
+                                &listSize);
+#endif
+
+    if (ret == LONG(SCARD_E_NO_READERS_AVAILABLE)) {
+        list = nullptr;
+        ret = SCARD_S_SUCCESS;
+    }
+#ifndef SCARD_AUTOALLOCATE
+    else if (ret == LONG(SCARD_E_INSUFFICIENT_BUFFER)) {
+        // SCardListReaders() has set listSize to the required size. We add
+        // extra space to reduce possibility of failure if the reader list has
+        // changed since the last call.
+        listSize += LIST_READER_BUFFER_EXTRA;
+        buf.resize(listSize);
+        list = buf.ptr();
+
+        ret = SCardListReaders(context, nullptr, list, &listSize);
+        if (ret == LONG(SCARD_E_NO_READERS_AVAILABLE)) {
+            list = nullptr;
+            ret = SCARD_S_SUCCESS;
+        }
+    }
+#undef LIST_READER_BUFFER_EXTRA
+#endif
+
+    if (ret != SCARD_S_SUCCESS)
+        return ret;
+
+#ifdef SCARD_AUTOALLOCATE
+    auto freeList = qScopeGuard([context, list] {
+        if (list)
+            SCardFreeMemory(context, list);
+    });
+#endif
+
+    if (list != nullptr) {
+        for (const auto *p = list; *p; p += QPcscSlotName::nameSize(p) + 1)
+            readers->append(QPcscSlotName(p));
+    }
+
+    return SCARD_S_SUCCESS;
+}
+
 } // namespace QPcsc
 
 qsizetype QPcscSlotName::nameSize(QPcscSlotName::CPtr p)
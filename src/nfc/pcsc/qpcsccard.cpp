@@ -4,9 +4,17 @@
 #include "qpcsccard_p.h"
 #include "ndef/qnfctagtype4ndeffsm_p.h"
 #include "qapduutils_p.h"
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
 #include <QtCore/QTimer>
 
+#include <optional>
+
+#include <qtnfc_tracepoints_p.h>
+
 #if defined(Q_OS_DARWIN)
 #    define SCARD_ATTR_MAXINPUT 0x0007A007
 #elif !defined(Q_OS_WIN)
@@ -30,6 +38,182 @@ Q_DECLARE_LOGGING_CATEGORY(QT_NFC_PCSC)
 */
 static constexpr int KeepAliveIntervalMs = 2500;
 
+static constexpr qsizetype ShortResponseSize = 256 + 2;
+static constexpr qsizetype ExtendedResponseSize = 65536 + 2;
+
+/*
+    Returns the maximum size of the response to the command APDU, including
+    the status word. The expected length Ne is taken from the Le field,
+    responses without data or with malformed commands are assumed to be at
+    most as long as the longest short response.
+*/
+static qsizetype maxResponseSize(QByteArrayView command)
+{
+    const auto byteAt = [&command](qsizetype i) { return quint8(command.at(i)); };
+    const auto shortNe = [](quint8 le) -> qsizetype { return le ? le : 256; };
+    const auto extendedNe = [&byteAt](qsizetype i) -> qsizetype {
+        const qsizetype le = (byteAt(i) << 8) | byteAt(i + 1);
+        return le ? le : 65536;
+    };
+
+    qsizetype ne = 0;
+    const qsizetype size = command.size();
+
+    if (size <= 4) {
+        // Case 1, no data
+    } else if (size == 5) {
+        // Case 2 short
+        ne = shortNe(byteAt(4));
+    } else if (byteAt(4) != 0) {
+        // Case 3 or 4 short
+        const qsizetype lc = byteAt(4);
+        if (size == 6 + lc)
+            ne = shortNe(byteAt(size - 1));
+        else if (size != 5 + lc)
+            return ExtendedResponseSize;
+    } else if (size == 7) {
+        // Case 2 extended
+        ne = extendedNe(5);
+    } else {
+        // Case 3 or 4 extended
+        const qsizetype lc = (byteAt(5) << 8) | byteAt(6);
+        if (size == 9 + lc)
+            ne = extendedNe(size - 2);
+        else if (size != 7 + lc)
+            return ExtendedResponseSize;
+    }
+
+    return qMax(ne + 2, ShortResponseSize);
+}
+
+static constexpr auto NdefCacheEnvVar = "QT_NFC_PCSC_NDEF_CACHE";
+
+/*
+    Optional cache of the NDEF messages read from tags, shared by all readers.
+
+    The cached message is returned when a tag with the same UID and capability
+    container is read again, and the length of its NDEF message is still the
+    same. This only costs the read of the NLEN field instead of the whole NDEF
+    file. Changes made by other devices that keep the length of the message
+    are not detected, which is why the cache has to be enabled explicitly.
+*/
+namespace {
+class NdefCache
+{
+public:
+    struct Entry
+    {
+        uint16_t length;
+        QNdefMessage message;
+    };
+
+    std::optional<Entry> find(const QByteArray &key)
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_entries.constFind(key);
+        if (it == m_entries.cend())
+            return std::nullopt;
+        return *it;
+    }
+
+    void insert(const QByteArray &key, uint16_t length, const QNdefMessage &message)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_entries.contains(key)) {
+            // Evict the oldest entry
+            if (m_entries.size() >= MaxEntries)
+                m_entries.remove(m_order.takeFirst());
+            m_order.append(key);
+        }
+        m_entries.insert(key, { length, message });
+    }
+
+    void remove(const QByteArray &key)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_entries.remove(key))
+            m_order.removeOne(key);
+    }
+
+private:
+    static constexpr qsizetype MaxEntries = 64;
+
+    QMutex m_mutex;
+    QHash<QByteArray, Entry> m_entries;
+    // keys of m_entries in the order of their insertion
+    QList<QByteArray> m_order;
+};
+} // namespace
+
+Q_GLOBAL_STATIC(NdefCache, ndefCache)
+
+static bool ndefCacheEnabled()
+{
+    static const bool enabled = qEnvironmentVariableIntValue(NdefCacheEnvVar) != 0;
+    return enabled;
+}
+
+// Maximum length of a short command APDU
+static constexpr int ShortApduMaxLength = 4 + 1 + 255 + 1;
+
+/*
+    Checks the card capabilities in the historical bytes of the ATR for the
+    support of extended Lc and Le fields, as defined in ISO/IEC 7816-4,
+    section 8.1.1.2.7.
+
+    Returns std::nullopt if the ATR does not contain card capabilities, which
+    is the case for most ATRs that readers build for contactless cards.
+*/
+static std::optional<bool> extendedLengthFromAtr(QByteArrayView atr)
+{
+    if (atr.size() < 2)
+        return std::nullopt;
+
+    const auto byteAt = [&atr](qsizetype i) { return quint8(atr.at(i)); };
+
+    // Skip TS, T0 and the interface bytes
+    const qsizetype historicalCount = byteAt(1) & 0x0F;
+    quint8 indicator = byteAt(1);
+    qsizetype pos = 2;
+    while (true) {
+        pos += qPopulationCount(quint8(indicator & 0x70));
+        if (!(indicator & 0x80))
+            break;
+        if (pos >= atr.size())
+            return std::nullopt;
+        indicator = byteAt(pos++);
+    }
+
+    if (pos + historicalCount > atr.size())
+        return std::nullopt;
+    auto historical = atr.sliced(pos, historicalCount);
+
+    // Only the category indicators followed by COMPACT-TLV objects are
+    // handled. With 0x00, the last three bytes are a status indicator.
+    if (historical.isEmpty())
+        return std::nullopt;
+    if (historical.front() == 0x00)
+        historical.chop(qMin<qsizetype>(3, historical.size()));
+    else if (quint8(historical.front()) != 0x80)
+        return std::nullopt;
+    historical.slice(qMin<qsizetype>(1, historical.size()));
+
+    while (!historical.isEmpty()) {
+        const quint8 tag = quint8(historical.front()) >> 4;
+        const qsizetype length = historical.front() & 0x0F;
+        if (length + 1 > historical.size())
+            return std::nullopt;
+
+        // Third software function table of the card capabilities
+        if (tag == 0x7 && length >= 3)
+            return (historical.at(3) & 0x40) != 0;
+
+        historical.slice(length + 1);
+    }
+
+    return std::nullopt;
+}
+
 /*
     Start a temporary transaction if a persistent transaction was not already
     started due to call to onSendCommandRequest().
@@ -80,7 +264,18 @@ QPcscCard::QPcscCard(SCARDHANDLE handle, DWORD protocol, QObject *parent)
     m_ioPci.cbPciLength = sizeof(m_ioPci);
 
     // Assume that everything is NFC Tag Type 4 for now
-    m_tagDetectionFsm = std::make_unique<QNfcTagType4NdefFsm>();
+    auto fsm = std::make_unique<QNfcTagType4NdefFsm>();
+
+    // Extended length APDUs need support from both the reader and the card.
+    // If the card does not tell, rely on the limits from its CC file.
+    const int maxInputLength = readMaxInputLength();
+    const bool extendedLength = maxInputLength > ShortApduMaxLength
+            && extendedLengthFromAtr(readAtr()).value_or(true);
+    qCDebug(QT_NFC_PCSC) << "Extended length APDUs supported:" << extendedLength;
+
+    fsm->setMaxCommandLength(maxInputLength);
+    fsm->setExtendedLengthSupported(extendedLength);
+    m_tagDetectionFsm = std::move(fsm);
 
     performNdefDetection();
 }
@@ -172,24 +367,58 @@ QPcsc::RawCommandResult QPcscCard::sendCommand(const QByteArray &command,
         m_keepAliveTimer->start();
     }
 
+    // The response buffer is reused for all commands, and only grown if a
+    // command expects or gets a longer response than any command before it.
+    const qsizetype responseSize = maxResponseSize(command);
+    if (m_responseBuffer.size() < responseSize)
+        m_responseBuffer.resize(responseSize);
+
     QPcsc::RawCommandResult result;
-    result.response.resize(0xFFFF + 2);
-    DWORD recvLength = result.response.size();
+    DWORD recvLength = m_responseBuffer.size();
 
     qCDebug(QT_NFC_PCSC) << "TX:" << command.toHex(':');
 
-    result.ret = SCardTransmit(m_handle, &m_ioPci, reinterpret_cast<LPCBYTE>(command.constData()),
-                               command.size(), nullptr,
-                               reinterpret_cast<LPBYTE>(result.response.data()), &recvLength);
+    QElapsedTimer timer;
+    if (Q_TRACE_ENABLED(QPcscCard_sendCommand_entry)) {
+        Q_TRACE(QPcscCard_sendCommand_entry, command.size() > 1 ? quint8(command.at(1)) : 0,
+                command.size());
+        timer.start();
+    }
+
+    const auto transmit = [&]() {
+        return SCardTransmit(m_handle, &m_ioPci, reinterpret_cast<LPCBYTE>(command.constData()),
+                             command.size(), nullptr,
+                             reinterpret_cast<LPBYTE>(m_responseBuffer.data()), &recvLength);
+    };
+    result.ret = transmit();
+    if (result.ret == SCARD_E_INSUFFICIENT_BUFFER) {
+        // Commands without Le, like the direct transmit command of readers,
+        // can have longer responses. recvLength holds the required size if
+        // the reader reports it.
+        const qsizetype requiredSize = qsizetype(recvLength) > m_responseBuffer.size()
+                ? qsizetype(recvLength)
+                : ExtendedResponseSize;
+        if (requiredSize > m_responseBuffer.size()) {
+            qCDebug(QT_NFC_PCSC) << "Response buffer too small, retrying with" << requiredSize
+                                 << "bytes";
+            m_responseBuffer.resize(requiredSize);
+            recvLength = m_responseBuffer.size();
+            result.ret = transmit();
+        }
+    }
     if (result.ret != SCARD_S_SUCCESS) {
         qCWarning(QT_NFC_PCSC) << "SCardTransmit failed:" << QPcsc::errorMessage(result.ret);
-        result.response.clear();
         invalidate();
     } else {
-        result.response.resize(recvLength);
+        result.response = QByteArray(m_responseBuffer.constData(), recvLength);
         qCDebug(QT_NFC_PCSC) << "RX:" << result.response.toHex(':');
     }
 
+    if (timer.isValid()) {
+        Q_TRACE(QPcscCard_sendCommand_exit, long(result.ret), result.response.size(),
+                QResponseApdu(result.response).status(), timer.nsecsElapsed());
+    }
+
     return result;
 }
 
@@ -211,7 +440,24 @@ QByteArray QPcscCard::readUid()
     QResponseApdu res(sendCommand(command, NoAutoTransaction).response);
     if (!res.isOk())
         return {};
-    return res.data();
+    m_uid = res.data();
+    return m_uid;
+}
+
+/*
+    Returns the key of the tag in the NDEF cache, or an empty array if the
+    cache is disabled or the tag cannot be identified.
+*/
+QByteArray QPcscCard::ndefCacheKey() const
+{
+    if (!ndefCacheEnabled() || m_uid.isEmpty())
+        return {};
+
+    const auto &cc = m_tagDetectionFsm->capabilityContainer();
+    QByteArray key;
+    key.reserve(1 + m_uid.size() + cc.size());
+    key.append(char(m_uid.size())).append(m_uid).append(cc);
+    return key;
 }
 
 void QPcscCard::onReadNdefMessagesRequest(const QNearFieldTarget::RequestId &request)
@@ -228,7 +474,11 @@ void QPcscCard::onReadNdefMessagesRequest(const QNearFieldTarget::RequestId &req
 
     Transaction transaction(this);
 
-    QList<QNdefMessage> messages;
+    const QByteArray cacheKey = ndefCacheKey();
+    if (auto entry = cacheKey.isEmpty() ? std::nullopt : ndefCache->find(cacheKey))
+        m_tagDetectionFsm->setCachedMessage(entry->length, entry->message);
+    else
+        m_tagDetectionFsm->clearCachedMessage();
 
     auto nextState = m_tagDetectionFsm->readMessages();
 
@@ -241,7 +491,12 @@ void QPcscCard::onReadNdefMessagesRequest(const QNearFieldTarget::RequestId &req
                 nextState = m_tagDetectionFsm->provideResponse(result.response);
             }
         } else if (nextState == QNdefAccessFsm::GetMessage) {
+            const bool fromCache = m_tagDetectionFsm->messageFromCache();
+            const auto length = m_tagDetectionFsm->messageLength();
             auto message = m_tagDetectionFsm->getMessage(nextState);
+            qCDebug(QT_NFC_PCSC) << "NDEF message from cache:" << fromCache;
+            if (!cacheKey.isEmpty() && !fromCache)
+                ndefCache->insert(cacheKey, length, message);
             Q_EMIT ndefMessageRead(message);
         } else {
             break;
@@ -317,6 +572,46 @@ void QPcscCard::onSendCommandRequest(const QNearFieldTarget::RequestId &request,
         Q_EMIT requestCompleted(request, QNearFieldTarget::CommandError, {});
 }
 
+/*
+    Sends all the commands within the automatic transaction, without returning
+    to the event loop in between. If stopOnErrorStatus is set, the sequence
+    ends after the first response with an ISO/IEC 7816-4 error status word.
+*/
+void QPcscCard::onSendCommandsRequest(const QNearFieldTarget::RequestId &request,
+                                      const QList<QByteArray> &commands, bool stopOnErrorStatus)
+{
+    qCDebug(QT_NFC_PCSC) << Q_FUNC_INFO;
+
+    if (!m_isValid) {
+        Q_EMIT requestCompleted(request, QNearFieldTarget::ConnectionError, {});
+        return;
+    }
+
+    QList<QByteArray> responses;
+    responses.reserve(commands.size());
+
+    for (const auto &command : commands) {
+        auto result = sendCommand(command, StartAutoTransaction);
+        if (!result.isOk()) {
+            Q_EMIT requestCompleted(request, QNearFieldTarget::CommandError, {});
+            return;
+        }
+
+        responses.append(result.response);
+
+        if (stopOnErrorStatus) {
+            const QResponseApdu response(result.response);
+            if (response.isError()) {
+                qCDebug(QT_NFC_PCSC) << "Stopping command sequence on status" << Qt::hex
+                                     << response.status();
+                break;
+            }
+        }
+    }
+
+    Q_EMIT requestCompleted(request, QNearFieldTarget::NoError, QVariant::fromValue(responses));
+}
+
 void QPcscCard::onWriteNdefMessagesRequest(const QNearFieldTarget::RequestId &request,
                                            const QList<QNdefMessage> &messages)
 {
@@ -334,6 +629,10 @@ void QPcscCard::onWriteNdefMessagesRequest(const QNearFieldTarget::RequestId &re
 
     Transaction transaction(this);
 
+    // The content of the tag is unknown from now on, even if the write fails
+    if (const QByteArray cacheKey = ndefCacheKey(); !cacheKey.isEmpty())
+        ndefCache->remove(cacheKey);
+
     auto nextState = m_tagDetectionFsm->writeMessages(messages);
 
     while (nextState == QNdefAccessFsm::SendCommand) {
@@ -391,13 +690,34 @@ bool QPcscCard::checkCardPresent()
     return (state & SCARD_PRESENT) != 0;
 }
 
+QByteArray QPcscCard::readAtr()
+{
+    if (!m_isValid)
+        return {};
+
+    // MAX_ATR_SIZE in PCSCLite, SCARD_ATR_LENGTH on Windows
+    QByteArray atr(33, Qt::Uninitialized);
+    DWORD atrLength = atr.size();
+    auto ret = SCardStatus(m_handle, nullptr, nullptr, nullptr, nullptr,
+                           reinterpret_cast<LPBYTE>(atr.data()), &atrLength);
+    if (ret != SCARD_S_SUCCESS) {
+        qCDebug(QT_NFC_PCSC) << "SCardStatus failed:" << QPcsc::errorMessage(ret);
+        return {};
+    }
+
+    atr.truncate(atrLength);
+    qCDebug(QT_NFC_PCSC) << "ATR:" << atr.toHex(':');
+
+    return atr;
+}
+
 int QPcscCard::readMaxInputLength()
 {
     if (!m_isValid)
         return 0;
 
     // Maximum standard APDU length
-    static constexpr int DefaultMaxInputLength = 261;
+    static constexpr int DefaultMaxInputLength = ShortApduMaxLength;
 
     uint32_t maxInput;
     DWORD attrSize = sizeof(maxInput);
@@ -18,7 +18,7 @@
 #include "qpcsc_p.h"
 #include "qndefmessage.h"
 #include "qnearfieldtarget.h"
-#include "ndef/qndefaccessfsm_p.h"
+#include "ndef/qnfctagtype4ndeffsm_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -51,13 +51,18 @@ private:
     // Indicates that an _automatic_ transaction was started
     bool m_inAutoTransaction = false;
     QTimer *m_keepAliveTimer;
+    // Receives the responses of all commands, grown as needed
+    QByteArray m_responseBuffer;
+    QByteArray m_uid;
 
-    std::unique_ptr<QNdefAccessFsm> m_tagDetectionFsm;
+    std::unique_ptr<QNfcTagType4NdefFsm> m_tagDetectionFsm;
 
     enum AutoTransaction { NoAutoTransaction, StartAutoTransaction };
 
     QPcsc::RawCommandResult sendCommand(const QByteArray &command, AutoTransaction autoTransaction);
     void performNdefDetection();
+    QByteArray readAtr();
+    QByteArray ndefCacheKey() const;
 
     class Transaction
     {
@@ -75,6 +80,8 @@ public Q_SLOTS:
     void onTargetDestroyed();
     void onSendCommandRequest(const QNearFieldTarget::RequestId &request,
                               const QByteArray &command);
+    void onSendCommandsRequest(const QNearFieldTarget::RequestId &request,
+                               const QList<QByteArray> &commands, bool stopOnErrorStatus);
     void onReadNdefMessagesRequest(const QNearFieldTarget::RequestId &request);
     void onWriteNdefMessagesRequest(const QNearFieldTarget::RequestId &request,
                                     const QList<QNdefMessage> &messages);
@@ -4,6 +4,7 @@
 #include "qpcscmanager_p.h"
 #include "qpcscslot_p.h"
 #include "qpcsccard_p.h"
+#include "qpcscmonitor_p.h"
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QThread>
 #include <QtCore/QTimer>
@@ -14,6 +15,7 @@ Q_DECLARE_LOGGING_CATEGORY(QT_NFC_PCSC)
 
 static constexpr auto PollIntervalEnvVar = "QT_NFC_POLL_INTERVAL_MS";
 static constexpr int DefaultPollIntervalMs = 100;
+static constexpr auto ThreadPerReaderEnvVar = "QT_NFC_PCSC_THREAD_PER_READER";
 
 QPcscManager::QPcscManager(QObject *parent) : QObject(parent)
 {
@@ -28,14 +30,26 @@ QPcscManager::QPcscManager(QObject *parent) : QObject(parent)
             qCWarning(QT_NFC_PCSC) << PollIntervalEnvVar << "set to an invalid value";
     }
 
-    m_stateUpdateTimer = new QTimer(this);
-    m_stateUpdateTimer->setInterval(pollInterval);
-    connect(m_stateUpdateTimer, &QTimer::timeout, this, &QPcscManager::onStateUpdate);
+    // Reader and card changes are reported by the monitor thread as soon as
+    // they happen. The poll interval is only used for retrying after failures,
+    // and for finding new readers if the platform does not notify about them.
+    m_monitor = new QPcscMonitor(pollInterval, this);
+    connect(m_monitor, &QPcscMonitor::stateChanged, this, &QPcscManager::onStateUpdate,
+            Qt::QueuedConnection);
+
+    m_threadPerReader = qEnvironmentVariableIntValue(ThreadPerReaderEnvVar) != 0;
+
+    m_retryTimer = new QTimer(this);
+    m_retryTimer->setSingleShot(true);
+    m_retryTimer->setInterval(pollInterval);
+    connect(m_retryTimer, &QTimer::timeout, this, &QPcscManager::onStateUpdate);
 }
 
 QPcscManager::~QPcscManager()
 {
     qCDebug(QT_NFC_PCSC) << Q_FUNC_INFO;
+    m_monitor->stop();
+
     if (m_hasContext) {
         // Destroy all card handles before destroying the PCSC context.
         for (auto slot : std::as_const(m_slots))
@@ -43,6 +57,20 @@ QPcscManager::~QPcscManager()
         SCardReleaseContext(m_context);
     }
 
+    // Slots and cards of the reader threads are deleted in their own threads,
+    // the pending deletions are processed before the threads finish.
+    for (auto slot : std::as_const(m_slots)) {
+        if (slot->thread() != thread())
+            slot->deleteLater();
+    }
+    for (const auto &reader : std::as_const(m_readerThreads)) {
+        reader.cardOwner->deleteLater();
+        reader.thread->quit();
+        reader.thread->wait();
+        if (reader.hasContext)
+            SCardReleaseContext(reader.context);
+    }
+
     // Stop the worker thread.
     thread()->quit();
 }
@@ -102,65 +130,14 @@ void QPcscManager::updateSlotList()
 {
     Q_ASSERT(m_hasContext);
 
-#ifndef SCARD_AUTOALLOCATE
-    // macOS does not support automatic allocation. Try using a fixed-size
-    // buffer first, extending it if it is not sufficient.
-#define LIST_READER_BUFFER_EXTRA 1024
-    QPcscSlotName buf(nullptr);
-    DWORD listSize = LIST_READER_BUFFER_EXTRA;
-    buf.resize(listSize);
-    QPcscSlotName::Ptr list = buf.ptr();
-
-    auto ret = SCardListReaders(m_context, nullptr, list, &listSize);
-#else
-    QPcscSlotName::Ptr list;
-    DWORD listSize = SCARD_AUTOALLOCATE;
-    auto ret = SCardListReaders(m_context, nullptr, reinterpret_cast<QPcscSlotName::Ptr>(&list),
-                                &listSize);
-#endif
-
-    if (ret == LONG(SCARD_E_NO_READERS_AVAILABLE)) {
-        list = nullptr;
-        ret = SCARD_S_SUCCESS;
-    }
-#ifndef SCARD_AUTOALLOCATE
-    else if (ret == LONG(SCARD_E_INSUFFICIENT_BUFFER)) {
-        // SCardListReaders() has set listSize to the required size. We add
-        // extra space to reduce possibility of failure if the reader list has
-        // changed since the last call.
-        listSize += LIST_READER_BUFFER_EXTRA;
-        buf.resize(listSize);
-        list = buf.ptr();
-
-        ret = SCardListReaders(m_context, nullptr, list, &listSize);
-        if (ret == LONG(SCARD_E_NO_READERS_AVAILABLE)) {
-            list = nullptr;
-            ret = SCARD_S_SUCCESS;
-        }
-    }
-#undef LIST_READER_BUFFER_EXTRA
-#endif
-
+    QList<QPcscSlotName> readers;
+    LONG ret = QPcsc::listReaders(m_context, &readers);
     if (ret != SCARD_S_SUCCESS) {
         qCDebug(QT_NFC_PCSC) << "Failed to list readers:" << QPcsc::errorMessage(ret);
         return;
     }
 
-#ifdef SCARD_AUTOALLOCATE
-    auto freeList = qScopeGuard([this, list] {
-        if (list) {
-            Q_ASSERT(m_hasContext);
-            SCardFreeMemory(m_context, list);
-        }
-    });
-#endif
-
-    QSet<QPcscSlotName> presentSlots;
-
-    if (list != nullptr) {
-        for (const auto *p = list; *p; p += QPcscSlotName::nameSize(p) + 1)
-            presentSlots.insert(QPcscSlotName(p));
-    }
+    QSet<QPcscSlotName> presentSlots(readers.cbegin(), readers.cend());
 
     // Check current state list and mark slots that are not present anymore to
     // be removed later.
@@ -179,7 +156,7 @@ void QPcscManager::updateSlotList()
 
     // Add new slots
     for (auto &&slotName : std::as_const(presentSlots)) {
-        QPcscSlot *slot = new QPcscSlot(slotName, this);
+        QPcscSlot *slot = createSlot(slotName);
         qCDebug(QT_NFC_PCSC) << "New slot:" << slot;
 
         m_slots[slotName] = slot;
@@ -193,6 +170,47 @@ void QPcscManager::updateSlotList()
     }
 }
 
+/*
+    Creates a slot for the reader. By default all the slots and cards live in
+    the thread of the manager and share its context, so the commands sent to
+    cards in different readers are serialized. If a thread per reader was
+    requested, the slot is moved to the thread of its reader, and the reader
+    gets a context of its own.
+*/
+QPcscSlot *QPcscManager::createSlot(const QPcscSlotName &name)
+{
+    if (!m_threadPerReader)
+        return new QPcscSlot(name, this, m_context, this, this);
+
+    auto it = m_readerThreads.find(name);
+    if (it == m_readerThreads.end() || !it->hasContext) {
+        SCARDCONTEXT context;
+        LONG ret = SCardEstablishContext(SCARD_SCOPE_USER, nullptr, nullptr, &context);
+        if (ret != SCARD_S_SUCCESS) {
+            qCWarning(QT_NFC_PCSC) << "Failed to establish reader context:"
+                                   << QPcsc::errorMessage(ret);
+            return new QPcscSlot(name, this, m_context, this, this);
+        }
+
+        if (it == m_readerThreads.end()) {
+            ReaderThread reader;
+            reader.thread = new QThread(this);
+            reader.thread->setObjectName(QStringLiteral("QtNfcReaderThread"));
+            reader.cardOwner = new QObject;
+            reader.cardOwner->moveToThread(reader.thread);
+            reader.thread->start();
+
+            it = m_readerThreads.insert(name, reader);
+        }
+        it->context = context;
+        it->hasContext = true;
+    }
+
+    auto slot = new QPcscSlot(name, this, it->context, it->cardOwner);
+    slot->moveToThread(it->thread);
+    return slot;
+}
+
 bool QPcscManager::establishContext()
 {
     qCDebug(QT_NFC_PCSC) << Q_FUNC_INFO;
@@ -212,13 +230,13 @@ bool QPcscManager::establishContext()
 void QPcscManager::onStateUpdate()
 {
     if (!m_hasContext) {
-        if (!m_targetDetectionRunning) {
-            m_stateUpdateTimer->stop();
+        if (!m_targetDetectionRunning)
             return;
-        }
 
-        if (!establishContext())
+        if (!establishContext()) {
+            m_retryTimer->start();
             return;
+        }
     }
 
     updateSlotList();
@@ -230,21 +248,15 @@ void QPcscManager::onStateUpdate()
             SCardReleaseContext(m_context);
             m_hasContext = false;
 
-            m_stateUpdateTimer->stop();
+            m_monitor->stop();
+            m_retryTimer->stop();
         }
         return;
     }
 
-    // Both Windows and PCSCLite support interruptable continuos state detection
-    // where SCardCancel() can be used to abort it from another thread.
-    // But that introduces a problem of reliable cancelling of the status change
-    // call and no other. Reliable use of SCardCancel() would probably require
-    // some form of synchronization and polling, and would make the code much
-    // more complicated.
-    // Alternatively, the state detection code could run in a yet another thread
-    // that will not need to be cancelled too often.
-    // For simplicity, the current code just checks for status changes every
-    // second.
+    // The blocking wait for changes happens in the monitor thread, which only
+    // reports that something has changed. The states are read here without
+    // waiting.
     LONG ret = SCardGetStatusChange(m_context, 0, m_slotStates.data(), m_slotStates.size());
 
     if (ret == SCARD_S_SUCCESS || ret == LONG(SCARD_E_UNKNOWN_READER)) {
@@ -259,55 +271,96 @@ void QPcscManager::onStateUpdate()
         // Unknown failure. It is likely that the current context will not
         // recover from it, so destroy it and try to create a new context at the
         // next iteration.
-        Q_ASSERT(m_hasContext);
-        m_hasContext = false;
-        for (auto slot : std::as_const(m_slots)) {
-            slot->invalidateInsertedCard();
-            slot->deleteLater();
-        }
-        SCardReleaseContext(m_context);
-        m_slots.clear();
-        m_slotStates.clear();
+        resetContexts();
     }
 }
 
+/*
+    Destroys all slots and releases the contexts of the manager and of the
+    reader threads, for example after the PC/SC service was restarted. New
+    contexts are established by the next state update.
+*/
+void QPcscManager::resetContexts()
+{
+    if (!m_hasContext)
+        return;
+
+    m_hasContext = false;
+    for (auto slot : std::as_const(m_slots)) {
+        slot->invalidateInsertedCard();
+        slot->deleteLater();
+    }
+    SCardReleaseContext(m_context);
+    m_slots.clear();
+    m_slotStates.clear();
+
+    // The cards of a reader thread are invalidated in that thread, so its
+    // context is released there after them.
+    for (auto &reader : m_readerThreads) {
+        if (!reader.hasContext)
+            continue;
+        reader.hasContext = false;
+        QMetaObject::invokeMethod(reader.cardOwner, [context = reader.context] {
+            SCardReleaseContext(context);
+        });
+    }
+
+    m_retryTimer->start();
+}
+
 void QPcscManager::onStartTargetDetectionRequest(QNearFieldTarget::AccessMethod accessMethod)
 {
     qCDebug(QT_NFC_PCSC) << Q_FUNC_INFO;
 
-    m_requestedMethod = accessMethod;
+    m_requestedMethod.store(accessMethod, std::memory_order_relaxed);
 
     if (m_targetDetectionRunning)
         return;
 
     m_targetDetectionRunning = true;
-    m_stateUpdateTimer->start();
+    if (!m_monitor->isRunning())
+        m_monitor->start();
+
+    onStateUpdate();
 }
 
 void QPcscManager::onStopTargetDetectionRequest()
 {
     qCDebug(QT_NFC_PCSC) << Q_FUNC_INFO;
     m_targetDetectionRunning = false;
+
+    // Drop the slots without cards, and the context if nothing is left.
+    onStateUpdate();
 }
 
+/*
+    Connects to the card in the slot. This is called in the thread of the slot,
+    which is not necessarily the thread of the manager.
+*/
 QPcscCard *QPcscManager::connectToCard(QPcscSlot *slot)
 {
     qCDebug(QT_NFC_PCSC) << Q_FUNC_INFO;
     Q_ASSERT(slot != nullptr);
-    Q_ASSERT(m_hasContext);
 
     SCARDHANDLE cardHandle;
     DWORD activeProtocol;
 
-    LONG ret = SCardConnect(m_context, slot->name().ptr(), SCARD_SHARE_SHARED,
+    LONG ret = SCardConnect(slot->context(), slot->name().ptr(), SCARD_SHARE_SHARED,
                             SCARD_PROTOCOL_T0 | SCARD_PROTOCOL_T1, &cardHandle, &activeProtocol);
+    if (ret == LONG(SCARD_E_INVALID_HANDLE)) {
+        // The context did not survive a restart of the PC/SC service. Retrying
+        // with it would fail forever, so all contexts are established again.
+        qCWarning(QT_NFC_PCSC) << "Failed to connect to card:" << QPcsc::errorMessage(ret);
+        QMetaObject::invokeMethod(this, &QPcscManager::resetContexts, Qt::QueuedConnection);
+        return nullptr;
+    }
     if (ret != SCARD_S_SUCCESS) {
         qCDebug(QT_NFC_PCSC) << "Failed to connect to card:" << QPcsc::errorMessage(ret);
         retryCardDetection(slot);
         return nullptr;
     }
 
-    auto card = new QPcscCard(cardHandle, activeProtocol, this);
+    auto card = new QPcscCard(cardHandle, activeProtocol, slot->cardParent());
     auto uid = card->readUid();
     auto maxInputLength = card->readMaxInputLength();
 
@@ -315,8 +368,9 @@ QPcscCard *QPcscManager::connectToCard(QPcscSlot *slot)
     if (card->supportsNdef())
         accessMethods |= QNearFieldTarget::NdefAccess;
 
-    if (m_requestedMethod != QNearFieldTarget::UnknownAccess
-        && (accessMethods & m_requestedMethod) == 0) {
+    const auto requestedMethod = m_requestedMethod.load(std::memory_order_relaxed);
+    if (requestedMethod != QNearFieldTarget::UnknownAccess
+        && (accessMethods & requestedMethod) == 0) {
         qCDebug(QT_NFC_PCSC) << "Dropping card without required access support";
         card->deleteLater();
         return nullptr;
@@ -338,7 +392,7 @@ QPcscCard *QPcscManager::connectToCard(QPcscSlot *slot)
 
 /*
     Setup states list so that the card detection for the given slot will
-    be retried on the next iteration.
+    be retried after the poll interval.
 
     This is useful to try to get cards working after reset.
 */
@@ -346,9 +400,15 @@ void QPcscManager::retryCardDetection(const QPcscSlot *slot)
 {
     qCDebug(QT_NFC_PCSC) << Q_FUNC_INFO;
 
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, slot] { retryCardDetection(slot); });
+        return;
+    }
+
     for (auto &state : m_slotStates) {
         if (state.pvUserData == slot) {
             state.dwCurrentState = SCARD_STATE_UNAWARE;
+            m_retryTimer->start();
             break;
         }
     }
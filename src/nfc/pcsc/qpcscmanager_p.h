@@ -18,10 +18,14 @@
 #include "qpcsc_p.h"
 #include "qnearfieldtarget.h"
 
+#include <atomic>
+
 QT_BEGIN_NAMESPACE
 
 class QPcscSlot;
 class QPcscCard;
+class QPcscMonitor;
+class QThread;
 class QTimer;
 
 class QPcscManager : public QObject
@@ -34,15 +38,34 @@ public:
     QPcscCard *connectToCard(QPcscSlot *slot);
 
 private:
-    QTimer *m_stateUpdateTimer;
+    // Slots and cards of a reader that has a thread of its own. The thread is
+    // kept for the lifetime of the manager, so that a reader that is removed
+    // and added again keeps using the same thread. The context is released
+    // together with the context of the manager, and established again when
+    // the next slot of the reader is created.
+    struct ReaderThread
+    {
+        QThread *thread = nullptr;
+        QObject *cardOwner = nullptr;
+        bool hasContext = false;
+        SCARDCONTEXT context;
+    };
+
+    QPcscMonitor *m_monitor;
+    QTimer *m_retryTimer;
     bool m_targetDetectionRunning = false;
     bool m_hasContext = false;
+    bool m_threadPerReader = false;
     SCARDCONTEXT m_context;
     QMap<QPcscSlotName, QPcscSlot *> m_slots;
     QList<SCARD_READERSTATE> m_slotStates;
-    QNearFieldTarget::AccessMethod m_requestedMethod;
+    QMap<QPcscSlotName, ReaderThread> m_readerThreads;
+    std::atomic<QNearFieldTarget::AccessMethod> m_requestedMethod =
+            QNearFieldTarget::UnknownAccess;
 
     [[nodiscard]] bool establishContext();
+    void resetContexts();
+    QPcscSlot *createSlot(const QPcscSlotName &name);
     void processSlotUpdates();
     void updateSlotList();
     void removeSlots();
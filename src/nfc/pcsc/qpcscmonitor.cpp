@@ -0,0 +1,212 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qpcscmonitor_p.h"
+#include <QtCore/QLoggingCategory>
+
+QT_BEGIN_NAMESPACE
+
+Q_DECLARE_LOGGING_CATEGORY(QT_NFC_PCSC)
+
+#ifdef Q_OS_WIN
+static constexpr QPcscSlotName::CPtr PnpNotificationName = L"\\\\?PnP?\\Notification";
+#else
+static constexpr QPcscSlotName::CPtr PnpNotificationName = "\\\\?PnP?\\Notification";
+#endif
+
+static constexpr unsigned long CancelRetryIntervalMs = 10;
+
+/*
+    Waits for reader and card state changes in a blocking
+    SCardGetStatusChange() call on a dedicated thread, and emits
+    stateChanged() whenever something has changed. The special PnP
+    notification reader is included in the wait so that added and removed
+    readers are reported as well.
+
+    If the PnP notification reader is not supported by the platform, the
+    reader list is instead refreshed every rescanIntervalMs milliseconds.
+*/
+QPcscMonitor::QPcscMonitor(int rescanIntervalMs, QObject *parent)
+    : QThread(parent), m_rescanIntervalMs(rescanIntervalMs)
+{
+    setObjectName(QStringLiteral("QtNfcPcscMonitor"));
+}
+
+QPcscMonitor::~QPcscMonitor()
+{
+    stop();
+}
+
+/*
+    Stops the monitor thread and waits for it to finish.
+*/
+void QPcscMonitor::stop()
+{
+    requestInterruption();
+
+    // SCardCancel() only aborts a status change call that is already in
+    // progress. Keep cancelling until the thread has noticed the interruption
+    // request, so that a call entered just after cancelling cannot block it.
+    do {
+        QMutexLocker locker(&m_mutex);
+        if (m_hasContext)
+            SCardCancel(m_context);
+        m_stopCondition.wakeAll();
+    } while (!wait(CancelRetryIntervalMs));
+}
+
+void QPcscMonitor::run()
+{
+    qCDebug(QT_NFC_PCSC) << "Reader monitor started";
+
+    m_readerNames.clear();
+    m_readerStates.clear();
+
+    bool rescan = true;
+
+    while (!isInterruptionRequested()) {
+        if (!m_hasContext) {
+            if (!establishContext()) {
+                waitForStop(m_rescanIntervalMs);
+                continue;
+            }
+            rescan = true;
+        }
+
+        if (rescan) {
+            if (!updateReaderStates()) {
+                releaseContext();
+                waitForStop(m_rescanIntervalMs);
+                continue;
+            }
+            rescan = false;
+        }
+
+        if (m_readerStates.isEmpty()) {
+            // No readers and no PnP notifications, look for new readers later.
+            waitForStop(m_rescanIntervalMs);
+            rescan = true;
+            continue;
+        }
+
+        const DWORD timeout = m_pnpSupported ? INFINITE : DWORD(m_rescanIntervalMs);
+        LONG ret = SCardGetStatusChange(m_context, timeout, m_readerStates.data(),
+                                        m_readerStates.size());
+
+        if (ret == SCARD_S_SUCCESS) {
+            bool changed = false;
+            for (qsizetype i = 0; i < m_readerStates.size(); ++i) {
+                auto &state = m_readerStates[i];
+                if ((state.dwEventState & SCARD_STATE_CHANGED) == 0)
+                    continue;
+
+                state.dwCurrentState = state.dwEventState;
+                changed = true;
+                if (m_pnpSupported && i == 0)
+                    rescan = true;
+            }
+            if (changed)
+                Q_EMIT stateChanged();
+        } else if (ret == LONG(SCARD_E_TIMEOUT)) {
+            rescan = !m_pnpSupported;
+        } else if (ret == LONG(SCARD_E_CANCELLED)) {
+            /* stop() was called */
+        } else if (ret == LONG(SCARD_E_UNKNOWN_READER)) {
+            if (m_pnpSupported && (m_readerStates.first().dwEventState & SCARD_STATE_UNKNOWN)) {
+                qCDebug(QT_NFC_PCSC) << "PnP notifications are not supported, polling for readers";
+                m_pnpSupported = false;
+            }
+            rescan = true;
+            Q_EMIT stateChanged();
+        } else {
+            qCDebug(QT_NFC_PCSC) << "SCardGetStatusChange failed:" << QPcsc::errorMessage(ret);
+
+            // The service may have been stopped or restarted, retry with a
+            // new context later.
+            releaseContext();
+            Q_EMIT stateChanged();
+            waitForStop(m_rescanIntervalMs);
+        }
+    }
+
+    releaseContext();
+
+    qCDebug(QT_NFC_PCSC) << "Reader monitor stopped";
+}
+
+bool QPcscMonitor::establishContext()
+{
+    SCARDCONTEXT context;
+    LONG ret = SCardEstablishContext(SCARD_SCOPE_USER, nullptr, nullptr, &context);
+    if (ret != SCARD_S_SUCCESS) {
+        qCDebug(QT_NFC_PCSC) << "Failed to establish monitor context:"
+                             << QPcsc::errorMessage(ret);
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_context = context;
+    m_hasContext = true;
+
+    return true;
+}
+
+void QPcscMonitor::releaseContext()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_hasContext)
+        return;
+
+    m_hasContext = false;
+    SCardReleaseContext(m_context);
+}
+
+/*
+    Rebuilds the list of states to wait on from the current reader list,
+    keeping the known state of readers that are still present.
+*/
+bool QPcscMonitor::updateReaderStates()
+{
+    QList<QPcscSlotName> readerNames;
+    LONG ret = QPcsc::listReaders(m_context, &readerNames);
+    if (ret != SCARD_S_SUCCESS) {
+        qCDebug(QT_NFC_PCSC) << "Failed to list readers:" << QPcsc::errorMessage(ret);
+        return false;
+    }
+
+    if (m_pnpSupported)
+        readerNames.prepend(QPcscSlotName(PnpNotificationName));
+
+    QList<SCARD_READERSTATE> readerStates;
+    readerStates.reserve(readerNames.size());
+
+    for (const auto &name : std::as_const(readerNames)) {
+        SCARD_READERSTATE state {};
+        state.dwCurrentState = SCARD_STATE_UNAWARE;
+
+        const auto oldIndex = m_readerNames.indexOf(name);
+        if (oldIndex >= 0)
+            state.dwCurrentState = m_readerStates.at(oldIndex).dwCurrentState;
+
+        readerStates.append(state);
+    }
+
+    m_readerNames = std::move(readerNames);
+    m_readerStates = std::move(readerStates);
+
+    // The states refer to the names, which are not modified until the next
+    // update.
+    for (qsizetype i = 0; i < m_readerNames.size(); ++i)
+        m_readerStates[i].szReader = m_readerNames.at(i).ptr();
+
+    return true;
+}
+
+void QPcscMonitor::waitForStop(int timeoutMs)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!isInterruptionRequested())
+        m_stopCondition.wait(&m_mutex, timeoutMs);
+}
+
+QT_END_NAMESPACE
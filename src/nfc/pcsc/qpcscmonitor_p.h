@@ -0,0 +1,61 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QPCSCMONITOR_P_H
+#define QPCSCMONITOR_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qpcsc_p.h"
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
+QT_BEGIN_NAMESPACE
+
+class QPcscMonitor : public QThread
+{
+    Q_OBJECT
+public:
+    explicit QPcscMonitor(int rescanIntervalMs, QObject *parent = nullptr);
+    ~QPcscMonitor() override;
+
+    void stop();
+
+Q_SIGNALS:
+    void stateChanged();
+
+protected:
+    void run() override;
+
+private:
+    const int m_rescanIntervalMs;
+
+    // Protects m_context and m_hasContext against SCardCancel() from stop()
+    QMutex m_mutex;
+    QWaitCondition m_stopCondition;
+    SCARDCONTEXT m_context;
+    bool m_hasContext = false;
+
+    bool m_pnpSupported = true;
+    QList<QPcscSlotName> m_readerNames;
+    QList<SCARD_READERSTATE> m_readerStates;
+
+    [[nodiscard]] bool establishContext();
+    void releaseContext();
+    [[nodiscard]] bool updateReaderStates();
+    void waitForStop(int timeoutMs);
+};
+
+QT_END_NAMESPACE
+
+#endif // QPCSCMONITOR_P_H
@@ -5,13 +5,25 @@
 #include "qpcscmanager_p.h"
 #include "qpcsccard_p.h"
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QThread>
 
 QT_BEGIN_NAMESPACE
 
 Q_DECLARE_LOGGING_CATEGORY(QT_NFC_PCSC)
 
-QPcscSlot::QPcscSlot(const QPcscSlotName &name, QPcscManager *manager)
-    : QObject(manager), m_name(name)
+/*
+    Constructs a slot for the reader name. The cards are connected using the
+    context and created as children of cardParent, which must live in the
+    same thread as the slot.
+
+    The slot either lives in the thread of the manager, or in a thread of its
+    own if the manager runs a thread per reader. In the latter case the state
+    changes are forwarded to the thread of the slot.
+*/
+QPcscSlot::QPcscSlot(const QPcscSlotName &name, QPcscManager *manager, SCARDCONTEXT context,
+                     QObject *cardParent, QObject *parent)
+    : QObject(parent), m_name(name), m_manager(manager), m_context(context),
+      m_cardParent(cardParent)
 {
 }
 
@@ -24,6 +36,13 @@ QPcscSlot::~QPcscSlot()
 
 void QPcscSlot::processStateChange(DWORD eventId, bool createCards)
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, eventId, createCards] {
+            processStateChange(eventId, createCards);
+        });
+        return;
+    }
+
     qCDebug(QT_NFC_PCSC) << Q_FUNC_INFO;
 
     // Check if the currently inserted card is still valid
@@ -32,26 +51,42 @@ void QPcscSlot::processStateChange(DWORD eventId, bool createCards)
             return;
         qCDebug(QT_NFC_PCSC) << "Removing card from slot" << m_name;
         m_insertedCard->invalidate();
-        m_insertedCard.clear();
+        setInsertedCard(nullptr);
     }
 
-    auto manager = qobject_cast<QPcscManager *>(parent());
-
-    if (manager != nullptr && createCards
+    if (createCards
         && (eventId
             & (SCARD_STATE_PRESENT | SCARD_STATE_MUTE | SCARD_STATE_UNPOWERED
                | SCARD_STATE_EXCLUSIVE))
                 == SCARD_STATE_PRESENT) {
         qCDebug(QT_NFC_PCSC) << "New card in slot" << m_name;
 
-        m_insertedCard = manager->connectToCard(this);
+        setInsertedCard(m_manager->connectToCard(this));
     }
 }
 
 void QPcscSlot::invalidateInsertedCard()
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this] { invalidateInsertedCard(); });
+        return;
+    }
+
     if (m_insertedCard)
         m_insertedCard->invalidate();
 }
 
+void QPcscSlot::setInsertedCard(QPcscCard *card)
+{
+    m_insertedCard = card;
+    m_hasCard.store(card != nullptr, std::memory_order_release);
+
+    // The card deletes itself once it is invalid and no longer used.
+    if (card) {
+        connect(card, &QObject::destroyed, this, [this] {
+            m_hasCard.store(!m_insertedCard.isNull(), std::memory_order_release);
+        });
+    }
+}
+
 QT_END_NAMESPACE
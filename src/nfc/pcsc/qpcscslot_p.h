@@ -19,6 +19,8 @@
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
 
+#include <atomic>
+
 QT_BEGIN_NAMESPACE
 
 class QPcscManager;
@@ -28,17 +30,28 @@ class QPcscSlot : public QObject
 {
     Q_OBJECT
 public:
-    QPcscSlot(const QPcscSlotName &name, QPcscManager *manager);
+    QPcscSlot(const QPcscSlotName &name, QPcscManager *manager, SCARDCONTEXT context,
+              QObject *cardParent, QObject *parent = nullptr);
     ~QPcscSlot() override;
 
     const QPcscSlotName &name() const { return m_name; }
+    SCARDCONTEXT context() const { return m_context; }
+    QObject *cardParent() const { return m_cardParent; }
+
     void processStateChange(DWORD eventId, bool createCards);
-    bool hasCard() const { return !m_insertedCard.isNull(); }
+    bool hasCard() const { return m_hasCard.load(std::memory_order_acquire); }
     void invalidateInsertedCard();
 
 private:
     const QPcscSlotName m_name;
+    QPcscManager *const m_manager;
+    const SCARDCONTEXT m_context;
+    QObject *const m_cardParent;
     QPointer<QPcscCard> m_insertedCard;
+    // Mirrors m_insertedCard for the manager, if the slot runs in another thread
+    std::atomic<bool> m_hasCard = false;
+
+    void setInsertedCard(QPcscCard *card);
 };
 
 QT_END_NAMESPACE
@@ -40,42 +40,61 @@ QResponseApdu::QResponseApdu(const QByteArray &response)
 QByteArray QCommandApdu::build(uint8_t cla, uint8_t ins, uint8_t p1, uint8_t p2,
                                QByteArrayView data, uint16_t ne)
 {
-    Q_ASSERT(data.size() <= 0xFFFF);
+    return build(cla, ins, p1, p2, data.size(), [&data](char *out) {
+        memcpy(out, data.data(), data.size());
+    }, ne);
+}
+
+/*
+    Builds a command APDU with \a nc bytes of command data. The APDU is
+    allocated once, \a writeData is then called to fill in the command data
+    directly in place.
+*/
+QByteArray QCommandApdu::build(uint8_t cla, uint8_t ins, uint8_t p1, uint8_t p2, qsizetype nc,
+                               qxp::function_ref<void(char *)> writeData, uint16_t ne)
+{
+    Q_ASSERT(nc >= 0 && nc <= 0xFFFF);
 
-    QByteArray apdu;
-    apdu.append(static_cast<char>(cla));
-    apdu.append(static_cast<char>(ins));
-    apdu.append(static_cast<char>(p1));
-    apdu.append(static_cast<char>(p2));
+    const bool extendedLc = nc >= 256;
+    qsizetype size = 4;
+    if (nc > 0)
+        size += (extendedLc ? 3 : 1) + nc;
+    if (ne)
+        size += ne <= 256 ? 1 : (extendedLc ? 2 : 3);
 
-    bool extendedLc = false;
-    uint16_t nc = data.size();
+    QByteArray apdu(size, Qt::Uninitialized);
+    char *out = apdu.data();
+    *out++ = static_cast<char>(cla);
+    *out++ = static_cast<char>(ins);
+    *out++ = static_cast<char>(p1);
+    *out++ = static_cast<char>(p2);
 
     if (nc > 0) {
-        if (nc < 256) {
-            apdu.append(static_cast<char>(nc));
+        if (!extendedLc) {
+            *out++ = static_cast<char>(nc);
         } else {
-            extendedLc = true;
-            apdu.append('\0');
-            apdu.append(static_cast<char>(nc >> 8));
-            apdu.append(static_cast<char>(nc & 0xFF));
+            *out++ = '\0';
+            *out++ = static_cast<char>(nc >> 8);
+            *out++ = static_cast<char>(nc & 0xFF);
         }
-        apdu.append(data);
+        writeData(out);
+        out += nc;
     }
 
     if (ne) {
         if (ne < 256) {
-            apdu.append(static_cast<char>(ne));
+            *out++ = static_cast<char>(ne);
         } else if (ne == 256) {
-            apdu.append(static_cast<char>('\0'));
+            *out++ = '\0';
         } else {
             if (!extendedLc)
-                apdu.append('\0');
-            apdu.append(static_cast<char>(ne >> 8));
-            apdu.append(static_cast<char>(ne & 0xFF));
+                *out++ = '\0';
+            *out++ = static_cast<char>(ne >> 8);
+            *out++ = static_cast<char>(ne & 0xFF);
         }
     }
 
+    Q_ASSERT(out == apdu.constData() + apdu.size());
     return apdu;
 }
 
@@ -16,6 +16,7 @@
 //
 
 #include <QtCore/QByteArray>
+#include <QtCore/qxpfunctional.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -30,6 +31,15 @@ public:
     const QByteArray &data() const { return m_data; }
     uint16_t status() const { return m_status; }
     bool isOk() const { return m_status == Success; }
+    bool isError() const { return isErrorStatus(m_status); }
+
+    // ISO/IEC 7816-4 reports errors with SW1 in the range 0x64 to 0x6F,
+    // SW1 0x61 to 0x63 are successful or warning statuses
+    static constexpr bool isErrorStatus(uint16_t status)
+    {
+        const uint8_t sw1 = status >> 8;
+        return sw1 >= 0x64 && sw1 <= 0x6F;
+    }
 
 private:
     QByteArray m_data;
@@ -46,6 +56,8 @@ constexpr uint8_t UpdateBinary = 0xD6;
 
 QByteArray build(uint8_t cla, uint8_t ins, uint8_t p1, uint8_t p2, QByteArrayView data,
                  uint16_t ne = 0);
+QByteArray build(uint8_t cla, uint8_t ins, uint8_t p1, uint8_t p2, qsizetype nc,
+                 qxp::function_ref<void(char *)> writeData, uint16_t ne = 0);
 };
 
 QT_END_NAMESPACE
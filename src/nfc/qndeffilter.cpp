@@ -4,8 +4,8 @@
 #include "qndeffilter.h"
 #include "qndefmessage.h"
 
+#include <QtCore/QHash>
 #include <QtCore/QList>
-#include <QtCore/QMap>
 #include <QtCore/QVarLengthArray>
 
 QT_BEGIN_NAMESPACE
@@ -224,8 +224,16 @@ class QNdefFilterPrivate : public QSharedData
 public:
     QNdefFilterPrivate();
 
+    void compile();
+
     bool orderMatching;
     QList<QNdefFilter::Record> filterRecords;
+
+    // Compiled from filterRecords whenever the filter changes, so that
+    // match() does not need to allocate anything.
+    using RecordKey = QPair<int, QByteArray>;
+    QList<QNdefFilter::Record> mergedRecords;
+    QHash<RecordKey, qsizetype> mergedRecordIndex; // only used for unordered matching
 };
 
 QNdefFilterPrivate::QNdefFilterPrivate()
@@ -233,6 +241,41 @@ QNdefFilterPrivate::QNdefFilterPrivate()
 {
 }
 
+void QNdefFilterPrivate::compile()
+{
+    mergedRecords.clear();
+    mergedRecordIndex.clear();
+
+    if (!orderMatching) {
+        // Order is not important. The most reliable way is to merge all the
+        // similar records, and then simply check the amount of occurrences.
+        for (const auto &rec : std::as_const(filterRecords)) {
+            const RecordKey key(rec.typeNameFormat, rec.type);
+            const auto it = mergedRecordIndex.constFind(key);
+            if (it != mergedRecordIndex.cend()) {
+                mergedRecords[*it].minimum += rec.minimum;
+                mergedRecords[*it].maximum += rec.maximum;
+            } else {
+                mergedRecordIndex.insert(key, mergedRecords.size());
+                mergedRecords.push_back(rec);
+            }
+        }
+    } else {
+        // Order *is* important. Here we can only merge consecutive records
+        // with the same parameters.
+        for (const auto &rec : std::as_const(filterRecords)) {
+            if (!mergedRecords.isEmpty()
+                && rec.typeNameFormat == mergedRecords.last().typeNameFormat
+                && rec.type == mergedRecords.last().type) {
+                mergedRecords.last().minimum += rec.minimum;
+                mergedRecords.last().maximum += rec.maximum;
+            } else {
+                mergedRecords.push_back(rec);
+            }
+        }
+    }
+}
+
 /*!
     Constructs a new NDEF filter.
 */
@@ -281,69 +324,27 @@ bool QNdefFilter::match(const QNdefMessage &message) const
     if (d->filterRecords.isEmpty())
         return message.isEmpty();
 
+    const auto &mergedRecords = d->mergedRecords;
+
+    // The list contains the current number of occurrences of each merged record.
+    QVarLengthArray<unsigned int, 16> counts(mergedRecords.size(), 0);
+
     bool matched = true;
-    int totalCount = 0;
 
     if (!d->orderMatching) {
-        // Order is not important. The most reliable way is to merge all the
-        // similar records, and then simply check the amount of occurrences.
-        using MapKey = QPair<QNdefRecord::TypeNameFormat, QByteArray>;
-
-        // Creating a map from the list of filter records.
-        QMap<MapKey, Record> joinedFilterRecords;
-        for (const auto &rec : d->filterRecords) {
-            const auto key = qMakePair(rec.typeNameFormat, rec.type);
-            if (joinedFilterRecords.contains(key)) {
-                joinedFilterRecords[key].minimum += rec.minimum;
-                joinedFilterRecords[key].maximum += rec.maximum;
-            } else {
-                joinedFilterRecords.insert(key, rec);
-            }
-        }
         // Checking the message, calculate occurrences.
-        QMap<MapKey, unsigned int> counts; // current number of occurrences
+        const auto &index = d->mergedRecordIndex;
         for (const auto &record : message) {
-            const auto key = qMakePair(record.typeNameFormat(), record.type());
+            using Key = QNdefFilterPrivate::RecordKey;
+            auto it = index.constFind(Key(record.typeNameFormat(), record.type()));
             // Do not forget that we handle an empty type as "any type".
-            const auto emptyTypeKey = qMakePair(record.typeNameFormat(), QByteArray());
+            if (it == index.cend())
+                it = index.constFind(Key(record.typeNameFormat(), QByteArray()));
 
-            if (joinedFilterRecords.contains(key))
-                counts[key] += 1;
-            else if (joinedFilterRecords.contains(emptyTypeKey))
-                counts[emptyTypeKey] += 1;
-        }
-        // Check that the occurrences match [min; max] range.
-        for (auto it = joinedFilterRecords.cbegin(); it != joinedFilterRecords.cend(); ++it) {
-            const auto count = counts.value(it.key(), 0);
-            totalCount += count;
-            if (count < it.value().minimum || count > it.value().maximum) {
-                matched = false;
-                break;
-            }
+            if (it != index.cend())
+                counts[*it] += 1;
         }
     } else {
-        // Order *is* important. Need to iterate the list.
-
-        // Here we need to merge consecutive records with the same parameters.
-        QList<Record> mergedRecords;
-        // we know that filer is not empty here
-        Record currentRecord = d->filterRecords.first();
-        for (qsizetype i = 1; i < d->filterRecords.size(); ++i) {
-            const auto &rec = d->filterRecords.at(i);
-            if (rec.typeNameFormat == currentRecord.typeNameFormat
-                && rec.type == currentRecord.type) {
-                currentRecord.minimum += rec.minimum;
-                currentRecord.maximum += rec.maximum;
-            } else {
-                mergedRecords.push_back(currentRecord);
-                currentRecord = rec;
-            }
-        }
-        mergedRecords.push_back(currentRecord);
-
-        // The list contains the current number of occurrences of each record.
-        QVarLengthArray<unsigned int> counts(mergedRecords.size(), 0);
-
         // Iterate through the messages and calculate the number of occurrences.
         qsizetype filterIndex = 0;
         for (qsizetype messageIndex = 0; matched && messageIndex < message.size(); ++messageIndex) {
@@ -368,18 +369,15 @@ bool QNdefFilter::match(const QNdefMessage &message) const
             }
             filterIndex = idx;
         }
+    }
 
-        if (matched) {
-            // Check that the occurrences match [min; max] range.
-            for (qsizetype i = 0; i < mergedRecords.size(); ++i) {
-                const auto &rec = mergedRecords.at(i);
-                totalCount += counts[i];
-                if (counts[i] < rec.minimum || counts[i] > rec.maximum) {
-                    matched = false;
-                    break;
-                }
-            }
-        }
+    // Check that the occurrences match [min; max] range.
+    int totalCount = 0;
+    for (qsizetype i = 0; matched && i < mergedRecords.size(); ++i) {
+        const auto &rec = mergedRecords.at(i);
+        totalCount += counts[i];
+        if (counts[i] < rec.minimum || counts[i] > rec.maximum)
+            matched = false;
     }
 
     // Check if the message has records that do not match any record from the
@@ -400,6 +398,7 @@ void QNdefFilter::clear()
 {
     d->orderMatching = false;
     d->filterRecords.clear();
+    d->compile();
 }
 
 /*!
@@ -412,7 +411,11 @@ void QNdefFilter::clear()
 */
 void QNdefFilter::setOrderMatch(bool on)
 {
+    if (orderMatch() == on)
+        return;
+
     d->orderMatching = on;
+    d->compile();
 }
 
 /*!
@@ -460,6 +463,7 @@ bool QNdefFilter::appendRecord(const Record &record)
 {
     if (verifyRecord(record)) {
         d->filterRecords.append(record);
+        d->compile();
         return true;
     }
     return false;
@@ -2,8 +2,11 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qndefmessage.h"
+#include "qndefmessage_p.h"
 #include "qndefrecord_p.h"
 
+#include <QtCore/QtEndian>
+
 QT_BEGIN_NAMESPACE
 
 QT_IMPL_METATYPE_EXTERN(QNdefMessage)
@@ -61,152 +64,163 @@ QNdefMessage QNdefMessage::fromByteArray(const QByteArray &message)
 {
     QNdefMessage result;
 
-    bool seenMessageBegin = false;
-    bool seenMessageEnd = false;
-
-    QByteArray partialChunk;
-    QNdefRecord record;
-
-    qsizetype idx = 0;
-    while (idx < message.size()) {
-        quint8 flags = message.at(idx);
-
-        const bool messageBegin = flags & 0x80;
-        const bool messageEnd = flags & 0x40;
-
-        const bool cf = flags & 0x20;
-        const bool sr = flags & 0x10;
-        const bool il = flags & 0x08;
-        const quint8 typeNameFormat = flags & 0x07;
-
-        if (messageBegin && seenMessageBegin) {
-            qWarning("Got message begin but already parsed some records");
-            return QNdefMessage();
-        } else if (!messageBegin && !seenMessageBegin) {
-            qWarning("Haven't got message begin yet");
-            return QNdefMessage();
-        } else if (messageBegin && !seenMessageBegin) {
-            seenMessageBegin = true;
+    QNdefMessageReader reader(message);
+    while (reader.readNext()) {
+        const QNdefRecordView view = reader.record();
+
+        QNdefRecord record;
+        if (view.typeNameFormat != 0x06)
+            record.setTypeNameFormat(QNdefRecord::TypeNameFormat(view.typeNameFormat));
+        if (!view.type.isEmpty())
+            record.setType(view.type.toByteArray());
+        if (!view.id.isEmpty())
+            record.setId(view.id.toByteArray());
+
+        if (!view.chunked) {
+            if (!view.payload.isEmpty())
+                record.setPayload(view.payload.toByteArray());
+            result.append(record);
+            continue;
         }
-        if (messageEnd && seenMessageEnd) {
-            qWarning("Got message end but already parsed final record");
-            return QNdefMessage();
-        } else if (messageEnd && !seenMessageEnd) {
-            seenMessageEnd = true;
+
+        // Sum up the chunk sizes first, so that the payload is allocated only once
+        QNdefMessageReader lookAhead = reader;
+        qsizetype payloadSize = view.payload.size();
+        bool lastChunkFound = false;
+        while (!lastChunkFound && lookAhead.readNext()) {
+            payloadSize += lookAhead.record().payload.size();
+            lastChunkFound = !lookAhead.record().chunked;
         }
-        // TNF must be 0x06 even for the last chunk, when cf == 0.
-        if ((typeNameFormat != 0x06) && !partialChunk.isEmpty()) {
-            qWarning("Partial chunk not empty, but TNF not 0x06 as expected");
+        if (lookAhead.hasError())
             return QNdefMessage();
-        }
-
-        int headerLength = 1;
-        headerLength += (sr) ? 1 : 4;
-        headerLength += (il) ? 1 : 0;
+        if (!lastChunkFound)
+            break; // the message ended within the chunked record
+
+        QByteArray payload;
+        payload.reserve(payloadSize);
+        payload.append(view.payload);
+        do {
+            reader.readNext();
+            payload.append(reader.record().payload);
+        } while (reader.record().chunked);
+
+        record.setPayload(payload);
+        result.append(record);
+    }
 
-        if (idx + headerLength >= message.size()) {
-            qWarning("Unexpected end of message");
-            return QNdefMessage();
-        }
+    if (reader.hasError())
+        return QNdefMessage();
 
-        const quint8 typeLength = message.at(++idx);
+    return result;
+}
 
-        if ((typeNameFormat == 0x06) && (typeLength != 0)) {
-            qWarning("Invalid chunked data, TYPE_LENGTH != 0");
-            return QNdefMessage();
-        }
+bool QNdefMessageReader::setError(const char *message)
+{
+    qWarning("%s", message);
+    m_error = true;
+    return false;
+}
 
-        quint32 payloadLength;
-        if (sr)
-            payloadLength = quint8(message.at(++idx));
-        else {
-            payloadLength = quint8(message.at(++idx)) << 24;
-            payloadLength |= quint8(message.at(++idx)) << 16;
-            payloadLength |= quint8(message.at(++idx)) << 8;
-            payloadLength |= quint8(message.at(++idx)) << 0;
-        }
+bool QNdefMessageReader::readNext()
+{
+    if (m_atEnd || m_error)
+        return false;
 
-        quint8 idLength;
-        if (il)
-            idLength = message.at(++idx);
-        else
-            idLength = 0;
-
-        // On 32-bit systems this can overflow
-        const qsizetype convertedPayloadLength = static_cast<qsizetype>(payloadLength);
-        const qsizetype contentLength = convertedPayloadLength + typeLength + idLength;
-
-        // On a 32 bit platform the payload can theoretically exceed the max.
-        // size of a QByteArray. This will never happen in practice with correct
-        // data because there are no NFC tags that can store such data sizes,
-        // but still can be possible if the data is corrupted.
-        if ((contentLength < 0) || (convertedPayloadLength < 0)
-            || ((std::numeric_limits<qsizetype>::max() - idx) < contentLength)) {
-            qWarning("Payload can't fit into QByteArray");
-            return QNdefMessage();
-        }
+    if (m_position >= m_message.size()) {
+        m_atEnd = true;
+        if (!m_seenMessageBegin || !m_seenMessageEnd)
+            return setError("Malformed NDEF Message, missing begin or end");
+        return false;
+    }
 
-        if (idx + contentLength >= message.size()) {
-            qWarning("Unexpected end of message");
-            return QNdefMessage();
-        }
+    qsizetype idx = m_position;
+    const quint8 flags = m_message.at(idx);
+
+    const bool messageBegin = flags & 0x80;
+    const bool messageEnd = flags & 0x40;
+
+    const bool cf = flags & 0x20;
+    const bool sr = flags & 0x10;
+    const bool il = flags & 0x08;
+    const quint8 typeNameFormat = flags & 0x07;
+
+    if (messageBegin && m_seenMessageBegin)
+        return setError("Got message begin but already parsed some records");
+    else if (!messageBegin && !m_seenMessageBegin)
+        return setError("Haven't got message begin yet");
+    else if (messageBegin && !m_seenMessageBegin)
+        m_seenMessageBegin = true;
+
+    if (messageEnd && m_seenMessageEnd)
+        return setError("Got message end but already parsed final record");
+    else if (messageEnd && !m_seenMessageEnd)
+        m_seenMessageEnd = true;
+
+    // TNF must be 0x06 even for the last chunk, when cf == 0.
+    if ((typeNameFormat != 0x06) && m_inChunk)
+        return setError("Partial chunk not empty, but TNF not 0x06 as expected");
+
+    int headerLength = 1;
+    headerLength += (sr) ? 1 : 4;
+    headerLength += (il) ? 1 : 0;
+
+    if (idx + headerLength >= m_message.size())
+        return setError("Unexpected end of message");
+
+    const quint8 typeLength = m_message.at(++idx);
+
+    if ((typeNameFormat == 0x06) && (typeLength != 0))
+        return setError("Invalid chunked data, TYPE_LENGTH != 0");
+
+    quint32 payloadLength;
+    if (sr) {
+        payloadLength = quint8(m_message.at(++idx));
+    } else {
+        payloadLength = quint8(m_message.at(++idx)) << 24;
+        payloadLength |= quint8(m_message.at(++idx)) << 16;
+        payloadLength |= quint8(m_message.at(++idx)) << 8;
+        payloadLength |= quint8(m_message.at(++idx)) << 0;
+    }
 
-        if ((typeNameFormat == 0x06) && il) {
-            qWarning("Invalid chunked data, IL != 0");
-            return QNdefMessage();
-        }
+    const quint8 idLength = il ? quint8(m_message.at(++idx)) : 0;
 
-        if (typeNameFormat != 0x06)
-            record.setTypeNameFormat(QNdefRecord::TypeNameFormat(typeNameFormat));
+    // On 32-bit systems this can overflow
+    const qsizetype convertedPayloadLength = static_cast<qsizetype>(payloadLength);
+    const qsizetype contentLength = convertedPayloadLength + typeLength + idLength;
 
-        if (typeLength > 0) {
-            QByteArray type(&message.constData()[++idx], typeLength);
-            record.setType(type);
-            idx += typeLength - 1;
-        }
+    // On a 32 bit platform the payload can theoretically exceed the max.
+    // size of a QByteArray. This will never happen in practice with correct
+    // data because there are no NFC tags that can store such data sizes,
+    // but still can be possible if the data is corrupted.
+    if ((contentLength < 0) || (convertedPayloadLength < 0)
+        || ((std::numeric_limits<qsizetype>::max() - idx) < contentLength)) {
+        return setError("Payload can't fit into QByteArray");
+    }
 
-        if (idLength > 0) {
-            QByteArray id(&message.constData()[++idx], idLength);
-            record.setId(id);
-            idx += idLength - 1;
-        }
+    if (idx + contentLength >= m_message.size())
+        return setError("Unexpected end of message");
 
-        if (payloadLength > 0) {
-            QByteArray payload(&message.constData()[++idx], payloadLength);
-
-            if (cf) {
-                // chunked payload, except last
-                partialChunk.append(payload);
-            } else if (typeNameFormat == 0x06) {
-                // last chunk of chunked payload
-                record.setPayload(partialChunk + payload);
-                partialChunk.clear();
-            } else {
-                // non-chunked payload
-                record.setPayload(payload);
-            }
-
-            idx += payloadLength - 1;
-        }
+    if ((typeNameFormat == 0x06) && il)
+        return setError("Invalid chunked data, IL != 0");
 
-        if (!cf) {
-            result.append(record);
-            record = QNdefRecord();
-        }
+    // move to the record content
+    ++idx;
 
-        if (!cf && seenMessageEnd)
-            break;
+    m_record.typeNameFormat = typeNameFormat;
+    m_record.chunked = cf;
+    m_record.type = m_message.sliced(idx, typeLength);
+    idx += typeLength;
+    m_record.id = m_message.sliced(idx, idLength);
+    idx += idLength;
+    m_record.payload = m_message.sliced(idx, convertedPayloadLength);
+    idx += convertedPayloadLength;
 
-        // move to start of next record
-        ++idx;
-    }
+    m_inChunk = cf;
 
-    if (!seenMessageBegin || !seenMessageEnd) {
-        qWarning("Malformed NDEF Message, missing begin or end");
-        return QNdefMessage();
-    }
+    // anything following the final record is ignored
+    m_position = (!cf && m_seenMessageEnd) ? m_message.size() : idx;
 
-    return result;
+    return true;
 }
 
 /*!
@@ -269,57 +283,99 @@ bool QNdefMessage::operator==(const QNdefMessage &other) const
 */
 QByteArray QNdefMessage::toByteArray() const
 {
-    // An empty message is treated as a message containing a single empty record.
-    if (isEmpty())
-        return QNdefMessage(QNdefRecord()).toByteArray();
+    QByteArray m(QNdefMessageWriter::encodedSize(*this), Qt::Uninitialized);
+    QNdefMessageWriter::write(*this, m.data(), m.size());
+    return m;
+}
 
-    QByteArray m;
+static quint8 recordFlags(const QNdefRecord &record)
+{
+    quint8 flags = record.typeNameFormat();
 
-    for (qsizetype i = 0; i < size(); ++i) {
-        const QNdefRecord &record = at(i);
+    // cf (chunked records) not supported yet
 
-        quint8 flags = record.typeNameFormat();
+    if (record.payload().size() < 255)
+        flags |= 0x10;
 
-        if (i == 0)
-            flags |= 0x80;
-        if (i == size() - 1)
-            flags |= 0x40;
+    if (!record.id().isEmpty())
+        flags |= 0x08;
+
+    return flags;
+}
 
-        // cf (chunked records) not supported yet
+static qsizetype recordSize(const QNdefRecord &record)
+{
+    const quint8 flags = recordFlags(record);
 
-        if (record.payload().size() < 255)
-            flags |= 0x10;
+    // flags, type length, payload length and optional id length
+    qsizetype size = 2 + ((flags & 0x10) ? 1 : 4) + ((flags & 0x08) ? 1 : 0);
 
-        if (!record.id().isEmpty())
-            flags |= 0x08;
+    return size + record.type().size() + record.id().size() + record.payload().size();
+}
 
-        m.append(flags);
-        m.append(record.type().size());
+static char *writeRecord(const QNdefRecord &record, quint8 positionFlags, char *out)
+{
+    const quint8 flags = recordFlags(record) | positionFlags;
 
-        if (flags & 0x10) {
-            m.append(quint8(record.payload().size()));
-        } else {
-            quint32 length = record.payload().size();
-            m.append(length >> 24);
-            m.append(length >> 16);
-            m.append(length >> 8);
-            m.append(length & 0x000000ff);
+    *out++ = char(flags);
+    *out++ = char(record.type().size());
+
+    if (flags & 0x10) {
+        *out++ = char(record.payload().size());
+    } else {
+        qToBigEndian<quint32>(record.payload().size(), out);
+        out += 4;
+    }
+
+    if (flags & 0x08)
+        *out++ = char(record.id().size());
+
+    const auto append = [&out](const QByteArray &data) {
+        if (!data.isEmpty()) {
+            memcpy(out, data.constData(), data.size());
+            out += data.size();
         }
+    };
+    append(record.type());
+    append(record.id());
+    append(record.payload());
+
+    return out;
+}
 
-        if (flags & 0x08)
-            m.append(record.id().size());
+qsizetype QNdefMessageWriter::encodedSize(const QNdefMessage &message)
+{
+    // An empty message is treated as a message containing a single empty record.
+    if (message.isEmpty())
+        return recordSize(QNdefRecord());
 
-        if (!record.type().isEmpty())
-            m.append(record.type());
+    qsizetype size = 0;
+    for (const QNdefRecord &record : message)
+        size += recordSize(record);
 
-        if (!record.id().isEmpty())
-            m.append(record.id());
+    return size;
+}
+
+qsizetype QNdefMessageWriter::write(const QNdefMessage &message, char *buffer, qsizetype size)
+{
+    if (encodedSize(message) > size)
+        return -1;
 
-        if (!record.payload().isEmpty())
-            m.append(record.payload());
+    if (message.isEmpty())
+        return writeRecord(QNdefRecord(), 0x80 | 0x40, buffer) - buffer;
+
+    char *out = buffer;
+    for (qsizetype i = 0; i < message.size(); ++i) {
+        quint8 positionFlags = 0;
+        if (i == 0)
+            positionFlags |= 0x80;
+        if (i == message.size() - 1)
+            positionFlags |= 0x40;
+
+        out = writeRecord(message.at(i), positionFlags, out);
     }
 
-    return m;
+    return out - buffer;
 }
 
 QT_END_NAMESPACE
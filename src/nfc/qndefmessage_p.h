@@ -0,0 +1,78 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QNDEFMESSAGE_P_H
+#define QNDEFMESSAGE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qtnfcglobal.h"
+
+#include <QtCore/QByteArrayView>
+
+QT_BEGIN_NAMESPACE
+
+class QNdefMessage;
+
+// One record or record chunk of a raw NDEF message. The views point into the
+// message passed to QNdefMessageReader and are only valid as long as it is.
+struct QNdefRecordView
+{
+    quint8 typeNameFormat = 0; // 0x06 (unchanged) for all but the first chunk
+    bool chunked = false;      // another chunk of the same payload follows
+    QByteArrayView type;
+    QByteArrayView id;
+    QByteArrayView payload;
+};
+
+// Walks the records of a raw NDEF message without copying any of its data.
+class Q_AUTOTEST_EXPORT QNdefMessageReader
+{
+public:
+    explicit QNdefMessageReader(QByteArrayView message) : m_message(message) { }
+
+    // Advances to the next record chunk. Returns false at the end of the
+    // message or if the message is malformed, see hasError().
+    bool readNext();
+
+    const QNdefRecordView &record() const { return m_record; }
+    bool hasError() const { return m_error; }
+
+private:
+    bool setError(const char *message);
+
+    QByteArrayView m_message;
+    qsizetype m_position = 0;
+    QNdefRecordView m_record;
+    bool m_seenMessageBegin = false;
+    bool m_seenMessageEnd = false;
+    bool m_inChunk = false;
+    bool m_atEnd = false;
+    bool m_error = false;
+};
+
+// Serializes a message in two passes: encodedSize() computes the exact size of
+// the raw message, write() then fills a buffer of at least that size without
+// any intermediate allocations.
+class Q_AUTOTEST_EXPORT QNdefMessageWriter
+{
+public:
+    static qsizetype encodedSize(const QNdefMessage &message);
+
+    // Returns the number of bytes written, or -1 if the message does not fit
+    // into size bytes.
+    static qsizetype write(const QNdefMessage &message, char *buffer, qsizetype size);
+};
+
+QT_END_NAMESPACE
+
+#endif // QNDEFMESSAGE_P_H
@@ -106,6 +106,8 @@ void QNearFieldManagerPrivateImpl::onCardInserted(QPcscCard *card, const QByteAr
     connect(priv, &QNearFieldTargetPrivateImpl::destroyed, card, &QPcscCard::onTargetDestroyed);
     connect(priv, &QNearFieldTargetPrivateImpl::sendCommandRequest, card,
             &QPcscCard::onSendCommandRequest);
+    connect(priv, &QNearFieldTargetPrivateImpl::sendCommandsRequest, card,
+            &QPcscCard::onSendCommandsRequest);
     connect(priv, &QNearFieldTargetPrivateImpl::readNdefMessagesRequest, card,
             &QPcscCard::onReadNdefMessagesRequest);
     connect(priv, &QNearFieldTargetPrivateImpl::writeNdefMessagesRequest, card,
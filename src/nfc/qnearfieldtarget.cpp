@@ -39,7 +39,8 @@ QT_IMPL_METATYPE_EXTERN_TAGGED(QNearFieldTarget::RequestId, QNearFieldTarget__Re
     and set the NDEF message.
 
     If the target supports TagTypeSpecificAccess, sendCommand() can be used to send a single
-    proprietary command to the target and retrieve the response.
+    proprietary command to the target and retrieve the response. sendCommands() sends a
+    sequence of commands as one request.
 */
 
 /*!
@@ -94,6 +95,20 @@ QT_IMPL_METATYPE_EXTERN_TAGGED(QNearFieldTarget::RequestId, QNearFieldTarget__Re
                                     required entitlement and/or privacy settings from the client app.
 */
 
+/*!
+    \enum QNearFieldTarget::CommandBatchOption
+    \since 6.9
+
+    This enum describes how sendCommands() handles the responses to a sequence of commands.
+
+    \value NoCommandBatchOption     All the commands are sent, regardless of their responses.
+    \value StopOnErrorStatus        No further commands are sent after a response that ends with
+                                    an ISO/IEC 7816-4 error status word, that is SW1 in the
+                                    range 0x64 to 0x6F.
+
+    The CommandBatchOptions type is a typedef for QFlags<CommandBatchOption>.
+*/
+
 /*!
     \fn void QNearFieldTarget::disconnected()
 
@@ -364,6 +379,38 @@ QNearFieldTarget::RequestId QNearFieldTarget::sendCommand(const QByteArray &comm
     return d->sendCommand(command);
 }
 
+/*!
+    \since 6.9
+
+    Sends \a commands to the near field target one after another as a single request. Returns a
+    request id which can be used to track the completion status of the request. An invalid request
+    id will be returned if the target does not support sending tag type specific commands.
+
+    Where supported, the whole sequence is executed by the backend without returning to the
+    calling thread between the commands, and within one exclusive transaction with the target.
+    The \a options control whether the sequence is stopped early based on the responses.
+
+    The requestCompleted() signal will be emitted once all the commands have been sent, or the
+    sequence was stopped due to \a options. If sending any of the commands fails, the error()
+    signal will be emitted.
+
+    Once the request completes successfully the responses can be retrieved from the
+    requestResponse() function. The response of this request will be a QList<QByteArray>
+    with one entry per command that was sent.
+
+    \note Currently only the PC/SC backend supports this function. Other backends report
+    QNearFieldTarget::UnsupportedError.
+
+    \sa sendCommand(), requestCompleted(), waitForRequestCompleted()
+*/
+QNearFieldTarget::RequestId QNearFieldTarget::sendCommands(const QList<QByteArray> &commands,
+                                                           CommandBatchOptions options)
+{
+    Q_D(QNearFieldTarget);
+
+    return d->sendCommands(commands, options);
+}
+
 /*!
     Waits up to \a msecs milliseconds for the request \a id to complete.
     Returns \c true if the request completes successfully and the
@@ -64,6 +64,13 @@ public:
     };
     Q_ENUM(Error)
 
+    enum CommandBatchOption {
+        NoCommandBatchOption = 0x00,
+        StopOnErrorStatus = 0x01
+    };
+    Q_ENUM(CommandBatchOption)
+    Q_DECLARE_FLAGS(CommandBatchOptions, CommandBatchOption)
+
     class RequestIdPrivate;
     class Q_NFC_EXPORT RequestId
     {
@@ -102,6 +109,8 @@ public:
     // TagTypeSpecificAccess
     int maxCommandLength() const;
     RequestId sendCommand(const QByteArray &command);
+    RequestId sendCommands(const QList<QByteArray> &commands,
+                           CommandBatchOptions options = NoCommandBatchOption);
 
     bool waitForRequestCompleted(const RequestId &id, int msecs = 5000);
     QVariant requestResponse(const RequestId &id) const;
@@ -123,6 +132,7 @@ private:
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(QNearFieldTarget::AccessMethods)
+Q_DECLARE_OPERATORS_FOR_FLAGS(QNearFieldTarget::CommandBatchOptions)
 
 QT_END_NAMESPACE
 
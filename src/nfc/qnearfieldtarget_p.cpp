@@ -3,9 +3,9 @@
 
 #include "qnearfieldtarget_p.h"
 
-#include <QtCore/QCoreApplication>
-#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
 #include <QtCore/QPointer>
+#include <QtCore/QTimer>
 
 QT_BEGIN_NAMESPACE
 
@@ -74,23 +74,50 @@ QNearFieldTarget::RequestId QNearFieldTargetPrivate::sendCommand(const QByteArra
     return id;
 }
 
+QNearFieldTarget::RequestId
+QNearFieldTargetPrivate::sendCommands(const QList<QByteArray> &commands,
+                                      QNearFieldTarget::CommandBatchOptions options)
+{
+    Q_UNUSED(commands);
+    Q_UNUSED(options);
+
+    const QNearFieldTarget::RequestId id;
+    Q_EMIT error(QNearFieldTarget::UnsupportedError, id);
+    return id;
+}
+
 bool QNearFieldTargetPrivate::waitForRequestCompleted(const QNearFieldTarget::RequestId &id,
                                                       int msecs)
 {
-    QElapsedTimer timer;
-    timer.start();
+    const auto hasResponse = [this, &id] {
+        QMutexLocker locker(&m_responseStore->mutex);
+        return m_responseStore->responses.contains(id.d.constData());
+    };
+
+    if (hasResponse())
+        return true;
 
     const QPointer<QNearFieldTargetPrivate> weakThis = this;
 
-    do {
-        if (!weakThis)
-            return false;
+    QEventLoop loop;
+    QTimer timer;
+    timer.setSingleShot(true);
+    connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
+    connect(this, &QNearFieldTargetPrivate::responseStored, &loop,
+            [&loop, &id](const QNearFieldTarget::RequestId &stored) {
+        if (stored == id)
+            loop.quit();
+    });
+    connect(this, &QObject::destroyed, &loop, &QEventLoop::quit);
 
-        if (m_decodedResponses.contains(id))
-            return true;
-        else
-            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 1);
-    } while (timer.elapsed() <= msecs);
+    timer.start(msecs);
+    loop.exec();
+
+    if (!weakThis)
+        return false;
+
+    if (hasResponse())
+        return true;
 
     reportError(QNearFieldTarget::TimeoutError, id);
 
@@ -99,22 +126,24 @@ bool QNearFieldTargetPrivate::waitForRequestCompleted(const QNearFieldTarget::Re
 
 QVariant QNearFieldTargetPrivate::requestResponse(const QNearFieldTarget::RequestId &id) const
 {
-    return m_decodedResponses.value(id);
+    QMutexLocker locker(&m_responseStore->mutex);
+    return m_responseStore->responses.value(id.d.constData());
 }
 
 void QNearFieldTargetPrivate::setResponseForRequest(const QNearFieldTarget::RequestId &id,
                                                     const QVariant &response,
                                                     bool emitRequestCompleted)
 {
-    for (auto i = m_decodedResponses.begin(), end = m_decodedResponses.end(); i != end; /* erasing */) {
-        // no more external references
-        if (i.key().refCount() == 1)
-            i = m_decodedResponses.erase(i);
-        else
-            ++i;
+    {
+        QMutexLocker locker(&m_responseStore->mutex);
+        m_responseStore->responses.insert(id.d.constData(), response);
     }
 
-    m_decodedResponses.insert(id, response);
+    // The response is removed once there are no more references to the request
+    if (id.isValid())
+        id.d.constData()->responseStore = m_responseStore;
+
+    Q_EMIT responseStored(id);
 
     if (emitRequestCompleted)
         Q_EMIT requestCompleted(id);
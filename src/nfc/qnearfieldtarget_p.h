@@ -18,16 +18,40 @@
 #include "qnearfieldtarget.h"
 
 #include <QtCore/QByteArray>
+#include <QtCore/QHash>
 #include <QtCore/QList>
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QSharedData>
 #include <QtCore/QVariant>
-#include <QtCore/QMap>
+
+#include <memory>
 
 QT_BEGIN_NAMESPACE
 
+// Responses of a target, keyed by request. Shared with the request ids that
+// have a response, so that they can remove it when they are destroyed, which
+// may happen in any thread.
+struct QNearFieldTargetResponseStore
+{
+    QMutex mutex;
+    QHash<const QNearFieldTarget::RequestIdPrivate *, QVariant> responses;
+};
+
 class QNearFieldTarget::RequestIdPrivate : public QSharedData
 {
+public:
+    ~RequestIdPrivate()
+    {
+        if (auto store = responseStore.lock()) {
+            QMutexLocker locker(&store->mutex);
+            store->responses.remove(this);
+        }
+    }
+
+    // Set when a response is stored for this request, the response is
+    // dropped together with the last handle to the request.
+    mutable std::weak_ptr<QNearFieldTargetResponseStore> responseStore;
 };
 
 class Q_AUTOTEST_EXPORT QNearFieldTargetPrivate : public QObject
@@ -54,6 +78,9 @@ public:
     // TagTypeSpecificAccess
     virtual int maxCommandLength() const;
     virtual QNearFieldTarget::RequestId sendCommand(const QByteArray &command);
+    virtual QNearFieldTarget::RequestId
+    sendCommands(const QList<QByteArray> &commands,
+                 QNearFieldTarget::CommandBatchOptions options);
 
     bool waitForRequestCompleted(const QNearFieldTarget::RequestId &id, int msecs = 5000);
     QVariant requestResponse(const QNearFieldTarget::RequestId &id) const;
@@ -61,6 +88,9 @@ public:
 Q_SIGNALS:
     void disconnected();
 
+    // Internal, emitted whenever a response or an error was stored for a request
+    void responseStored(const QNearFieldTarget::RequestId &id);
+
     void ndefMessageRead(const QNdefMessage &message);
 
     void requestCompleted(const QNearFieldTarget::RequestId &id);
@@ -68,7 +98,8 @@ Q_SIGNALS:
     void error(QNearFieldTarget::Error error, const QNearFieldTarget::RequestId &id);
 
 protected:
-    QMap<QNearFieldTarget::RequestId, QVariant> m_decodedResponses;
+    const std::shared_ptr<QNearFieldTargetResponseStore> m_responseStore =
+            std::make_shared<QNearFieldTargetResponseStore>();
 
     virtual void setResponseForRequest(const QNearFieldTarget::RequestId &id,
                                        const QVariant &response,
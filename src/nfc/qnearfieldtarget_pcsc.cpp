@@ -103,6 +103,24 @@ QNearFieldTarget::RequestId QNearFieldTargetPrivateImpl::sendCommand(const QByte
     return reqId;
 }
 
+QNearFieldTarget::RequestId
+QNearFieldTargetPrivateImpl::sendCommands(const QList<QByteArray> &commands,
+                                          QNearFieldTarget::CommandBatchOptions options)
+{
+    qCDebug(QT_NFC_PCSC) << Q_FUNC_INFO;
+
+    if (!m_isValid)
+        return QNearFieldTarget::RequestId(nullptr);
+
+    m_connected = true;
+
+    QNearFieldTarget::RequestId reqId(new QNearFieldTarget::RequestIdPrivate);
+    Q_EMIT sendCommandsRequest(reqId, commands,
+                               options.testFlag(QNearFieldTarget::StopOnErrorStatus));
+
+    return reqId;
+}
+
 QNearFieldTarget::RequestId QNearFieldTargetPrivateImpl::readNdefMessages()
 {
     qCDebug(QT_NFC_PCSC) << Q_FUNC_INFO;
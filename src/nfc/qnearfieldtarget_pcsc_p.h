@@ -36,6 +36,9 @@ public:
 
     int maxCommandLength() const override;
     QNearFieldTarget::RequestId sendCommand(const QByteArray &command) override;
+    QNearFieldTarget::RequestId
+    sendCommands(const QList<QByteArray> &commands,
+                 QNearFieldTarget::CommandBatchOptions options) override;
     QNearFieldTarget::RequestId readNdefMessages() override;
     QNearFieldTarget::RequestId writeNdefMessages(const QList<QNdefMessage> &messages) override;
 
@@ -56,6 +59,8 @@ public Q_SLOTS:
 Q_SIGNALS:
     void disconnectRequest();
     void sendCommandRequest(const QNearFieldTarget::RequestId &request, const QByteArray &command);
+    void sendCommandsRequest(const QNearFieldTarget::RequestId &request,
+                             const QList<QByteArray> &commands, bool stopOnErrorStatus);
     void readNdefMessagesRequest(const QNearFieldTarget::RequestId &request);
     void writeNdefMessagesRequest(const QNearFieldTarget::RequestId &request,
                                   const QList<QNdefMessage> &messages);
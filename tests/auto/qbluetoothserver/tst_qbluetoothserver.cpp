@@ -136,6 +136,23 @@ void tst_QBluetoothServer::tst_construction()
         QCOMPARE(server.error(), QBluetoothServer::NoError);
         QCOMPARE(server.serverType(), QBluetoothServiceInfo::L2capProtocol);
     }
+
+    {
+        QBluetoothServer server(QBluetoothServiceInfo::L2capLeProtocol);
+
+        QVERIFY(!server.isListening());
+        QCOMPARE(server.maxPendingConnections(), 1);
+        QVERIFY(!server.hasPendingConnections());
+        QVERIFY(server.nextPendingConnection() == 0);
+        QCOMPARE(server.error(), QBluetoothServer::NoError);
+        QCOMPARE(server.serverType(), QBluetoothServiceInfo::L2capLeProtocol);
+
+        // LE channels are not announced via SDP
+        const QBluetoothServiceInfo info = server.listen(QBluetoothUuid::createUuid(),
+                                                         QStringLiteral("LE channel"));
+        QVERIFY(!info.isValid());
+        QVERIFY(!server.isListening());
+    }
 }
 
 void tst_QBluetoothServer::tst_receive_data()
@@ -12,6 +12,8 @@
 #include <qbluetoothlocaldevice.h>
 #if QT_CONFIG(bluez)
 #include <QtBluetooth/private/bluez5_helper_p.h>
+
+#include <sys/socket.h>
 #endif
 
 QT_USE_NAMESPACE
@@ -58,6 +60,8 @@ private slots:
 
     void tst_unsupportedProtocolError();
 
+    void tst_leChannelTransport();
+
 public slots:
     void serviceDiscovered(const QBluetoothServiceInfo &info);
     void finished();
@@ -568,6 +572,47 @@ void tst_QBluetoothSocket::tst_unsupportedProtocolError()
     QCOMPARE(socket.state(), QBluetoothSocket::SocketState::UnconnectedState);
 }
 
+void tst_QBluetoothSocket::tst_leChannelTransport()
+{
+#if QT_CONFIG(bluez)
+    // A connected SOCK_SEQPACKET pair stands in for an LE credit based channel,
+    // both preserve the SDU boundaries.
+    int fds[2];
+    QCOMPARE(::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds), 0);
+
+    QBluetoothSocket client(QBluetoothServiceInfo::L2capLeProtocol);
+    QBluetoothSocket server(QBluetoothServiceInfo::L2capLeProtocol);
+    QVERIFY(client.setSocketDescriptor(fds[0], QBluetoothServiceInfo::L2capLeProtocol));
+    QVERIFY(server.setSocketDescriptor(fds[1], QBluetoothServiceInfo::L2capLeProtocol));
+    QCOMPARE(client.socketType(), QBluetoothServiceInfo::L2capLeProtocol);
+    QCOMPARE(client.state(), QBluetoothSocket::SocketState::ConnectedState);
+    QCOMPARE(server.state(), QBluetoothSocket::SocketState::ConnectedState);
+
+    QByteArray payload(10000, Qt::Uninitialized);
+    for (qsizetype i = 0; i < payload.size(); ++i)
+        payload[i] = char(i % 251);
+
+    QSignalSpy bytesWrittenSpy(&client, &QBluetoothSocket::bytesWritten);
+    QCOMPARE(client.write(payload), payload.size());
+    QTRY_COMPARE(server.bytesAvailable(), payload.size());
+    QCOMPARE(server.readAll(), payload);
+    QCOMPARE(client.bytesToWrite(), 0);
+    QVERIFY(!bytesWrittenSpy.isEmpty());
+
+    const QByteArray reply("ack");
+    QCOMPARE(server.write(reply), reply.size());
+    QTRY_COMPARE(client.bytesAvailable(), reply.size());
+    QCOMPARE(client.readAll(), reply);
+
+    QSignalSpy disconnectedSpy(&client, &QBluetoothSocket::disconnected);
+    server.abort();
+    QTRY_COMPARE(disconnectedSpy.size(), 1);
+    QCOMPARE(client.state(), QBluetoothSocket::SocketState::UnconnectedState);
+#else
+    QSKIP("LE L2CAP channels are only supported by BlueZ");
+#endif
+}
+
 QTEST_MAIN(tst_QBluetoothSocket)
 
 #include "tst_qbluetoothsocket.moc"
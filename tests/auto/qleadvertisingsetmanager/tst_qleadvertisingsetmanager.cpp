@@ -0,0 +1,100 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtCore/QThread>
+
+#include <QtBluetooth/qbluetoothaddress.h>
+
+// The manager is only exported by developer builds
+#if defined(QT_BUILD_INTERNAL) && defined(CONFIG_BLUEZ_LE)
+#include <QtBluetooth/private/hcimanager_p.h>
+#include <QtBluetooth/private/qleadvertiser_bluez_p.h>
+#define HAS_ADVERTISING_SET_MANAGER
+#endif
+
+#include <memory>
+
+QT_USE_NAMESPACE
+
+using namespace std::chrono_literals;
+
+class tst_QLeAdvertisingSetManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sharedPerAdapter();
+    void recreatedAfterRelease();
+    void notSharedBetweenThreads();
+};
+
+// No Bluetooth hardware is needed, the manager only sends commands once
+// advertising is started.
+
+void tst_QLeAdvertisingSetManager::sharedPerAdapter()
+{
+#ifdef HAS_ADVERTISING_SET_MANAGER
+    const auto hciManager = std::make_shared<HciManager>(QBluetoothAddress());
+
+    const auto first = QLeAdvertisingSetManager::forHciManager(hciManager);
+    QVERIFY(first);
+    const auto second = QLeAdvertisingSetManager::forHciManager(hciManager);
+    QCOMPARE(second, first);
+
+    // Another HciManager for the same adapter gets the same manager as well
+    const auto otherHciManager = std::make_shared<HciManager>(QBluetoothAddress());
+    QCOMPARE(otherHciManager->hciDeviceId(), hciManager->hciDeviceId());
+    QCOMPARE(QLeAdvertisingSetManager::forHciManager(otherHciManager), first);
+#else
+    QSKIP("This test requires a developer build with BlueZ LE support");
+#endif
+}
+
+void tst_QLeAdvertisingSetManager::recreatedAfterRelease()
+{
+#ifdef HAS_ADVERTISING_SET_MANAGER
+    const auto hciManager = std::make_shared<HciManager>(QBluetoothAddress());
+
+    auto manager = QLeAdvertisingSetManager::forHciManager(hciManager);
+    QVERIFY(manager);
+    const std::weak_ptr<QLeAdvertisingSetManager> released = manager;
+    manager.reset();
+    QVERIFY(released.expired());
+
+    // The released manager is not handed out again
+    manager = QLeAdvertisingSetManager::forHciManager(hciManager);
+    QVERIFY(manager);
+    QVERIFY(manager.use_count() == 1);
+    QCOMPARE(QLeAdvertisingSetManager::forHciManager(hciManager), manager);
+#else
+    QSKIP("This test requires a developer build with BlueZ LE support");
+#endif
+}
+
+void tst_QLeAdvertisingSetManager::notSharedBetweenThreads()
+{
+#ifdef HAS_ADVERTISING_SET_MANAGER
+    const auto hciManager = std::make_shared<HciManager>(QBluetoothAddress());
+    const auto manager = QLeAdvertisingSetManager::forHciManager(hciManager);
+    QVERIFY(manager);
+
+    std::shared_ptr<QLeAdvertisingSetManager> threadManager;
+    std::unique_ptr<QThread> thread(QThread::create([&]() {
+        threadManager = QLeAdvertisingSetManager::forHciManager(hciManager);
+    }));
+    thread->start();
+    QVERIFY(thread->wait(5s));
+
+    QVERIFY(threadManager);
+    QVERIFY(threadManager != manager);
+    QCOMPARE(threadManager->thread(), thread.get());
+#else
+    QSKIP("This test requires a developer build with BlueZ LE support");
+#endif
+}
+
+QTEST_MAIN(tst_QLeAdvertisingSetManager)
+
+#include "tst_qleadvertisingsetmanager.moc"
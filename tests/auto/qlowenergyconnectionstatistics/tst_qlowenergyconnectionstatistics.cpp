@@ -0,0 +1,258 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtBluetooth/qlowenergycharacteristicdata.h>
+#include <QtBluetooth/qlowenergyconnectionstatistics.h>
+#include <QtBluetooth/qlowenergycontroller.h>
+#include <QtBluetooth/qlowenergydescriptordata.h>
+#include <QtBluetooth/qlowenergyservicedata.h>
+
+#include "../../shared/lesocketpair_p.h"
+
+#include <limits>
+#include <memory>
+#include <numeric>
+
+QT_USE_NAMESPACE
+
+constexpr quint8 attReadRequest = 0x0a;
+
+static quint64 latencyCount(const QLowEnergyConnectionStatistics &statistics, quint8 opcode)
+{
+    const QList<quint64> histogram = statistics.latencyHistogram(opcode);
+    return std::accumulate(histogram.cbegin(), histogram.cend(), quint64(0));
+}
+
+class tst_QLowEnergyConnectionStatistics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void defaults();
+    void copyAndSwap();
+    void latencyBucketLimit_data();
+    void latencyBucketLimit();
+    void unknownOpcode();
+    void bluezCounters();
+};
+
+void tst_QLowEnergyConnectionStatistics::initTestCase()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    useLeSocketPairBackend();
+#endif
+}
+
+void tst_QLowEnergyConnectionStatistics::defaults()
+{
+    const QLowEnergyConnectionStatistics statistics;
+    QCOMPARE(statistics.requestCount(), 0u);
+    QCOMPARE(statistics.requestTimeoutCount(), 0u);
+    QCOMPARE(statistics.errorResponseCount(), 0u);
+    QCOMPARE(statistics.pendingRequestCount(), 0);
+    QCOMPARE(statistics.maximumPendingRequestCount(), 0);
+    QCOMPARE(statistics.notificationCount(), 0u);
+    QCOMPARE(statistics.notifiedBytes(), 0u);
+    QCOMPARE(statistics.writeCount(), 0u);
+    QCOMPARE(statistics.writtenBytes(), 0u);
+    QCOMPARE(statistics.mtuExchangeCount(), 0u);
+    QCOMPARE(statistics.encryptionChangeCount(), 0u);
+    QVERIFY(statistics.latencyOpcodes().isEmpty());
+
+    // A controller that never connected has empty statistics
+    std::unique_ptr<QLowEnergyController> controller(QLowEnergyController::createPeripheral());
+    const QLowEnergyConnectionStatistics snapshot = controller->statistics();
+    QCOMPARE(snapshot.requestCount(), 0u);
+    QCOMPARE(snapshot.pendingRequestCount(), 0);
+    QCOMPARE(snapshot.notificationCount(), 0u);
+    QVERIFY(snapshot.latencyOpcodes().isEmpty());
+}
+
+void tst_QLowEnergyConnectionStatistics::copyAndSwap()
+{
+    QLowEnergyConnectionStatistics empty;
+    QLowEnergyConnectionStatistics copy(empty);
+    QCOMPARE(copy.requestCount(), 0u);
+    copy = empty;
+    QCOMPARE(copy.writeCount(), 0u);
+    copy.swap(empty);
+    QCOMPARE(copy.notificationCount(), 0u);
+    QCOMPARE(empty.notificationCount(), 0u);
+
+#ifdef HAS_LE_SOCKET_PAIR
+    // Non-zero values need a connection
+    std::unique_ptr<QLowEnergyController> peripheral(QLowEnergyController::createPeripheral());
+    std::unique_ptr<QLowEnergyController> central(
+            connectLeSocketPairCentral(peripheral.get()));
+    QVERIFY(central);
+    QTRY_COMPARE(central->statistics().mtuExchangeCount(), 1u);
+
+    const QLowEnergyConnectionStatistics connected = central->statistics();
+    const quint64 requests = connected.requestCount();
+    QVERIFY(requests > 0);
+
+    QLowEnergyConnectionStatistics other;
+    other = connected;
+    QCOMPARE(other.requestCount(), requests);
+    QCOMPARE(other.latencyOpcodes(), connected.latencyOpcodes());
+
+    QLowEnergyConnectionStatistics swapped;
+    swapped.swap(other);
+    QCOMPARE(swapped.requestCount(), requests);
+    QCOMPARE(swapped.mtuExchangeCount(), 1u);
+    QCOMPARE(other.requestCount(), 0u);
+    QCOMPARE(other.mtuExchangeCount(), 0u);
+
+    // A snapshot does not change with the connection
+    central->discoverServices();
+    QTRY_COMPARE(central->state(), QLowEnergyController::DiscoveredState);
+    QVERIFY(central->statistics().requestCount() > requests);
+    QCOMPARE(connected.requestCount(), requests);
+    QCOMPARE(swapped.requestCount(), requests);
+#endif
+}
+
+void tst_QLowEnergyConnectionStatistics::latencyBucketLimit_data()
+{
+    QTest::addColumn<int>("bucket");
+    QTest::addColumn<qint64>("limitMsecs");
+
+    constexpr int lastBucket = QLowEnergyConnectionStatistics::LatencyBucketCount - 1;
+    constexpr qint64 unlimited = std::chrono::milliseconds::max().count();
+    QTest::newRow("negative") << -1 << qint64(0);
+    QTest::newRow("minimum") << std::numeric_limits<int>::min() << qint64(0);
+    QTest::newRow("first") << 0 << qint64(1);
+    QTest::newRow("second") << 1 << qint64(2);
+    QTest::newRow("last limited") << lastBucket - 1 << (qint64(1) << (lastBucket - 1));
+    QTest::newRow("last") << lastBucket << unlimited;
+    QTest::newRow("count") << QLowEnergyConnectionStatistics::LatencyBucketCount << unlimited;
+    QTest::newRow("maximum") << std::numeric_limits<int>::max() << unlimited;
+}
+
+void tst_QLowEnergyConnectionStatistics::latencyBucketLimit()
+{
+    QFETCH(int, bucket);
+    QFETCH(qint64, limitMsecs);
+
+    QCOMPARE(QLowEnergyConnectionStatistics::latencyBucketLimit(bucket).count(), limitMsecs);
+}
+
+void tst_QLowEnergyConnectionStatistics::unknownOpcode()
+{
+    const QLowEnergyConnectionStatistics statistics;
+    QVERIFY(statistics.latencyHistogram(attReadRequest).isEmpty());
+    QVERIFY(statistics.latencyHistogram(0xff).isEmpty());
+
+#ifdef HAS_LE_SOCKET_PAIR
+    std::unique_ptr<QLowEnergyController> peripheral(QLowEnergyController::createPeripheral());
+    std::unique_ptr<QLowEnergyController> central(
+            connectLeSocketPairCentral(peripheral.get()));
+    QVERIFY(central);
+    QTRY_VERIFY(!central->statistics().latencyOpcodes().isEmpty());
+
+    const QLowEnergyConnectionStatistics connected = central->statistics();
+    for (const quint8 opcode : connected.latencyOpcodes()) {
+        QCOMPARE(connected.latencyHistogram(opcode).size(),
+                 QLowEnergyConnectionStatistics::LatencyBucketCount);
+    }
+    // Notifications are no requests
+    QVERIFY(connected.latencyHistogram(0x1b).isEmpty());
+    QVERIFY(connected.latencyHistogram(0xff).isEmpty());
+#endif
+}
+
+void tst_QLowEnergyConnectionStatistics::bluezCounters()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    const QBluetoothUuid serviceUuid(quint16(0x2000));
+    const QBluetoothUuid valueCharUuid(quint16(0x2001));
+    const QBluetoothUuid notifyCharUuid(quint16(0x2002));
+
+    QLowEnergyServiceData serviceData;
+    serviceData.setType(QLowEnergyServiceData::ServiceTypePrimary);
+    serviceData.setUuid(serviceUuid);
+    QLowEnergyCharacteristicData valueChar;
+    valueChar.setUuid(valueCharUuid);
+    valueChar.setProperties(QLowEnergyCharacteristic::Read | QLowEnergyCharacteristic::Write);
+    valueChar.setValue(QByteArray(20, 'v'));
+    serviceData.addCharacteristic(valueChar);
+    QLowEnergyCharacteristicData notifyChar;
+    notifyChar.setUuid(notifyCharUuid);
+    notifyChar.setProperties(QLowEnergyCharacteristic::Notify);
+    notifyChar.setValue(QByteArray(1, 'n'));
+    notifyChar.addDescriptor(QLowEnergyDescriptorData(
+            QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration,
+            QLowEnergyCharacteristic::CCCDDisable));
+    serviceData.addCharacteristic(notifyChar);
+
+    std::unique_ptr<QLowEnergyController> peripheral(QLowEnergyController::createPeripheral());
+    QLowEnergyService *localService = peripheral->addService(serviceData, peripheral.get());
+    QVERIFY(localService);
+    std::unique_ptr<QLowEnergyController> central(
+            connectLeSocketPairCentral(peripheral.get()));
+    QVERIFY(central);
+    std::unique_ptr<QLowEnergyService> remoteService(
+            discoverLeService(central.get(), serviceUuid));
+    QVERIFY(remoteService);
+
+    // Both sides count the MTU exchange
+    QCOMPARE(central->statistics().mtuExchangeCount(), 1u);
+    QCOMPARE(peripheral->statistics().mtuExchangeCount(), 1u);
+    QTRY_COMPARE(central->statistics().pendingRequestCount(), 0);
+    QVERIFY(central->statistics().maximumPendingRequestCount() > 0);
+
+    // Reads are timed per opcode
+    QLowEnergyConnectionStatistics before = central->statistics();
+    remoteService->readCharacteristic(remoteService->characteristic(valueCharUuid));
+    QVERIFY(waitForLeSignal(remoteService.get(), &QLowEnergyService::characteristicRead));
+    QLowEnergyConnectionStatistics after = central->statistics();
+    QCOMPARE(after.requestCount(), before.requestCount() + 1);
+    QCOMPARE(latencyCount(after, attReadRequest), latencyCount(before, attReadRequest) + 1);
+    QCOMPARE(after.requestTimeoutCount(), 0u);
+
+    // Writes are counted by the writer and the receiver
+    const QLowEnergyConnectionStatistics peripheralBefore = peripheral->statistics();
+    before = after;
+    remoteService->writeCharacteristic(remoteService->characteristic(valueCharUuid),
+                                       QByteArray(12, 'w'));
+    QVERIFY(waitForLeSignal(remoteService.get(), &QLowEnergyService::characteristicWritten));
+    after = central->statistics();
+    QCOMPARE(after.writeCount(), before.writeCount() + 1);
+    QCOMPARE(after.writtenBytes(), before.writtenBytes() + 12);
+    const QLowEnergyConnectionStatistics peripheralAfter = peripheral->statistics();
+    QCOMPARE(peripheralAfter.writeCount(), peripheralBefore.writeCount() + 1);
+    QCOMPARE(peripheralAfter.writtenBytes(), peripheralBefore.writtenBytes() + 12);
+
+    // Notifications are counted when sent and when received
+    const QLowEnergyCharacteristic remoteNotifyChar =
+            remoteService->characteristic(notifyCharUuid);
+    remoteService->writeDescriptor(remoteNotifyChar.clientCharacteristicConfiguration(),
+                                   QLowEnergyCharacteristic::CCCDEnableNotification);
+    QVERIFY(waitForLeSignal(remoteService.get(), &QLowEnergyService::descriptorWritten));
+    before = central->statistics();
+    QCOMPARE(peripheral->statistics().notificationCount(), 0u);
+    localService->writeCharacteristic(localService->characteristic(notifyCharUuid),
+                                      QByteArray(10, 'x'));
+    QVERIFY(waitForLeSignal(remoteService.get(), &QLowEnergyService::characteristicChanged));
+    QCOMPARE(peripheral->statistics().notificationCount(), 1u);
+    QCOMPARE(peripheral->statistics().notifiedBytes(), 10u);
+    after = central->statistics();
+    QCOMPARE(after.notificationCount(), before.notificationCount() + 1);
+    QCOMPARE(after.notifiedBytes(), before.notifiedBytes() + 10);
+
+    // The counters are kept after the disconnect
+    central->disconnectFromDevice();
+    QTRY_COMPARE(central->state(), QLowEnergyController::UnconnectedState);
+    QCOMPARE(central->statistics().notificationCount(), after.notificationCount());
+#else
+    QSKIP("This test requires a developer build using the BlueZ kernel ATT backend");
+#endif
+}
+
+QTEST_MAIN(tst_QLowEnergyConnectionStatistics)
+
+#include "tst_qlowenergyconnectionstatistics.moc"
@@ -0,0 +1,213 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtCore/QThread>
+
+#include <QtBluetooth/qlowenergycharacteristicdata.h>
+#include <QtBluetooth/qlowenergyconnectionstatistics.h>
+#include <QtBluetooth/qlowenergycontroller.h>
+#include <QtBluetooth/qlowenergydescriptordata.h>
+#include <QtBluetooth/qlowenergyservicedata.h>
+
+#include "../../shared/lesocketpair_p.h"
+
+#include <memory>
+
+QT_USE_NAMESPACE
+
+using namespace std::chrono_literals;
+
+static const QBluetoothUuid serviceUuid(quint16(0x2000));
+static const QBluetoothUuid charUuid(quint16(0x2001));
+
+// Spec v4.2, Vol 3, Part F, 3.4.5.1
+static constexpr quint8 attWriteRequest = 0x12;
+
+// Runs both controllers with the ATT I/O thread, which reads the sockets while
+// the main thread is busy
+class tst_QLowEnergyControllerAttIoThread : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void notificationOrder();
+    void requestWhileBlocked();
+    void destroyWithQueuedPackets();
+    void readFailure();
+
+private:
+    bool subscribe();
+
+    std::unique_ptr<QLowEnergyController> peripheral;
+    QLowEnergyService *localService = nullptr;
+    std::unique_ptr<QLowEnergyController> central;
+    std::unique_ptr<QLowEnergyService> remoteService;
+};
+
+void tst_QLowEnergyControllerAttIoThread::initTestCase()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    useLeSocketPairBackend();
+    // Read once by the first connection
+    qputenv("QT_BLUETOOTH_ATT_IO_THREAD", "1");
+#endif
+}
+
+void tst_QLowEnergyControllerAttIoThread::init()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    QLowEnergyServiceData serviceData;
+    serviceData.setType(QLowEnergyServiceData::ServiceTypePrimary);
+    serviceData.setUuid(serviceUuid);
+    QLowEnergyCharacteristicData charData;
+    charData.setUuid(charUuid);
+    charData.setProperties(QLowEnergyCharacteristic::Read | QLowEnergyCharacteristic::Write
+                           | QLowEnergyCharacteristic::Notify);
+    charData.setValue(QByteArray(1, 'v'));
+    charData.setValueLength(1, 20);
+    charData.addDescriptor(QLowEnergyDescriptorData(
+            QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration,
+            QLowEnergyCharacteristic::CCCDDisable));
+    serviceData.addCharacteristic(charData);
+
+    peripheral.reset(QLowEnergyController::createPeripheral());
+    localService = peripheral->addService(serviceData, peripheral.get());
+    QVERIFY(localService);
+    central.reset(connectLeSocketPairCentral(peripheral.get()));
+    QVERIFY(central);
+    remoteService.reset(discoverLeService(central.get(), serviceUuid));
+    QVERIFY(remoteService);
+#else
+    QSKIP("This test requires a developer build using the BlueZ kernel ATT backend");
+#endif
+}
+
+void tst_QLowEnergyControllerAttIoThread::cleanup()
+{
+    remoteService.reset();
+    central.reset();
+    localService = nullptr;
+    peripheral.reset();
+}
+
+bool tst_QLowEnergyControllerAttIoThread::subscribe()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    remoteService->writeDescriptor(
+            remoteService->characteristic(charUuid).clientCharacteristicConfiguration(),
+            QLowEnergyCharacteristic::CCCDEnableNotification);
+    return waitForLeSignal(remoteService.get(), &QLowEnergyService::descriptorWritten);
+#else
+    return false;
+#endif
+}
+
+void tst_QLowEnergyControllerAttIoThread::notificationOrder()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    QVERIFY(subscribe());
+
+    QList<QByteArray> received;
+    connect(remoteService.get(), &QLowEnergyService::characteristicChanged, this,
+            [&received](const QLowEnergyCharacteristic &, const QByteArray &value) {
+                received << value;
+            });
+
+    // All notifications are sent before the central gets to process any of them
+    constexpr int notificationCount = 100;
+    QList<QByteArray> expected;
+    const QLowEnergyCharacteristic localChar = localService->characteristic(charUuid);
+    for (int i = 0; i < notificationCount; ++i) {
+        expected << QByteArray::number(i);
+        localService->writeCharacteristic(localChar, expected.last());
+    }
+
+    QTRY_COMPARE(received.size(), notificationCount);
+    QCOMPARE(received, expected);
+    QCOMPARE(central->statistics().notificationCount(), quint64(notificationCount));
+#endif
+}
+
+void tst_QLowEnergyControllerAttIoThread::requestWhileBlocked()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    // The peripheral answers the write request before it reports the change,
+    // the I/O thread of the central reads the response while the main thread
+    // is blocked
+    constexpr auto blocked = 500ms;
+    connect(localService, &QLowEnergyService::characteristicChanged, this,
+            [blocked]() { QThread::sleep(blocked); });
+
+    const QByteArray value("blocked");
+    remoteService->writeCharacteristic(remoteService->characteristic(charUuid), value);
+    QVERIFY(waitForLeSignal(remoteService.get(), &QLowEnergyService::characteristicWritten));
+    QCOMPARE(localService->characteristic(charUuid).value(), value);
+
+    // The latency ends when the response is read, not when it is processed
+    const QList<quint64> histogram = central->statistics().latencyHistogram(attWriteRequest);
+    QCOMPARE(histogram.size(), QLowEnergyConnectionStatistics::LatencyBucketCount);
+    qsizetype bucket = -1;
+    for (qsizetype i = 0; i < histogram.size(); ++i) {
+        if (histogram.at(i) != 0) {
+            QCOMPARE(bucket, -1);
+            QCOMPARE(histogram.at(i), quint64(1));
+            bucket = i;
+        }
+    }
+    QVERIFY(bucket >= 0);
+    QVERIFY(QLowEnergyConnectionStatistics::latencyBucketLimit(int(bucket)) < blocked);
+
+    // Later requests are not affected
+    remoteService->readCharacteristic(remoteService->characteristic(charUuid));
+    QVERIFY(waitForLeSignal(remoteService.get(), &QLowEnergyService::characteristicRead));
+    QCOMPARE(remoteService->characteristic(charUuid).value(), value);
+#endif
+}
+
+void tst_QLowEnergyControllerAttIoThread::destroyWithQueuedPackets()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    QVERIFY(subscribe());
+
+    // The I/O thread of the central queues the notifications, which are never
+    // processed
+    const QLowEnergyCharacteristic localChar = localService->characteristic(charUuid);
+    for (int i = 0; i < 50; ++i)
+        localService->writeCharacteristic(localChar, QByteArray::number(i));
+    QThread::sleep(100ms);
+
+    remoteService.reset();
+    central.reset();
+
+    // The peripheral notices the closed connection and stays usable
+    QTRY_COMPARE(peripheral->state(), QLowEnergyController::UnconnectedState);
+    QTest::qWait(100ms);
+    QCOMPARE(peripheral->state(), QLowEnergyController::UnconnectedState);
+#endif
+}
+
+void tst_QLowEnergyControllerAttIoThread::readFailure()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    QSignalSpy errorOccurred(central.get(), &QLowEnergyController::errorOccurred);
+
+    // The I/O thread of the central fails to read from the closed socket
+    localService = nullptr;
+    peripheral.reset();
+
+    QTRY_COMPARE(central->state(), QLowEnergyController::UnconnectedState);
+    QVERIFY(!errorOccurred.isEmpty());
+    QVERIFY(central->error() != QLowEnergyController::NoError);
+    QCOMPARE(remoteService->state(), QLowEnergyService::InvalidService);
+#endif
+}
+
+QTEST_MAIN(tst_QLowEnergyControllerAttIoThread)
+
+#include "tst_qlowenergycontroller-attiothread.moc"
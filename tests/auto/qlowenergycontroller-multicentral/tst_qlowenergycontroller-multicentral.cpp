@@ -0,0 +1,354 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtBluetooth/qlowenergycharacteristicdata.h>
+#include <QtBluetooth/qlowenergycontroller.h>
+#include <QtBluetooth/qlowenergydescriptordata.h>
+#include <QtBluetooth/qlowenergyservicedata.h>
+
+#include "../../shared/lesocketpair_p.h"
+
+#include <memory>
+
+#ifdef Q_OS_UNIX
+#include <csignal>
+#endif
+
+QT_USE_NAMESPACE
+
+using namespace std::chrono_literals;
+
+static const QBluetoothUuid serviceUuid(quint16(0x2000));
+static const QBluetoothUuid notifyCharUuid(quint16(0x2001));
+
+class tst_QLowEnergyControllerMultiCentral : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void independentSubscriptions();
+    void localDescriptorOfPrimaryCentral();
+    void configuredClientConfiguration();
+    void primaryCentralUnchanged();
+    void disconnectOneCentral();
+    void notifyClosedCentral();
+
+private:
+    std::unique_ptr<QLowEnergyController> peripheral;
+    QLowEnergyService *localService = nullptr;
+};
+
+void tst_QLowEnergyControllerMultiCentral::initTestCase()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    useLeSocketPairBackend();
+#endif
+#ifdef Q_OS_UNIX
+    // Unlike L2CAP sockets, writing to a closed socket pair raises SIGPIPE
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+}
+
+void tst_QLowEnergyControllerMultiCentral::init()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    QLowEnergyServiceData serviceData;
+    serviceData.setType(QLowEnergyServiceData::ServiceTypePrimary);
+    serviceData.setUuid(serviceUuid);
+    QLowEnergyCharacteristicData notifyChar;
+    notifyChar.setUuid(notifyCharUuid);
+    notifyChar.setProperties(QLowEnergyCharacteristic::Read | QLowEnergyCharacteristic::Notify);
+    notifyChar.setValue(QByteArray(1, 'n'));
+    notifyChar.addDescriptor(QLowEnergyDescriptorData(
+            QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration,
+            QLowEnergyCharacteristic::CCCDDisable));
+    serviceData.addCharacteristic(notifyChar);
+
+    peripheral.reset(QLowEnergyController::createPeripheral());
+    localService = peripheral->addService(serviceData, peripheral.get());
+    QVERIFY(localService);
+#else
+    QSKIP("This test requires a developer build using the BlueZ kernel ATT backend");
+#endif
+}
+
+void tst_QLowEnergyControllerMultiCentral::cleanup()
+{
+    localService = nullptr;
+    peripheral.reset();
+}
+
+void tst_QLowEnergyControllerMultiCentral::independentSubscriptions()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    std::unique_ptr<QLowEnergyController> first(connectLeSocketPairCentral(peripheral.get(), 1));
+    QVERIFY(first);
+    std::unique_ptr<QLowEnergyController> second(connectLeSocketPairCentral(peripheral.get(), 2));
+    QVERIFY(second);
+    std::unique_ptr<QLowEnergyService> firstService(discoverLeService(first.get(), serviceUuid));
+    QVERIFY(firstService);
+    std::unique_ptr<QLowEnergyService> secondService(
+            discoverLeService(second.get(), serviceUuid));
+    QVERIFY(secondService);
+
+    // Only the first central subscribes
+    const QLowEnergyDescriptor firstCccd =
+            firstService->characteristic(notifyCharUuid).clientCharacteristicConfiguration();
+    firstService->writeDescriptor(firstCccd, QLowEnergyCharacteristic::CCCDEnableNotification);
+    QVERIFY(waitForLeSignal(firstService.get(), &QLowEnergyService::descriptorWritten));
+
+    QSignalSpy firstChanged(firstService.get(), &QLowEnergyService::characteristicChanged);
+    QSignalSpy secondChanged(secondService.get(), &QLowEnergyService::characteristicChanged);
+    localService->writeCharacteristic(localService->characteristic(notifyCharUuid),
+                                      QByteArray(4, 'x'));
+    QTRY_COMPARE(firstChanged.size(), 1);
+    QCOMPARE(firstChanged.at(0).at(1).toByteArray(), QByteArray(4, 'x'));
+
+    // Give a wrongly addressed notification the time to arrive
+    QTest::qWait(100ms);
+    QCOMPARE(secondChanged.size(), 0);
+
+    // Each central reads back its own configuration
+    const QLowEnergyDescriptor secondCccd =
+            secondService->characteristic(notifyCharUuid).clientCharacteristicConfiguration();
+    secondService->readDescriptor(secondCccd);
+    QVERIFY(waitForLeSignal(secondService.get(), &QLowEnergyService::descriptorRead));
+    QCOMPARE(secondService->characteristic(notifyCharUuid)
+                     .clientCharacteristicConfiguration().value(),
+             QLowEnergyCharacteristic::CCCDDisable);
+    firstService->readDescriptor(firstCccd);
+    QVERIFY(waitForLeSignal(firstService.get(), &QLowEnergyService::descriptorRead));
+    QCOMPARE(firstService->characteristic(notifyCharUuid)
+                     .clientCharacteristicConfiguration().value(),
+             QLowEnergyCharacteristic::CCCDEnableNotification);
+
+    // Subscribing the second central as well notifies both
+    secondService->writeDescriptor(secondCccd, QLowEnergyCharacteristic::CCCDEnableNotification);
+    QVERIFY(waitForLeSignal(secondService.get(), &QLowEnergyService::descriptorWritten));
+    localService->writeCharacteristic(localService->characteristic(notifyCharUuid),
+                                      QByteArray(4, 'y'));
+    QTRY_COMPARE(firstChanged.size(), 2);
+    QTRY_COMPARE(secondChanged.size(), 1);
+    QCOMPARE(secondChanged.at(0).at(1).toByteArray(), QByteArray(4, 'y'));
+#endif
+}
+
+void tst_QLowEnergyControllerMultiCentral::localDescriptorOfPrimaryCentral()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    std::unique_ptr<QLowEnergyController> first(connectLeSocketPairCentral(peripheral.get(), 1));
+    QVERIFY(first);
+    std::unique_ptr<QLowEnergyController> second(connectLeSocketPairCentral(peripheral.get(), 2));
+    QVERIFY(second);
+    std::unique_ptr<QLowEnergyService> firstService(discoverLeService(first.get(), serviceUuid));
+    QVERIFY(firstService);
+    std::unique_ptr<QLowEnergyService> secondService(
+            discoverLeService(second.get(), serviceUuid));
+    QVERIFY(secondService);
+
+    const auto localCccd = [this]() {
+        return localService->characteristic(notifyCharUuid).clientCharacteristicConfiguration();
+    };
+    const auto writeCccd = [](QLowEnergyService *service, const QByteArray &value) {
+        service->writeDescriptor(
+                service->characteristic(notifyCharUuid).clientCharacteristicConfiguration(),
+                value);
+        return waitForLeSignal(service, &QLowEnergyService::descriptorWritten);
+    };
+    QSignalSpy descriptorWritten(localService, &QLowEnergyService::descriptorWritten);
+
+    // The writes of both centrals are reported, the local value is the one
+    // of the first central
+    QVERIFY(writeCccd(secondService.get(), QLowEnergyCharacteristic::CCCDEnableNotification));
+    QCOMPARE(localCccd().value(), QLowEnergyCharacteristic::CCCDDisable);
+
+    QVERIFY(writeCccd(firstService.get(), QLowEnergyCharacteristic::CCCDEnableNotification));
+    QCOMPARE(localCccd().value(), QLowEnergyCharacteristic::CCCDEnableNotification);
+
+    QVERIFY(writeCccd(secondService.get(), QLowEnergyCharacteristic::CCCDDisable));
+    QCOMPARE(localCccd().value(), QLowEnergyCharacteristic::CCCDEnableNotification);
+    QCOMPARE(descriptorWritten.size(), 3);
+
+    // Traffic of either central does not change it
+    firstService->readCharacteristic(firstService->characteristic(notifyCharUuid));
+    QVERIFY(waitForLeSignal(firstService.get(), &QLowEnergyService::characteristicRead));
+    secondService->readCharacteristic(secondService->characteristic(notifyCharUuid));
+    QVERIFY(waitForLeSignal(secondService.get(), &QLowEnergyService::characteristicRead));
+    QCOMPARE(localCccd().value(), QLowEnergyCharacteristic::CCCDEnableNotification);
+
+    // The second central becomes the primary one when the first disconnects
+    first->disconnectFromDevice();
+    QTRY_COMPARE(localCccd().value(), QLowEnergyCharacteristic::CCCDDisable);
+#endif
+}
+
+void tst_QLowEnergyControllerMultiCentral::configuredClientConfiguration()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    // The service of init() configures CCCDDisable, which is also the default
+    QLowEnergyServiceData serviceData;
+    serviceData.setType(QLowEnergyServiceData::ServiceTypePrimary);
+    serviceData.setUuid(serviceUuid);
+    QLowEnergyCharacteristicData notifyChar;
+    notifyChar.setUuid(notifyCharUuid);
+    notifyChar.setProperties(QLowEnergyCharacteristic::Read | QLowEnergyCharacteristic::Notify);
+    notifyChar.setValue(QByteArray(1, 'n'));
+    notifyChar.addDescriptor(QLowEnergyDescriptorData(
+            QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration,
+            QLowEnergyCharacteristic::CCCDEnableNotification));
+    serviceData.addCharacteristic(notifyChar);
+    localService = nullptr;
+    peripheral.reset(QLowEnergyController::createPeripheral());
+    localService = peripheral->addService(serviceData, peripheral.get());
+    QVERIFY(localService);
+
+    std::unique_ptr<QLowEnergyController> first(connectLeSocketPairCentral(peripheral.get(), 1));
+    QVERIFY(first);
+    std::unique_ptr<QLowEnergyController> second(connectLeSocketPairCentral(peripheral.get(), 2));
+    QVERIFY(second);
+    std::unique_ptr<QLowEnergyService> secondService(
+            discoverLeService(second.get(), serviceUuid));
+    QVERIFY(secondService);
+
+    // Centrals which did not write the configuration read the configured one
+    const QLowEnergyDescriptor secondCccd =
+            secondService->characteristic(notifyCharUuid).clientCharacteristicConfiguration();
+    secondService->readDescriptor(secondCccd);
+    QVERIFY(waitForLeSignal(secondService.get(), &QLowEnergyService::descriptorRead));
+    QCOMPARE(secondService->characteristic(notifyCharUuid)
+                     .clientCharacteristicConfiguration().value(),
+             QLowEnergyCharacteristic::CCCDEnableNotification);
+    QCOMPARE(localService->characteristic(notifyCharUuid)
+                     .clientCharacteristicConfiguration().value(),
+             QLowEnergyCharacteristic::CCCDEnableNotification);
+
+    // and are notified accordingly
+    QSignalSpy secondChanged(secondService.get(), &QLowEnergyService::characteristicChanged);
+    localService->writeCharacteristic(localService->characteristic(notifyCharUuid),
+                                      QByteArray(2, 'e'));
+    QTRY_COMPARE(secondChanged.size(), 1);
+#endif
+}
+
+void tst_QLowEnergyControllerMultiCentral::primaryCentralUnchanged()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    std::unique_ptr<QLowEnergyController> first(connectLeSocketPairCentral(peripheral.get(), 1));
+    QVERIFY(first);
+    std::unique_ptr<QLowEnergyService> firstService(discoverLeService(first.get(), serviceUuid));
+    QVERIFY(firstService);
+
+    const QBluetoothAddress address = peripheral->remoteAddress();
+    const int mtu = peripheral->mtu();
+    QSignalSpy mtuChanged(peripheral.get(), &QLowEnergyController::mtuChanged);
+
+    // The second central exchanges its MTU and discovers the services
+    std::unique_ptr<QLowEnergyController> second(connectLeSocketPairCentral(peripheral.get(), 2));
+    QVERIFY(second);
+    std::unique_ptr<QLowEnergyService> secondService(
+            discoverLeService(second.get(), serviceUuid));
+    QVERIFY(secondService);
+    QCOMPARE(peripheral->remoteAddress(), address);
+    QCOMPARE(peripheral->mtu(), mtu);
+
+    // Requests of the first central do not switch the reported central
+    firstService->readCharacteristic(firstService->characteristic(notifyCharUuid));
+    QVERIFY(waitForLeSignal(firstService.get(), &QLowEnergyService::characteristicRead));
+    secondService->readCharacteristic(secondService->characteristic(notifyCharUuid));
+    QVERIFY(waitForLeSignal(secondService.get(), &QLowEnergyService::characteristicRead));
+    QCOMPARE(peripheral->remoteAddress(), address);
+    QCOMPARE(peripheral->mtu(), mtu);
+    QCOMPARE(mtuChanged.size(), 0);
+#endif
+}
+
+void tst_QLowEnergyControllerMultiCentral::disconnectOneCentral()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    std::unique_ptr<QLowEnergyController> first(connectLeSocketPairCentral(peripheral.get(), 1));
+    QVERIFY(first);
+    std::unique_ptr<QLowEnergyController> second(connectLeSocketPairCentral(peripheral.get(), 2));
+    QVERIFY(second);
+    std::unique_ptr<QLowEnergyService> secondService(
+            discoverLeService(second.get(), serviceUuid));
+    QVERIFY(secondService);
+    secondService->writeDescriptor(
+            secondService->characteristic(notifyCharUuid).clientCharacteristicConfiguration(),
+            QLowEnergyCharacteristic::CCCDEnableNotification);
+    QVERIFY(waitForLeSignal(secondService.get(), &QLowEnergyService::descriptorWritten));
+
+    QSignalSpy peripheralDisconnected(peripheral.get(), &QLowEnergyController::disconnected);
+    first->disconnectFromDevice();
+    QTRY_COMPARE(first->state(), QLowEnergyController::UnconnectedState);
+
+    // The peripheral keeps serving the other central
+    QTest::qWait(100ms);
+    QCOMPARE(peripheral->state(), QLowEnergyController::ConnectedState);
+    QCOMPARE(peripheralDisconnected.size(), 0);
+    QCOMPARE(second->state(), QLowEnergyController::DiscoveredState);
+
+    QSignalSpy secondChanged(secondService.get(), &QLowEnergyService::characteristicChanged);
+    localService->writeCharacteristic(localService->characteristic(notifyCharUuid),
+                                      QByteArray(3, 'z'));
+    QTRY_COMPARE(secondChanged.size(), 1);
+    secondService->readCharacteristic(secondService->characteristic(notifyCharUuid));
+    QVERIFY(waitForLeSignal(secondService.get(), &QLowEnergyService::characteristicRead));
+    QCOMPARE(secondService->characteristic(notifyCharUuid).value(), QByteArray(3, 'z'));
+
+    // The last central disconnects the peripheral
+    second->disconnectFromDevice();
+    QTRY_COMPARE(peripheral->state(), QLowEnergyController::UnconnectedState);
+    QCOMPARE(peripheralDisconnected.size(), 1);
+#endif
+}
+
+void tst_QLowEnergyControllerMultiCentral::notifyClosedCentral()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    std::unique_ptr<QLowEnergyController> first(connectLeSocketPairCentral(peripheral.get(), 1));
+    QVERIFY(first);
+    std::unique_ptr<QLowEnergyController> second(connectLeSocketPairCentral(peripheral.get(), 2));
+    QVERIFY(second);
+    std::unique_ptr<QLowEnergyService> firstService(discoverLeService(first.get(), serviceUuid));
+    QVERIFY(firstService);
+    std::unique_ptr<QLowEnergyService> secondService(
+            discoverLeService(second.get(), serviceUuid));
+    QVERIFY(secondService);
+    for (QLowEnergyService *service : { firstService.get(), secondService.get() }) {
+        service->writeDescriptor(
+                service->characteristic(notifyCharUuid).clientCharacteristicConfiguration(),
+                QLowEnergyCharacteristic::CCCDEnableNotification);
+        QVERIFY(waitForLeSignal(service, &QLowEnergyService::descriptorWritten));
+    }
+
+    // The peripheral notices the closed socket of the first central only
+    // when notifying it, which fails while the sessions are iterated
+    QSignalSpy peripheralDisconnected(peripheral.get(), &QLowEnergyController::disconnected);
+    firstService.reset();
+    first.reset();
+    QSignalSpy secondChanged(secondService.get(), &QLowEnergyService::characteristicChanged);
+    localService->writeCharacteristic(localService->characteristic(notifyCharUuid),
+                                      QByteArray(2, 'c'));
+
+    QTRY_COMPARE(secondChanged.size(), 1);
+    QCOMPARE(secondChanged.at(0).at(1).toByteArray(), QByteArray(2, 'c'));
+    QTest::qWait(100ms);
+    QCOMPARE(peripheral->state(), QLowEnergyController::ConnectedState);
+    QCOMPARE(peripheralDisconnected.size(), 0);
+
+    // The session of the first central was closed, the second one is still served
+    localService->writeCharacteristic(localService->characteristic(notifyCharUuid),
+                                      QByteArray(2, 'd'));
+    QTRY_COMPARE(secondChanged.size(), 2);
+#endif
+}
+
+QTEST_MAIN(tst_QLowEnergyControllerMultiCentral)
+
+#include "tst_qlowenergycontroller-multicentral.moc"
@@ -57,6 +57,7 @@ private slots:
     void tst_customProgrammableDevice();
     void tst_errorCases();
     void tst_rssiError();
+    void tst_linkProfile();
 private:
     void verifyServiceProperties(const QLowEnergyService *info);
     bool verifyClientCharacteristicValue(const QByteArray& value);
@@ -2816,6 +2817,50 @@ void tst_QLowEnergyController::tst_rssiError()
     QCOMPARE(central->error(), QLowEnergyController::Error::RssiReadError);
 }
 
+void tst_QLowEnergyController::tst_linkProfile()
+{
+    // Only the API behavior of unconnected controllers, applying the profiles
+    // requires a connection
+    QCOMPARE(QMetaEnum::fromType<QLowEnergyController::LinkProfile>().keyCount(), 4);
+
+    std::unique_ptr<QLowEnergyController> peripheral{QLowEnergyController::createPeripheral()};
+    QBluetoothDeviceInfo info(QBluetoothAddress{u"11:22:33:44:55:66"_s}, u"invalid"_s, 1);
+    std::unique_ptr<QLowEnergyController> central{QLowEnergyController::createCentral(info)};
+
+    for (QLowEnergyController *controller : { peripheral.get(), central.get() }) {
+        QCOMPARE(controller->linkProfile(), QLowEnergyController::DefaultLinkProfile);
+
+        QSignalSpy errorSpy(controller, &QLowEnergyController::errorOccurred);
+        QSignalSpy connectionUpdatedSpy(controller, &QLowEnergyController::connectionUpdated);
+        QSignalSpy dataLengthSpy(controller, &QLowEnergyController::dataLengthChanged);
+        QSignalSpy phySpy(controller, &QLowEnergyController::phyChanged);
+        const QLowEnergyController::Error errorBefore = controller->error();
+
+        for (const auto profile : { QLowEnergyController::LowLatencyLinkProfile,
+                                    QLowEnergyController::HighThroughputLinkProfile,
+                                    QLowEnergyController::PowerSavingLinkProfile,
+                                    QLowEnergyController::PowerSavingLinkProfile,
+                                    QLowEnergyController::DefaultLinkProfile }) {
+            controller->setLinkProfile(profile);
+            QCOMPARE(controller->linkProfile(), profile);
+        }
+
+        // Nothing is requested without a connection
+        QTest::qWait(100);
+        QVERIFY(errorSpy.isEmpty());
+        QCOMPARE(controller->error(), errorBefore);
+        QVERIFY(connectionUpdatedSpy.isEmpty());
+        QVERIFY(dataLengthSpy.isEmpty());
+        QVERIFY(phySpy.isEmpty());
+        QCOMPARE(controller->state(), QLowEnergyController::UnconnectedState);
+    }
+
+    // The profile is kept across connection attempts
+    central->setLinkProfile(QLowEnergyController::HighThroughputLinkProfile);
+    central->disconnectFromDevice();
+    QCOMPARE(central->linkProfile(), QLowEnergyController::HighThroughputLinkProfile);
+}
+
 QTEST_MAIN(tst_QLowEnergyController)
 
 #include "tst_qlowenergycontroller.moc"
@@ -3,14 +3,28 @@
 
 #include <QtTest/QtTest>
 
+#include <QtBluetooth/qlowenergycharacteristicdata.h>
+#include <QtBluetooth/qlowenergycontroller.h>
+#include <QtBluetooth/qlowenergydescriptordata.h>
 #include <QtBluetooth/qlowenergyservice.h>
+#include <QtBluetooth/qlowenergyservicedata.h>
 
+#include "../../shared/lesocketpair_p.h"
+
+#include <memory>
+
+using namespace std::chrono_literals;
+
+static const QBluetoothUuid serviceUuid(quint16(0x2000));
+static const QBluetoothUuid notifyCharUuid(quint16(0x2001));
 
 /*
  * This is a very simple test despite the complexity of QLowEnergyService.
  * It mostly aims to test the static API behaviors of the class. The connection
  * orientated elements are test by the test for QLowEnergyController as it
  * is impossible to test the two classes separately from each other.
+ * Only the batching of characteristic changes is tested here, using the
+ * socket pair transport where it is available.
  */
 
 class tst_QLowEnergyService : public QObject
@@ -18,9 +32,91 @@ class tst_QLowEnergyService : public QObject
     Q_OBJECT
 
 private slots:
+    void initTestCase();
+    void cleanup();
+
     void tst_flags();
+    void changeBatchingDefaults();
+    void changeBatchingOffsets();
+    void changeBatchingFlushOnDisable();
+    void changeBatchingInterval();
+
+private:
+    bool connectNotifyingService();
+    bool notifyValue(const QByteArray &value);
+
+    std::unique_ptr<QLowEnergyController> peripheral;
+    std::unique_ptr<QLowEnergyController> central;
+    std::unique_ptr<QLowEnergyService> remoteService;
+    QLowEnergyService *localService = nullptr;
 };
 
+void tst_QLowEnergyService::initTestCase()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    useLeSocketPairBackend();
+#endif
+}
+
+void tst_QLowEnergyService::cleanup()
+{
+    remoteService.reset();
+    central.reset();
+    localService = nullptr;
+    peripheral.reset();
+}
+
+static QLowEnergyServiceData notifyingServiceData()
+{
+    QLowEnergyServiceData serviceData;
+    serviceData.setType(QLowEnergyServiceData::ServiceTypePrimary);
+    serviceData.setUuid(serviceUuid);
+    QLowEnergyCharacteristicData notifyChar;
+    notifyChar.setUuid(notifyCharUuid);
+    notifyChar.setProperties(QLowEnergyCharacteristic::Notify);
+    notifyChar.setValue(QByteArray(1, 'n'));
+    notifyChar.addDescriptor(QLowEnergyDescriptorData(
+            QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration,
+            QLowEnergyCharacteristic::CCCDDisable));
+    serviceData.addCharacteristic(notifyChar);
+    return serviceData;
+}
+
+// Connects a central to a peripheral providing the notifying service and
+// subscribes to its characteristic
+bool tst_QLowEnergyService::connectNotifyingService()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    peripheral.reset(QLowEnergyController::createPeripheral());
+    localService = peripheral->addService(notifyingServiceData(), peripheral.get());
+    if (!localService)
+        return false;
+    central.reset(connectLeSocketPairCentral(peripheral.get()));
+    if (!central)
+        return false;
+    remoteService.reset(discoverLeService(central.get(), serviceUuid));
+    if (!remoteService)
+        return false;
+
+    const QLowEnergyCharacteristic characteristic = remoteService->characteristic(notifyCharUuid);
+    remoteService->writeDescriptor(characteristic.clientCharacteristicConfiguration(),
+                                   QLowEnergyCharacteristic::CCCDEnableNotification);
+    return waitForLeSignal(remoteService.get(), &QLowEnergyService::descriptorWritten);
+#else
+    return false;
+#endif
+}
+
+// Notifies value and waits until the central has received it
+bool tst_QLowEnergyService::notifyValue(const QByteArray &value)
+{
+    const quint64 received = central->statistics().notificationCount();
+    localService->writeCharacteristic(localService->characteristic(notifyCharUuid), value);
+    return QTest::qWaitFor([&]() {
+        return central->statistics().notificationCount() > received;
+    });
+}
+
 void tst_QLowEnergyService::tst_flags()
 {
     QLowEnergyService::ServiceTypes flag1(QLowEnergyService::PrimaryService);
@@ -43,6 +139,161 @@ void tst_QLowEnergyService::tst_flags()
     QVERIFY(result.testFlag(QLowEnergyService::IncludedService));
 }
 
+void tst_QLowEnergyService::changeBatchingDefaults()
+{
+    std::unique_ptr<QLowEnergyController> controller(QLowEnergyController::createPeripheral());
+    QLowEnergyService *service = controller->addService(notifyingServiceData(), controller.get());
+    if (!service)
+        QSKIP("This test requires a platform supporting the peripheral role");
+
+    QVERIFY(!service->isCharacteristicChangeBatchingEnabled());
+    QCOMPARE(service->characteristicChangeBatchInterval(), 0ms);
+
+    service->setCharacteristicChangeBatchInterval(250ms);
+    QCOMPARE(service->characteristicChangeBatchInterval(), 250ms);
+    QVERIFY(!service->isCharacteristicChangeBatchingEnabled());
+
+    service->setCharacteristicChangeBatchingEnabled(true);
+    QVERIFY(service->isCharacteristicChangeBatchingEnabled());
+    service->setCharacteristicChangeBatchingEnabled(false);
+    QVERIFY(!service->isCharacteristicChangeBatchingEnabled());
+    QCOMPARE(service->characteristicChangeBatchInterval(), 250ms);
+}
+
+void tst_QLowEnergyService::changeBatchingOffsets()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    QVERIFY(connectNotifyingService());
+
+    QSignalSpy changed(remoteService.get(), &QLowEnergyService::characteristicChanged);
+    QList<QList<QLowEnergyService::CharacteristicChange>> batches;
+    QList<QByteArray> batchValues;
+    connect(remoteService.get(), &QLowEnergyService::characteristicsChanged, this,
+            [&](const QList<QLowEnergyService::CharacteristicChange> &changes,
+                const QByteArray &values) {
+                batches.append(changes);
+                batchValues.append(values);
+            });
+
+    // The interval keeps the batch open until all values have been received
+    remoteService->setCharacteristicChangeBatchInterval(1s);
+    remoteService->setCharacteristicChangeBatchingEnabled(true);
+    QVERIFY(notifyValue("a"));
+    QVERIFY(notifyValue("bcd"));
+    QVERIFY(notifyValue("ef"));
+    QVERIFY(batches.isEmpty());
+
+    QTRY_COMPARE(batches.size(), 1);
+    QCOMPARE(changed.size(), 0);
+    QCOMPARE(batchValues.at(0), QByteArray("abcdef"));
+    const QList<QLowEnergyService::CharacteristicChange> &changes = batches.at(0);
+    QCOMPARE(changes.size(), 3);
+    const qsizetype offsets[] = { 0, 1, 4 };
+    const qsizetype lengths[] = { 1, 3, 2 };
+    for (qsizetype i = 0; i < changes.size(); ++i) {
+        QCOMPARE(changes.at(i).characteristic.uuid(), notifyCharUuid);
+        QCOMPARE(changes.at(i).offset, offsets[i]);
+        QCOMPARE(changes.at(i).length, lengths[i]);
+        if (i > 0)
+            QVERIFY(changes.at(i).timestamp >= changes.at(i - 1).timestamp);
+    }
+
+    // The batches of a service do not share their buffers
+    QVERIFY(notifyValue("gh"));
+    QTRY_COMPARE(batches.size(), 2);
+    QCOMPARE(batchValues.at(1), QByteArray("gh"));
+    QCOMPARE(batches.at(1).size(), 1);
+    QCOMPARE(batches.at(1).at(0).offset, qsizetype(0));
+    QCOMPARE(batches.at(1).at(0).length, qsizetype(2));
+    QCOMPARE(changed.size(), 0);
+#else
+    QSKIP("This test requires a developer build using the BlueZ kernel ATT backend");
+#endif
+}
+
+void tst_QLowEnergyService::changeBatchingFlushOnDisable()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    QVERIFY(connectNotifyingService());
+
+    QSignalSpy changed(remoteService.get(), &QLowEnergyService::characteristicChanged);
+    QList<QLowEnergyService::CharacteristicChange> batch;
+    QByteArray batchValues;
+    int batchCount = 0;
+    connect(remoteService.get(), &QLowEnergyService::characteristicsChanged, this,
+            [&](const QList<QLowEnergyService::CharacteristicChange> &changes,
+                const QByteArray &values) {
+                batch = changes;
+                batchValues = values;
+                ++batchCount;
+            });
+
+    // The interval never passes during the test
+    remoteService->setCharacteristicChangeBatchInterval(1h);
+    remoteService->setCharacteristicChangeBatchingEnabled(true);
+    QVERIFY(notifyValue("12"));
+    QVERIFY(notifyValue("345"));
+    QCOMPARE(batchCount, 0);
+
+    // Disabling delivers the pending changes right away
+    remoteService->setCharacteristicChangeBatchingEnabled(false);
+    QCOMPARE(batchCount, 1);
+    QCOMPARE(batchValues, QByteArray("12345"));
+    QCOMPARE(batch.size(), 2);
+    QCOMPARE(batch.at(1).offset, qsizetype(2));
+    QCOMPARE(batch.at(1).length, qsizetype(3));
+    QCOMPARE(changed.size(), 0);
+
+    // Afterwards every change is reported on its own again
+    QVERIFY(notifyValue("6"));
+    QTRY_COMPARE(changed.size(), 1);
+    QCOMPARE(changed.at(0).at(1).toByteArray(), QByteArray("6"));
+    QCOMPARE(batchCount, 1);
+
+    // Disabling without pending changes emits nothing
+    remoteService->setCharacteristicChangeBatchingEnabled(true);
+    remoteService->setCharacteristicChangeBatchingEnabled(false);
+    QCOMPARE(batchCount, 1);
+#else
+    QSKIP("This test requires a developer build using the BlueZ kernel ATT backend");
+#endif
+}
+
+void tst_QLowEnergyService::changeBatchingInterval()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    QVERIFY(connectNotifyingService());
+
+    constexpr std::chrono::milliseconds interval = 300ms;
+    std::chrono::steady_clock::duration delay{};
+    int batchCount = 0;
+    connect(remoteService.get(), &QLowEnergyService::characteristicsChanged, this,
+            [&](const QList<QLowEnergyService::CharacteristicChange> &changes,
+                const QByteArray &) {
+                delay = std::chrono::steady_clock::now() - changes.constFirst().timestamp;
+                ++batchCount;
+            });
+
+    remoteService->setCharacteristicChangeBatchInterval(interval);
+    remoteService->setCharacteristicChangeBatchingEnabled(true);
+    QVERIFY(notifyValue("x"));
+    QCOMPARE(batchCount, 0);
+
+    // The batch is delivered once the interval has passed since its first change,
+    // coarse timers may time out slightly early
+    QTRY_COMPARE(batchCount, 1);
+    QVERIFY(delay >= interval * 9 / 10);
+
+    // The default interval delivers the changes on return to the event loop
+    remoteService->setCharacteristicChangeBatchInterval(0ms);
+    QVERIFY(notifyValue("y"));
+    QTRY_COMPARE(batchCount, 2);
+    QVERIFY(delay < interval);
+#else
+    QSKIP("This test requires a developer build using the BlueZ kernel ATT backend");
+#endif
+}
+
 QTEST_MAIN(tst_QLowEnergyService)
 
 #include "tst_qlowenergyservice.moc"
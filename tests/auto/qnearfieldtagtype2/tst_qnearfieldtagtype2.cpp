@@ -14,6 +14,26 @@ Q_DECLARE_METATYPE(QNearFieldTarget*)
 
 static const char * const deadbeef = "\xde\xad\xbe\xef";
 
+using namespace std::chrono_literals;
+
+// Gives the tests access to the responses stored for the requests
+class ResponseTagType2 : public TagType2
+{
+public:
+    using TagType2::TagType2;
+
+    qsizetype storedResponseCount() const
+    {
+        QMutexLocker locker(&m_responseStore->mutex);
+        return m_responseStore->responses.size();
+    }
+
+    void storeResponse(const QNearFieldTarget::RequestId &id, const QVariant &response)
+    {
+        QNearFieldTargetPrivate::setResponseForRequest(id, response, false);
+    }
+};
+
 class tst_QNearFieldTagType2 : public QObject
 {
     Q_OBJECT
@@ -30,11 +50,15 @@ private slots:
 
     void ndefMessages();
 
+    void responseDroppedWithRequest();
+    void waitReturnsOnResponseStored();
+    void waitReturnsOnTargetDestroyed();
+
 private:
     void waitForMatchingTarget();
 
     QObject *targetParent;
-    QNearFieldTagType2 *target;
+    ResponseTagType2 *target;
 };
 
 tst_QNearFieldTagType2::tst_QNearFieldTagType2()
@@ -71,7 +95,7 @@ void tst_QNearFieldTagType2::waitForMatchingTarget()
 
     QTRY_VERIFY(!targetDetectedSpy.isEmpty());
 
-    target = new TagType2(targetDetectedSpy.first().at(0).value<TagBase *>(), targetParent);
+    target = new ResponseTagType2(targetDetectedSpy.first().at(0).value<TagBase *>(), targetParent);
 
     QVERIFY(target);
 
@@ -319,6 +343,72 @@ void tst_QNearFieldTagType2::ndefMessages()
     }
 }
 
+void tst_QNearFieldTagType2::responseDroppedWithRequest()
+{
+    waitForMatchingTarget();
+    if (QTest::currentTestFailed())
+        return;
+
+    const qsizetype responseCount = target->storedResponseCount();
+
+    QNearFieldTarget::RequestId id = target->readBlock(0);
+    QVERIFY(target->waitForRequestCompleted(id));
+    QCOMPARE(target->storedResponseCount(), responseCount + 1);
+    const QByteArray block = target->requestResponse(id).toByteArray();
+    QVERIFY(!block.isEmpty());
+
+    // The response is kept while a copy of the request id exists
+    QNearFieldTarget::RequestId copy = id;
+    id = QNearFieldTarget::RequestId();
+    QCOMPARE(target->storedResponseCount(), responseCount + 1);
+    QCOMPARE(target->requestResponse(copy).toByteArray(), block);
+
+    // and dropped together with the last one
+    copy = QNearFieldTarget::RequestId();
+    QCOMPARE(target->storedResponseCount(), responseCount);
+}
+
+void tst_QNearFieldTagType2::waitReturnsOnResponseStored()
+{
+    waitForMatchingTarget();
+    if (QTest::currentTestFailed())
+        return;
+
+    // The response is stored without emitting requestCompleted()
+    const QNearFieldTarget::RequestId id(new QNearFieldTarget::RequestIdPrivate);
+    QSignalSpy requestCompletedSpy(target, &QNearFieldTagType2::requestCompleted);
+    QTimer::singleShot(50ms, target, [this, id] {
+        target->storeResponse(id, QByteArray(deadbeef));
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(target->waitForRequestCompleted(id, 10000));
+    QVERIFY(timer.elapsed() < 5000);
+    QCOMPARE(target->requestResponse(id).toByteArray(), QByteArray(deadbeef));
+    QVERIFY(requestCompletedSpy.isEmpty());
+}
+
+void tst_QNearFieldTagType2::waitReturnsOnTargetDestroyed()
+{
+    waitForMatchingTarget();
+    if (QTest::currentTestFailed())
+        return;
+
+    // A request which never completes
+    const QNearFieldTarget::RequestId id(new QNearFieldTarget::RequestIdPrivate);
+    QTimer::singleShot(50ms, targetParent, [this] {
+        delete target;
+        target = nullptr;
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!target->waitForRequestCompleted(id, 10000));
+    QVERIFY(timer.elapsed() < 5000);
+    QVERIFY(!target);
+}
+
 QTEST_MAIN(tst_QNearFieldTagType2)
 
 // Unset the moc namespace which is not required for the following include.
@@ -0,0 +1,118 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtNfc/private/qnearfieldtarget_p.h>
+#if QT_CONFIG(pcsclite)
+#include <QtNfc/private/qapduutils_p.h>
+#endif
+
+QT_USE_NAMESPACE
+
+// A backend target which only implements single commands
+class CommandTarget : public QNearFieldTargetPrivate
+{
+public:
+    using QNearFieldTargetPrivate::QNearFieldTargetPrivate;
+
+    QNearFieldTarget::AccessMethods accessMethods() const override
+    {
+        return QNearFieldTarget::TagTypeSpecificAccess;
+    }
+
+    QNearFieldTarget::RequestId sendCommand(const QByteArray &command) override
+    {
+        Q_UNUSED(command);
+
+        const QNearFieldTarget::RequestId id(new QNearFieldTarget::RequestIdPrivate);
+        setResponseForRequest(id, QByteArray("\x90\x00", 2));
+        return id;
+    }
+};
+
+class tst_QNearFieldTarget : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sendCommandsUnsupported_data();
+    void sendCommandsUnsupported();
+    void errorStatus_data();
+    void errorStatus();
+};
+
+void tst_QNearFieldTarget::sendCommandsUnsupported_data()
+{
+    QTest::addColumn<bool>("stopOnErrorStatus");
+
+    QTest::newRow("no option") << false;
+    QTest::newRow("stop on error status") << true;
+}
+
+void tst_QNearFieldTarget::sendCommandsUnsupported()
+{
+    QFETCH(bool, stopOnErrorStatus);
+
+    const QNearFieldTarget::CommandBatchOptions options = stopOnErrorStatus
+            ? QNearFieldTarget::StopOnErrorStatus
+            : QNearFieldTarget::NoCommandBatchOption;
+
+    CommandTarget target;
+    QSignalSpy errorSpy(&target, &QNearFieldTargetPrivate::error);
+    QSignalSpy requestCompletedSpy(&target, &QNearFieldTargetPrivate::requestCompleted);
+
+    // Single commands work, sequences are reported as unsupported
+    const QNearFieldTarget::RequestId commandId = target.sendCommand(QByteArray(1, 0x00));
+    QVERIFY(commandId.isValid());
+    QCOMPARE(requestCompletedSpy.size(), 1);
+
+    const QList<QByteArray> commands = { QByteArray(1, 0x00), QByteArray(1, 0x01) };
+    const QNearFieldTarget::RequestId id = target.sendCommands(commands, options);
+    QVERIFY(!id.isValid());
+    QCOMPARE(errorSpy.size(), 1);
+    QCOMPARE(errorSpy.at(0).at(0).value<QNearFieldTarget::Error>(),
+             QNearFieldTarget::UnsupportedError);
+    QCOMPARE(errorSpy.at(0).at(1).value<QNearFieldTarget::RequestId>(), id);
+    QCOMPARE(requestCompletedSpy.size(), 1);
+    QVERIFY(!target.requestResponse(id).isValid());
+}
+
+void tst_QNearFieldTarget::errorStatus_data()
+{
+    QTest::addColumn<quint16>("status");
+    QTest::addColumn<bool>("error");
+
+    QTest::newRow("empty") << quint16(0x0000) << false;
+    QTest::newRow("success") << quint16(0x9000) << false;
+    QTest::newRow("response bytes available") << quint16(0x6110) << false;
+    QTest::newRow("warning, memory unchanged") << quint16(0x6281) << false;
+    QTest::newRow("warning, memory changed") << quint16(0x63C1) << false;
+    QTest::newRow("execution error, memory unchanged") << quint16(0x6400) << true;
+    QTest::newRow("execution error, memory changed") << quint16(0x6581) << true;
+    QTest::newRow("wrong length") << quint16(0x6700) << true;
+    QTest::newRow("security status not satisfied") << quint16(0x6982) << true;
+    QTest::newRow("file not found") << quint16(0x6A82) << true;
+    QTest::newRow("wrong le") << quint16(0x6C10) << true;
+    QTest::newRow("instruction not supported") << quint16(0x6D00) << true;
+    QTest::newRow("class not supported") << quint16(0x6E00) << true;
+    QTest::newRow("no precise diagnosis") << quint16(0x6F00) << true;
+    QTest::newRow("proprietary") << quint16(0x9100) << false;
+}
+
+// Only the status word classification is inline, QResponseApdu itself is not exported
+void tst_QNearFieldTarget::errorStatus()
+{
+#if QT_CONFIG(pcsclite)
+    QFETCH(quint16, status);
+    QFETCH(bool, error);
+
+    QCOMPARE(QResponseApdu::isErrorStatus(status), error);
+#else
+    QSKIP("The APDU utilities are only built with the PC/SC backend");
+#endif
+}
+
+QTEST_MAIN(tst_QNearFieldTarget)
+
+#include "tst_qnearfieldtarget.moc"
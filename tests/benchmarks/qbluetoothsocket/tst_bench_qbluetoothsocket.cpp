@@ -0,0 +1,167 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtCore/QEventLoop>
+#include <QtCore/QSocketNotifier>
+#include <QtCore/QTimer>
+
+#include <qbluetoothsocket.h>
+
+#if QT_CONFIG(bluez)
+#include <QtBluetooth/private/qbluetoothsocketbase_p.h>
+
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+QT_USE_NAMESPACE
+
+using namespace std::chrono_literals;
+
+#if QT_CONFIG(bluez)
+// The benchmarks measure the raw BlueZ backend, which drives the sockets accepted
+// by QBluetoothServer. Only L2capLeProtocol sockets are guaranteed to use it, the
+// stream descriptor handed to them as RFCOMM makes them behave like accepted ones.
+class RawBluetoothSocket : public QBluetoothSocket
+{
+public:
+    RawBluetoothSocket() : QBluetoothSocket(QBluetoothServiceInfo::L2capLeProtocol) { }
+
+    bool usesRawBackend() const { return d_ptr->inherits("QBluetoothSocketPrivateBluez"); }
+};
+#endif
+
+class tst_QBluetoothSocketBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void streamThroughput_data();
+    void streamThroughput();
+    void streamReceive_data();
+    void streamReceive();
+};
+
+void tst_QBluetoothSocketBench::streamThroughput_data()
+{
+    QTest::addColumn<int>("writeSize");
+
+    QTest::newRow("64 bytes") << 64;
+    QTest::newRow("512 bytes") << 512;
+    QTest::newRow("4 KiB") << 4096;
+    QTest::newRow("64 KiB") << 65536;
+}
+
+void tst_QBluetoothSocketBench::streamThroughput()
+{
+#if QT_CONFIG(bluez)
+    QFETCH(int, writeSize);
+
+    // about 30 seconds worth of a 1 Mbit/s serial bridge
+    constexpr qint64 totalSize = 4 * 1024 * 1024;
+    const QByteArray block(writeSize, 'q');
+    QByteArray sink(256 * 1024, Qt::Uninitialized);
+
+    QBENCHMARK {
+        int fds[2];
+        QCOMPARE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+        RawBluetoothSocket socket;
+        QVERIFY(socket.usesRawBackend());
+        QVERIFY(socket.setSocketDescriptor(fds[0], QBluetoothServiceInfo::RfcommProtocol));
+
+        QEventLoop loop;
+        QTimer timer;
+        timer.setSingleShot(true);
+        connect(&timer, &QTimer::timeout, &loop, [&loop]() { loop.exit(1); });
+        qint64 received = 0;
+        QSocketNotifier notifier(fds[1], QSocketNotifier::Read);
+        connect(&notifier, &QSocketNotifier::activated, &loop, [&]() {
+            const auto count = ::read(fds[1], sink.data(), sink.size());
+            if (count > 0)
+                received += count;
+            if (count <= 0 || received == totalSize)
+                loop.quit();
+        });
+
+        for (qint64 written = 0; written < totalSize; written += writeSize)
+            socket.write(block);
+        timer.start(5s);
+        QVERIFY(loop.exec() == 0);
+
+        QCOMPARE(received, totalSize);
+        QCOMPARE(socket.bytesToWrite(), 0);
+        ::close(fds[1]);
+    }
+#else
+    QSKIP("This benchmark requires the BlueZ socket backend");
+#endif
+}
+
+void tst_QBluetoothSocketBench::streamReceive_data()
+{
+    QTest::addColumn<int>("frameSize");
+
+    QTest::newRow("20 byte frames") << 20;
+    QTest::newRow("700 byte frames") << 700;
+    QTest::newRow("4000 byte frames") << 4000;
+}
+
+void tst_QBluetoothSocketBench::streamReceive()
+{
+#if QT_CONFIG(bluez)
+    QFETCH(int, frameSize);
+
+    constexpr qint64 totalSize = 4 * 1024 * 1024;
+    const QByteArray block(64 * 1024, 'q');
+    QByteArray frame(frameSize, Qt::Uninitialized);
+
+    QBENCHMARK {
+        int fds[2];
+        QCOMPARE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds), 0);
+
+        RawBluetoothSocket socket;
+        QVERIFY(socket.usesRawBackend());
+        QVERIFY(socket.setSocketDescriptor(fds[0], QBluetoothServiceInfo::RfcommProtocol));
+
+        QEventLoop loop;
+        QTimer timer;
+        timer.setSingleShot(true);
+        connect(&timer, &QTimer::timeout, &loop, [&loop]() { loop.exit(1); });
+        qint64 sent = 0;
+        qint64 received = 0;
+        QSocketNotifier notifier(fds[1], QSocketNotifier::Write);
+        connect(&notifier, &QSocketNotifier::activated, &loop, [&]() {
+            const auto count = ::write(fds[1], block.constData(),
+                                       qMin<qint64>(block.size(), totalSize - sent));
+            if (count > 0)
+                sent += count;
+            if (sent == totalSize)
+                notifier.setEnabled(false);
+        });
+        // Consume complete frames only, like a protocol parser waiting for the rest
+        // of a frame. The remainder stays buffered while more data is appended.
+        connect(&socket, &QBluetoothSocket::readyRead, &loop, [&]() {
+            while (socket.bytesAvailable() >= frameSize)
+                received += socket.read(frame.data(), frameSize);
+            if (received + socket.bytesAvailable() == totalSize) {
+                received += socket.readAll().size();
+                loop.quit();
+            }
+        });
+        timer.start(5s);
+        QVERIFY(loop.exec() == 0);
+
+        QCOMPARE(received, totalSize);
+        ::close(fds[1]);
+    }
+#else
+    QSKIP("This benchmark requires the BlueZ socket backend");
+#endif
+}
+
+QTEST_MAIN(tst_QBluetoothSocketBench)
+
+#include "tst_bench_qbluetoothsocket.moc"
@@ -0,0 +1,265 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtCore/QEventLoop>
+#include <QtCore/QTimer>
+
+#include <QtBluetooth/qlowenergycharacteristicdata.h>
+#include <QtBluetooth/qlowenergycontroller.h>
+#include <QtBluetooth/qlowenergydescriptordata.h>
+#include <QtBluetooth/qlowenergyservice.h>
+#include <QtBluetooth/qlowenergyservicedata.h>
+
+#include "../../shared/lesocketpair_p.h"
+
+#include <memory>
+
+using namespace std::chrono_literals;
+
+QT_USE_NAMESPACE
+
+#ifdef HAS_LE_SOCKET_PAIR
+namespace {
+
+const QBluetoothUuid serviceUuid(quint16(0x2000));
+const QBluetoothUuid shortCharUuid(quint16(0x2001));
+const QBluetoothUuid longCharUuid(quint16(0x2002));
+const QBluetoothUuid notifyCharUuid(quint16(0x2003));
+constexpr quint16 firstExtraCharUuid = 0x2100;
+
+QLowEnergyServiceData serviceData(int extraCharacteristics)
+{
+    QLowEnergyServiceData service;
+    service.setType(QLowEnergyServiceData::ServiceTypePrimary);
+    service.setUuid(serviceUuid);
+
+    QLowEnergyCharacteristicData shortChar;
+    shortChar.setUuid(shortCharUuid);
+    shortChar.setProperties(QLowEnergyCharacteristic::Read | QLowEnergyCharacteristic::Write);
+    shortChar.setValue(QByteArray(20, 's'));
+    service.addCharacteristic(shortChar);
+
+    QLowEnergyCharacteristicData longChar;
+    longChar.setUuid(longCharUuid);
+    longChar.setProperties(QLowEnergyCharacteristic::Read | QLowEnergyCharacteristic::Write);
+    longChar.setValue(QByteArray(512, 'l'));
+    longChar.setValueLength(0, 512);
+    service.addCharacteristic(longChar);
+
+    QLowEnergyCharacteristicData notifyChar;
+    notifyChar.setUuid(notifyCharUuid);
+    notifyChar.setProperties(QLowEnergyCharacteristic::Notify);
+    notifyChar.setValue(QByteArray(1, 'n'));
+    notifyChar.addDescriptor(QLowEnergyDescriptorData(
+            QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration,
+            QLowEnergyCharacteristic::CCCDDisable));
+    service.addCharacteristic(notifyChar);
+
+    for (int i = 0; i < extraCharacteristics; ++i) {
+        QLowEnergyCharacteristicData extraChar;
+        extraChar.setUuid(QBluetoothUuid(quint16(firstExtraCharUuid + i)));
+        extraChar.setProperties(QLowEnergyCharacteristic::Read);
+        extraChar.setValue(QByteArray::number(i));
+        extraChar.addDescriptor(QLowEnergyDescriptorData(
+                QBluetoothUuid::DescriptorType::CharacteristicUserDescription,
+                QByteArray("extra characteristic")));
+        service.addCharacteristic(extraChar);
+    }
+
+    return service;
+}
+
+// A peripheral and a central connected by a socket pair
+struct Link
+{
+    std::unique_ptr<QLowEnergyController> peripheral;
+    std::unique_ptr<QLowEnergyController> central;
+    QLowEnergyService *localService = nullptr;
+    std::unique_ptr<QLowEnergyService> remoteService;
+
+    bool connect(int extraCharacteristics)
+    {
+        peripheral.reset(QLowEnergyController::createPeripheral());
+        localService = peripheral->addService(serviceData(extraCharacteristics),
+                                              peripheral.get());
+        if (!localService)
+            return false;
+        central.reset(connectLeSocketPairCentral(peripheral.get()));
+        return central != nullptr;
+    }
+
+    bool discover()
+    {
+        remoteService.reset(discoverLeService(central.get(), serviceUuid));
+        return remoteService != nullptr;
+    }
+};
+
+} // namespace
+#endif // HAS_LE_SOCKET_PAIR
+
+class tst_QLowEnergyControllerBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void discovery_data();
+    void discovery();
+    void notificationThroughput_data();
+    void notificationThroughput();
+    void readLatency();
+    void writeLatency();
+    void longWrite();
+
+#ifdef HAS_LE_SOCKET_PAIR
+private:
+    Link link;
+#endif
+};
+
+void tst_QLowEnergyControllerBench::initTestCase()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    useLeSocketPairBackend();
+
+    // Most benchmarks share one connection, a disconnect would drop the
+    // services of the peripheral
+    QVERIFY(link.connect(8));
+    QVERIFY(link.discover());
+#else
+    QSKIP("This benchmark requires a developer build using the BlueZ kernel ATT backend");
+#endif
+}
+
+void tst_QLowEnergyControllerBench::discovery_data()
+{
+    QTest::addColumn<int>("extraCharacteristics");
+
+    QTest::newRow("3 characteristics") << 0;
+    QTest::newRow("19 characteristics") << 16;
+    QTest::newRow("67 characteristics") << 64;
+}
+
+void tst_QLowEnergyControllerBench::discovery()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    QFETCH(int, extraCharacteristics);
+
+    // A connection can be discovered once, this includes setting up a new one
+    QBENCHMARK {
+        Link discoveryLink;
+        QVERIFY(discoveryLink.connect(extraCharacteristics));
+        QVERIFY(discoveryLink.discover());
+        QCOMPARE(discoveryLink.remoteService->characteristics().size(),
+                 3 + extraCharacteristics);
+    }
+#endif
+}
+
+void tst_QLowEnergyControllerBench::notificationThroughput_data()
+{
+    QTest::addColumn<int>("valueSize");
+
+    QTest::newRow("20 bytes") << 20;
+    QTest::newRow("244 bytes") << 244;
+    QTest::newRow("509 bytes") << 509;
+}
+
+void tst_QLowEnergyControllerBench::notificationThroughput()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    QFETCH(int, valueSize);
+
+    constexpr int notificationCount = 1000;
+
+    const QLowEnergyCharacteristic remoteChar
+            = link.remoteService->characteristic(notifyCharUuid);
+    const QLowEnergyDescriptor cccd = remoteChar.clientCharacteristicConfiguration();
+    QVERIFY(cccd.isValid());
+    if (cccd.value() != QLowEnergyCharacteristic::CCCDEnableNotification) {
+        link.remoteService->writeDescriptor(cccd, QLowEnergyCharacteristic::CCCDEnableNotification);
+        QVERIFY(waitForLeSignal(link.remoteService.get(), &QLowEnergyService::descriptorWritten));
+    }
+
+    const QLowEnergyCharacteristic localChar
+            = link.localService->characteristic(notifyCharUuid);
+    const QByteArray value(valueSize, 'n');
+
+    QBENCHMARK {
+        QEventLoop loop;
+        QTimer timer;
+        timer.setSingleShot(true);
+        connect(&timer, &QTimer::timeout, &loop, [&loop]() { loop.exit(1); });
+        int received = 0;
+        connect(link.remoteService.get(), &QLowEnergyService::characteristicChanged, &loop,
+                [&](const QLowEnergyCharacteristic &, const QByteArray &newValue) {
+                    if (newValue.size() == valueSize && ++received == notificationCount)
+                        loop.quit();
+                });
+        for (int i = 0; i < notificationCount; ++i)
+            link.localService->writeCharacteristic(localChar, value);
+        timer.start(5s);
+        QVERIFY(loop.exec() == 0);
+
+        QCOMPARE(received, notificationCount);
+    }
+#endif
+}
+
+void tst_QLowEnergyControllerBench::readLatency()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    const QLowEnergyCharacteristic remoteChar
+            = link.remoteService->characteristic(shortCharUuid);
+    QVERIFY(remoteChar.isValid());
+
+    QBENCHMARK {
+        link.remoteService->readCharacteristic(remoteChar);
+        QVERIFY(waitForLeSignal(link.remoteService.get(), &QLowEnergyService::characteristicRead));
+    }
+#endif
+}
+
+void tst_QLowEnergyControllerBench::writeLatency()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    const QLowEnergyCharacteristic remoteChar
+            = link.remoteService->characteristic(shortCharUuid);
+    QVERIFY(remoteChar.isValid());
+    const QByteArray value(20, 'w');
+
+    QBENCHMARK {
+        link.remoteService->writeCharacteristic(remoteChar, value);
+        QVERIFY(waitForLeSignal(link.remoteService.get(),
+                                                              &QLowEnergyService::characteristicWritten));QLowEnergyService::characteristicWritten));
+    }
+    QCOMPARE(link.localService->characteristic(shortCharUuid).value(), value);
+#endif
+}
+
+void tst_QLowEnergyControllerBench::longWrite()
+{
+#ifdef HAS_LE_SOCKET_PAIR
+    const QLowEnergyCharacteristic remoteChar
+            = link.remoteService->characteristic(longCharUuid);
+    QVERIFY(remoteChar.isValid());
+    // Longer than fits into a write request at the maximum MTU, this uses
+    // prepared writes followed by an execute write request
+    const QByteArray value(512, 'w');
+
+    QBENCHMARK {
+        link.remoteService->writeCharacteristic(remoteChar, value);
+        QVERIFY(waitForLeSignal(link.remoteService.get(),
+                                                              &QLowEnergyService::characteristicWritten));QLowEnergyService::characteristicWritten));
+    }
+    QCOMPARE(link.localService->characteristic(longCharUuid).value(), value);
+#endif
+}
+
+QTEST_MAIN(tst_QLowEnergyControllerBench)
+
+#include "tst_bench_qlowenergycontroller.moc"
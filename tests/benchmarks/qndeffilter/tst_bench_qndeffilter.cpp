@@ -0,0 +1,90 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QNdefFilter>
+#include <QNdefMessage>
+#include <QNdefNfcTextRecord>
+#include <QNdefNfcUriRecord>
+
+QT_USE_NAMESPACE
+
+class tst_QNdefFilterBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void match_data();
+    void match();
+};
+
+// Same filters and messages as in tst_qndeffilter, each one matched with and
+// without ordering.
+void tst_QNdefFilterBench::match_data()
+{
+    QTest::addColumn<QNdefFilter>("filter");
+    QTest::addColumn<QNdefMessage>("message");
+    QTest::addColumn<bool>("result");
+
+    QNdefFilter filter;
+    filter.appendRecord<QNdefNfcTextRecord>(1, 2);
+    filter.appendRecord(QNdefRecord::Mime, "image/png", 1, 1);
+    filter.appendRecord(QNdefRecord::Empty, "", 0, 100);
+
+    QNdefFilter repeatedFilter;
+    repeatedFilter.appendRecord<QNdefNfcTextRecord>(0, 1);
+    repeatedFilter.appendRecord<QNdefNfcTextRecord>(0, 1);
+    repeatedFilter.appendRecord(QNdefRecord::Mime, "", 1, 1);
+    repeatedFilter.appendRecord<QNdefNfcTextRecord>(1, 1);
+
+    using Records = QList<QNdefRecord>;
+
+    QNdefNfcTextRecord textRec;
+    textRec.setPayload("text");
+
+    QNdefRecord mimeRec;
+    mimeRec.setTypeNameFormat(QNdefRecord::Mime);
+    mimeRec.setType("image/png");
+    mimeRec.setPayload("some image should be here");
+
+    QNdefRecord emptyRec;
+    emptyRec.setTypeNameFormat(QNdefRecord::Empty);
+
+    const auto addRows = [](const char *name, QNdefFilter filter, const QNdefMessage &message,
+                            bool unorderedResult, bool orderedResult) {
+        filter.setOrderMatch(false);
+        QTest::addRow("%s, no ordering", name) << filter << message << unorderedResult;
+        filter.setOrderMatch(true);
+        QTest::addRow("%s, with ordering", name) << filter << message << orderedResult;
+    };
+
+    addRows("no optional records", filter, QNdefMessage(Records{ textRec, mimeRec }), true, true);
+    addRows("multiple records with optional", filter,
+            QNdefMessage(Records{ textRec, mimeRec, emptyRec, emptyRec }), true, true);
+    addRows("random order", filter,
+            QNdefMessage(Records{ mimeRec, emptyRec, textRec, emptyRec, textRec }), true, false);
+    addRows("type not from filter in the end", filter,
+            QNdefMessage(Records{ textRec, textRec, mimeRec, emptyRec, emptyRec,
+                           QNdefNfcUriRecord() }),
+            false, false);
+    addRows("repeated type format", repeatedFilter,
+            QNdefMessage(Records{ textRec, mimeRec, textRec }), true, true);
+}
+
+void tst_QNdefFilterBench::match()
+{
+    QFETCH(QNdefFilter, filter);
+    QFETCH(QNdefMessage, message);
+    QFETCH(bool, result);
+
+    bool matched = false;
+    QBENCHMARK {
+        matched = filter.match(message);
+    }
+    QCOMPARE(matched, result);
+}
+
+QTEST_MAIN(tst_QNdefFilterBench)
+
+#include "tst_bench_qndeffilter.moc"
@@ -0,0 +1,147 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <qndefmessage.h>
+#include <qndefnfctextrecord.h>
+#include <qndefnfcurirecord.h>
+
+QT_USE_NAMESPACE
+
+class tst_QNdefMessageBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fromByteArray_data();
+    void fromByteArray();
+    void toByteArray_data();
+    void toByteArray();
+};
+
+// A raw message with a single record whose payload is split into chunkSize sized chunks
+static QByteArray chunkedMessage(const QByteArray &type, const QByteArray &payload,
+                                 qsizetype chunkSize)
+{
+    QByteArray data;
+    for (qsizetype offset = 0; offset < payload.size(); offset += chunkSize) {
+        const bool first = offset == 0;
+        const bool last = offset + chunkSize >= payload.size();
+        const QByteArray chunk = payload.mid(offset, chunkSize);
+
+        quint8 flags = first ? 0x82 : 0x06;     // MB, TNF=2 (MIME) / TNF=6 (Unchanged)
+        if (last)
+            flags |= 0x40;                      // ME
+        else
+            flags |= 0x20;                      // CF
+        if (chunk.size() < 256)
+            flags |= 0x10;                      // SR
+
+        data.append(char(flags));
+        data.append(char(first ? type.size() : 0));
+        if (flags & 0x10) {
+            data.append(char(chunk.size()));
+        } else {
+            const quint32 length = quint32(chunk.size());
+            data.append(char(length >> 24));
+            data.append(char(length >> 16));
+            data.append(char(length >> 8));
+            data.append(char(length));
+        }
+        if (first)
+            data.append(type);
+        data.append(chunk);
+    }
+    return data;
+}
+
+void tst_QNdefMessageBench::fromByteArray_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<int>("recordCount");
+
+    {
+        QNdefNfcUriRecord record;
+        record.setUri(QUrl(QStringLiteral("https://tickets.example.com/validate?id=0123456789")));
+        QTest::newRow("uri record") << QNdefMessage(record).toByteArray() << 1;
+    }
+    {
+        QNdefMessage message;
+        for (int i = 0; i < 8; ++i) {
+            QNdefNfcTextRecord record;
+            record.setLocale(QStringLiteral("en"));
+            record.setText(QStringLiteral("Ticket line %1, valid for one ride").arg(i));
+            message.append(record);
+        }
+        QTest::newRow("8 text records") << message.toByteArray() << 8;
+    }
+    {
+        QNdefRecord record;
+        record.setTypeNameFormat(QNdefRecord::Mime);
+        record.setType("application/octet-stream");
+        record.setPayload(QByteArray(8192, 'p'));
+        QTest::newRow("8 KiB mime record") << QNdefMessage(record).toByteArray() << 1;
+    }
+    {
+        const QByteArray data = chunkedMessage("application/octet-stream",
+                                               QByteArray(8192, 'p'), 128);
+        QTest::newRow("8 KiB mime record in 128 byte chunks") << data << 1;
+    }
+}
+
+void tst_QNdefMessageBench::fromByteArray()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(int, recordCount);
+
+    QNdefMessage message;
+    QBENCHMARK {
+        message = QNdefMessage::fromByteArray(data);
+    }
+    QCOMPARE(message.size(), recordCount);
+}
+
+void tst_QNdefMessageBench::toByteArray_data()
+{
+    QTest::addColumn<QNdefMessage>("message");
+
+    {
+        QNdefNfcUriRecord record;
+        record.setUri(QUrl(QStringLiteral("https://tickets.example.com/validate?id=0123456789")));
+        QTest::newRow("uri record") << QNdefMessage(record);
+    }
+    {
+        QNdefMessage message;
+        for (int i = 0; i < 8; ++i) {
+            QNdefNfcTextRecord record;
+            record.setLocale(QStringLiteral("en"));
+            record.setText(QStringLiteral("Ticket line %1, valid for one ride").arg(i));
+            record.setId(QByteArray::number(i));
+            message.append(record);
+        }
+        QTest::newRow("8 text records") << message;
+    }
+    {
+        QNdefRecord record;
+        record.setTypeNameFormat(QNdefRecord::Mime);
+        record.setType("application/octet-stream");
+        record.setPayload(QByteArray(8192, 'p'));
+        QTest::newRow("8 KiB mime record") << QNdefMessage(record);
+    }
+}
+
+void tst_QNdefMessageBench::toByteArray()
+{
+    QFETCH(QNdefMessage, message);
+
+    QByteArray data;
+    QBENCHMARK {
+        data = message.toByteArray();
+    }
+    QCOMPARE(QNdefMessage::fromByteArray(data), message);
+}
+
+QTEST_MAIN(tst_QNdefMessageBench)
+
+#include "tst_bench_qndefmessage.moc"
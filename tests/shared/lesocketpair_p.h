@@ -0,0 +1,110 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef LESOCKETPAIR_P_H
+#define LESOCKETPAIR_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qeventloop.h>
+#include <QtCore/qtimer.h>
+
+#include <QtBluetooth/qbluetoothaddress.h>
+#include <QtBluetooth/qbluetoothdeviceinfo.h>
+#include <QtBluetooth/qlowenergycontroller.h>
+#include <QtBluetooth/qlowenergyservice.h>
+
+// The socket pair transport of the kernel ATT backend connects a central and
+// a peripheral controller without Bluetooth hardware. It is only exported by
+// developer builds.
+#if defined(QT_BUILD_INTERNAL) && defined(CONFIG_BLUEZ_LE)
+#include <QtBluetooth/private/qlowenergycontroller_bluez_p.h>
+#define HAS_LE_SOCKET_PAIR
+#endif
+
+#include <chrono>
+
+QT_BEGIN_NAMESPACE
+
+#ifdef HAS_LE_SOCKET_PAIR
+
+// Selects the kernel ATT backend in both roles, the D-Bus backend would
+// otherwise be used. Must be called before the controllers are created.
+inline void useLeSocketPairBackend()
+{
+    qputenv("BLUETOOTH_FORCE_DBUS_LE_VERSION", "5.0");
+    qputenv("QT_BLUETOOTH_USE_KERNEL_PERIPHERAL", "1");
+    qputenv("QT_DEFAULT_CENTRAL_SERVICES", "0");
+}
+
+// Spins the event loop until sender emits signal, returns false on timeout
+template <typename Func>
+bool waitForLeSignal(const typename QtPrivate::FunctionPointer<Func>::Object *sender,
+                     Func signal)
+{
+    using namespace std::chrono_literals;
+
+    QEventLoop loop;
+    QTimer timer;
+    timer.setSingleShot(true);
+    QObject::connect(&timer, &QTimer::timeout, &loop, [&loop]() { loop.exit(1); });
+    QObject::connect(sender, signal, &loop, &QEventLoop::quit);
+    timer.start(5s);
+    return loop.exec() == 0;
+}
+
+// Creates a central for a made-up device with the address 00:00:00:00:00:nn
+// and connects it to peripheral, returns nullptr on failure
+inline QLowEnergyController *connectLeSocketPairCentral(QLowEnergyController *peripheral,
+                                                        quint8 nn = 1)
+{
+    const QBluetoothDeviceInfo remoteDevice(QBluetoothAddress(quint64(nn)),
+                                            QStringLiteral("loopback"), 0);
+    QLowEnergyController *central = QLowEnergyController::createCentral(remoteDevice);
+    if (!QLowEnergyControllerPrivateBluez::connectOverSocketPair(central, peripheral)) {
+        delete central;
+        return nullptr;
+    }
+    return central;
+}
+
+// Discovers the service uuid of central including its details, returns
+// nullptr on failure. The service is owned by the caller.
+inline QLowEnergyService *discoverLeService(QLowEnergyController *central,
+                                            const QBluetoothUuid &uuid)
+{
+    if (central->state() != QLowEnergyController::DiscoveredState) {
+        central->discoverServices();
+        if (central->state() != QLowEnergyController::DiscoveredState
+                && !waitForLeSignal(central, &QLowEnergyController::discoveryFinished)) {
+            return nullptr;
+        }
+    }
+
+    QLowEnergyService *service = central->createServiceObject(uuid);
+    if (!service)
+        return nullptr;
+    service->discoverDetails();
+    while (service->state() != QLowEnergyService::RemoteServiceDiscovered) {
+        if (!waitForLeSignal(service, &QLowEnergyService::stateChanged)) {
+            delete service;
+            return nullptr;
+        }
+    }
+    return service;
+}
+
+#endif // HAS_LE_SOCKET_PAIR
+
+QT_END_NAMESPACE
+
+#endif // LESOCKETPAIR_P_H